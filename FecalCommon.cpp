@@ -31,6 +31,49 @@
 namespace fecal {
 
 
+//------------------------------------------------------------------------------
+// RowScheduleCache
+
+FecalResult RowScheduleCache::Initialize(unsigned input_count, unsigned row_count, FecalRowScheme row_scheme)
+{
+    const unsigned drawCount = 2 * ((input_count + kPairAddRate - 1) / kPairAddRate);
+
+    // Keep the table size addressable on 32-bit targets
+    if (input_count <= 0 || row_count <= 0 ||
+        static_cast<unsigned>(row_scheme) >= Fecal_RowScheme_Count ||
+        static_cast<uint64_t>(row_count) * drawCount > UINT32_MAX / sizeof(uint32_t))
+    {
+        FECAL_DEBUG_BREAK; // Invalid input
+        return Fecal_InvalidInput;
+    }
+
+    InputCount = input_count;
+    RowCount = row_count;
+    Scheme = row_scheme;
+    DrawCount = drawCount;
+
+    Columns.resize(static_cast<size_t>(row_count) * drawCount);
+    Opcodes.resize(static_cast<size_t>(row_count) * kColumnLaneCount);
+
+    uint32_t* columns = Columns.data();
+    uint8_t* opcodes = Opcodes.data();
+
+    for (unsigned row = 0; row < row_count; ++row)
+    {
+        RowSchedule schedule;
+        schedule.Initialize(nullptr, row, input_count, row_scheme);
+
+        for (unsigned i = 0; i < drawCount; ++i)
+            *columns++ = schedule.NextColumn();
+
+        for (unsigned laneIndex = 0; laneIndex < kColumnLaneCount; ++laneIndex)
+            *opcodes++ = static_cast<uint8_t>(GetRowOpcode(laneIndex, row));
+    }
+
+    return Fecal_Success;
+}
+
+
 //------------------------------------------------------------------------------
 // AppDataWindow
 
@@ -45,16 +88,366 @@ bool AppDataWindow::SetParameters(unsigned input_count, uint64_t total_bytes)
     InputCount = input_count;
     TotalBytes = total_bytes;
 
-    SymbolBytes = static_cast<unsigned>((total_bytes + input_count - 1) / input_count);
+    const uint64_t symbolBytes = (total_bytes + input_count - 1) / input_count;
+    if (symbolBytes > kMaxSymbolBytes)
+    {
+        FECAL_DEBUG_BREAK; // Symbols too large
+        return false;
+    }
+
+    SymbolBytes = static_cast<unsigned>(symbolBytes);
     FinalBytes = static_cast<unsigned>(total_bytes % SymbolBytes);
     if (FinalBytes <= 0)
         FinalBytes = SymbolBytes;
+    RecoveryBytes = SymbolBytes;
+    ColumnBytes.clear();
 
     FECAL_DEBUG_ASSERT(SymbolBytes >= FinalBytes && FinalBytes != 0);
 
     return true;
 }
 
+bool AppDataWindow::SetVariableParameters(unsigned input_count, unsigned symbol_bytes, const unsigned* input_bytes)
+{
+    if (input_count <= 0 || symbol_bytes <= 0 || symbol_bytes > kMaxSymbolBytes - kLengthBytes)
+    {
+        FECAL_DEBUG_BREAK; // Invalid input
+        return false;
+    }
+
+    InputCount = input_count;
+    SymbolBytes = symbol_bytes;
+    FinalBytes = symbol_bytes;
+    RecoveryBytes = symbol_bytes + kLengthBytes;
+    TotalBytes = 0;
+
+    if (!input_bytes)
+    {
+        ColumnBytes.assign(input_count, RecoveryBytes);
+        return true;
+    }
+
+    ColumnBytes.assign(input_bytes, input_bytes + input_count);
+    for (unsigned column = 0; column < input_count; ++column)
+    {
+        if (ColumnBytes[column] <= 0 || ColumnBytes[column] > symbol_bytes)
+        {
+            FECAL_DEBUG_BREAK; // Invalid input
+            ColumnBytes.clear();
+            return false;
+        }
+        TotalBytes += ColumnBytes[column];
+    }
+
+    return true;
+}
+
+
+//------------------------------------------------------------------------------
+// ColumnLengths
+
+// Multiply each byte of a packed length by y
+static uint32_t MulLength(uint8_t y, uint32_t length)
+{
+    uint32_t product = 0;
+    for (unsigned shift = 0; shift < 32; shift += 8)
+        product |= (uint32_t)gf256_mul(y, (uint8_t)(length >> shift)) << shift;
+    return product;
+}
+
+void ColumnLengths::Reset(unsigned inputCount)
+{
+    Lengths.assign(inputCount, 0);
+    memset(LaneSums, 0, sizeof(LaneSums));
+}
+
+void ColumnLengths::Add(unsigned column, uint32_t length)
+{
+    FECAL_DEBUG_ASSERT(Lengths[column] == 0 && length != 0);
+    Lengths[column] = length;
+
+    const unsigned laneIndex = column % kColumnLaneCount;
+    const uint8_t CX = GetColumnValue(column);
+
+    // Sum[0] += Length, Sum[1] += CX * Length, Sum[2] += CX^2 * Length
+    LaneSums[laneIndex][0] ^= length;
+    LaneSums[laneIndex][1] ^= MulLength(CX, length);
+    LaneSums[laneIndex][2] ^= MulLength(gf256_sqr(CX), length);
+
+    static_assert(kColumnSumCount == 3, "Update this");
+}
+
+uint32_t ColumnLengths::EncodeRow(const AppDataWindow& window, unsigned row) const
+{
+    const unsigned inputCount = window.InputCount;
+
+    RowSchedule schedule;
+    schedule.Initialize(window.RowCache, row, inputCount, window.RowScheme);
+
+    // Unknown lengths are zero, so they drop out of the sums
+    uint32_t sum = 0, product = 0;
+    const unsigned pairCount = (inputCount + kPairAddRate - 1) / kPairAddRate;
+    for (unsigned i = 0; i < pairCount; ++i)
+    {
+        sum ^= Lengths[schedule.NextColumn()];
+        product ^= Lengths[schedule.NextColumn()];
+    }
+
+    for (unsigned laneIndex = 0; laneIndex < kColumnLaneCount; ++laneIndex)
+    {
+        const unsigned opcode = schedule.GetOpcode(laneIndex);
+
+        unsigned mask = 1;
+        for (unsigned sumIndex = 0; sumIndex < kColumnSumCount; ++sumIndex, mask <<= 1)
+            if (opcode & mask)
+                sum ^= LaneSums[laneIndex][sumIndex];
+        for (unsigned sumIndex = 0; sumIndex < kColumnSumCount; ++sumIndex, mask <<= 1)
+            if (opcode & mask)
+                product ^= LaneSums[laneIndex][sumIndex];
+    }
+
+    return sum ^ MulLength(GetRowValue(row), product);
+}
+
+
+//------------------------------------------------------------------------------
+// SumSchedule
+
+#ifdef FECAL_PREFETCH
+
+// Prefetch the heads of sources [first, end) of a stripe
+static GF256_FORCE_INLINE void PrefetchSources(
+    const std::vector<const uint8_t*>& sources, unsigned first, unsigned end, unsigned offset)
+{
+    const unsigned count = static_cast<unsigned>(sources.size());
+    if (end > count)
+        end = count;
+    for (unsigned i = first; i < end; ++i)
+        for (unsigned line = 0; line < kPrefetchLines; ++line)
+            FECAL_PREFETCH_LINE(sources[i] + offset + line * kPrefetchLineBytes);
+}
+
+#endif // FECAL_PREFETCH
+
+void SumSchedule::Store(uint8_t* dest, unsigned offset, unsigned bytes) const
+{
+    Replay(true, dest, offset, bytes);
+}
+
+void SumSchedule::Accumulate(uint8_t* dest, unsigned offset, unsigned bytes) const
+{
+    Replay(false, dest, offset, bytes);
+}
+
+void SumSchedule::StoreWithProduct(uint8_t* dest, uint8_t y, const SumSchedule& product,
+    unsigned offset, unsigned bytes) const
+{
+    ReplayWithProduct(true, dest, y, product, offset, bytes);
+}
+
+void SumSchedule::AccumulateWithProduct(uint8_t* dest, uint8_t y, const SumSchedule& product,
+    unsigned offset, unsigned bytes) const
+{
+    ReplayWithProduct(false, dest, y, product, offset, bytes);
+}
+
+size_t SumSchedule::GetLaneOffset(unsigned offset) const
+{
+    return Slab ? Slab->GetLaneOffset(offset) : 0;
+}
+
+void SumSchedule::AddPartials(XORSummer& summer, uint8_t* dest, unsigned offset, unsigned bytes) const
+{
+    const unsigned count = static_cast<unsigned>(Partials.size());
+    for (unsigned i = 0; i < count; ++i)
+    {
+        const PartialSource& partial = Partials[i];
+        if (partial.Bytes >= offset + bytes)
+            summer.Add(partial.Data + offset);
+        else if (partial.Bytes > offset)
+            gf256_add_mem(dest, partial.Data + offset, partial.Bytes - offset);
+    }
+}
+
+void SumSchedule::Replay(bool store, uint8_t* dest, unsigned offset, unsigned bytes) const
+{
+    const unsigned count = GetSourceCount();
+
+    // Stripes end on stripe boundaries so each lane sum is contiguous within them
+    for (unsigned done = 0; done < bytes;)
+    {
+        const unsigned stripeOffset = offset + done;
+        const unsigned stripeBytes = GetStripeBytes(stripeOffset, bytes - done);
+        const size_t laneOffset = GetLaneOffset(stripeOffset);
+        uint8_t* stripeDest = dest + done;
+
+#ifdef FECAL_PREFETCH
+        PrefetchSources(Sources, 0, kPrefetchDistance, stripeOffset);
+#endif
+
+        // Copy the first source rather than clearing the destination
+        unsigned first = 0;
+        if (store)
+        {
+            if (count == 0)
+                memset(stripeDest, 0, stripeBytes);
+            else
+                memcpy(stripeDest, GetSource(first++, stripeOffset, laneOffset), stripeBytes);
+        }
+
+        XORSummer summer;
+        summer.Initialize(stripeDest, stripeBytes);
+        for (unsigned i = first; i < count; ++i)
+        {
+#ifdef FECAL_PREFETCH
+            PrefetchSources(Sources, i + kPrefetchDistance, i + kPrefetchDistance + 1, stripeOffset);
+#endif
+            summer.Add(GetSource(i, stripeOffset, laneOffset));
+        }
+        AddPartials(summer, stripeDest, stripeOffset, stripeBytes);
+        summer.Finalize();
+
+        done += stripeBytes;
+    }
+}
+
+void SumSchedule::ReplayWithProduct(bool store, uint8_t* dest, uint8_t y, const SumSchedule& product,
+    unsigned offset, unsigned bytes) const
+{
+    /*
+        Reading too many sources at once defeats the hardware prefetcher, so
+        only the last kXORSummerSources sources of each sum are passed to the
+        fused kernel.  The other sum sources are added to the destination, and
+        the other product sources are folded into a workspace that stays in L1
+        cache for the stripe.  The last sources are the lane sums, which are
+        next to each other in the slab.  Partial product sources are folded
+        into the workspace, which then takes one of the fused kernel slots.
+    */
+    GF256_ALIGNED uint8_t workspace[kStripeBytes];
+
+    // The first source is copied rather than clearing the destination
+    const unsigned first = (store && GetSourceCount() > 0) ? 1 : 0;
+    const unsigned sumEnd = GetSourceCount();
+    const unsigned productEnd = product.GetSourceCount();
+    const unsigned sumFused = sumEnd - first < kXORSummerSources ? first : sumEnd - kXORSummerSources;
+    const bool productPartials = !product.Partials.empty();
+    const unsigned productSlots = productPartials ? kXORSummerSources - 1 : kXORSummerSources;
+    const unsigned productFused = productEnd <= productSlots ? 0 : productEnd - (kXORSummerSources - 1);
+
+    for (unsigned done = 0; done < bytes;)
+    {
+        const unsigned stripeOffset = offset + done;
+        const unsigned stripeBytes = GetStripeBytes(stripeOffset, bytes - done);
+        const size_t laneOffset = GetLaneOffset(stripeOffset);
+        const size_t productLaneOffset = product.GetLaneOffset(stripeOffset);
+        uint8_t* stripeDest = dest + done;
+
+#ifdef FECAL_PREFETCH
+        PrefetchSources(Sources, 0, first + kPrefetchDistance, stripeOffset);
+        PrefetchSources(product.Sources, 0, kPrefetchDistance, stripeOffset);
+#endif
+
+        if (first > 0)
+            memcpy(stripeDest, GetSource(0, stripeOffset, laneOffset), stripeBytes);
+        else if (store)
+            memset(stripeDest, 0, stripeBytes);
+
+        XORSummer summer;
+        summer.Initialize(stripeDest, stripeBytes);
+        for (unsigned i = first; i < sumFused; ++i)
+        {
+#ifdef FECAL_PREFETCH
+            PrefetchSources(Sources, i + kPrefetchDistance, i + kPrefetchDistance + 1, stripeOffset);
+#endif
+            summer.Add(GetSource(i, stripeOffset, laneOffset));
+        }
+        AddPartials(summer, stripeDest, stripeOffset, stripeBytes);
+        summer.Finalize();
+
+        const void* sumSources[kXORSummerSources];
+        unsigned sumCount = 0;
+        for (unsigned i = sumFused; i < sumEnd; ++i)
+            sumSources[sumCount++] = GetSource(i, stripeOffset, laneOffset);
+
+        const void* productSources[kXORSummerSources];
+        unsigned productCount = 0;
+        if (productFused > 0 || productPartials)
+        {
+            if (productFused > 0)
+                memcpy(workspace, product.GetSource(0, stripeOffset, productLaneOffset), stripeBytes);
+            else
+                memset(workspace, 0, stripeBytes);
+            summer.Initialize(workspace, stripeBytes);
+            for (unsigned i = 1; i < productFused; ++i)
+            {
+#ifdef FECAL_PREFETCH
+                PrefetchSources(product.Sources, i + kPrefetchDistance, i + kPrefetchDistance + 1, stripeOffset);
+#endif
+                summer.Add(product.GetSource(i, stripeOffset, productLaneOffset));
+            }
+            product.AddPartials(summer, workspace, stripeOffset, stripeBytes);
+            summer.Finalize();
+
+            productSources[productCount++] = workspace;
+        }
+        for (unsigned i = productFused; i < productEnd; ++i)
+            productSources[productCount++] = product.GetSource(i, stripeOffset, productLaneOffset);
+
+        gf256_addn_muladdn_mem(stripeDest, sumSources, sumCount, y, productSources, productCount, stripeBytes);
+
+        done += stripeBytes;
+    }
+}
+
+
+//------------------------------------------------------------------------------
+// LaneSumSlab
+
+bool LaneSumSlab::Allocate(unsigned symbolBytes)
+{
+    SymbolBytes = symbolBytes;
+    ChunkBytes = symbolBytes <= kStripeBytes ? NextAlignedOffset(symbolBytes) : kStripeBytes;
+
+    const unsigned chunkCount = (symbolBytes + ChunkBytes - 1) / ChunkBytes;
+    return Buffer.Allocate(static_cast<uint64_t>(chunkCount) * kLaneSumCount * ChunkBytes);
+}
+
+void LaneSumSlab::Clear()
+{
+    const unsigned chunkCount = (SymbolBytes + ChunkBytes - 1) / ChunkBytes;
+    memset(Buffer.Data, 0, static_cast<size_t>(chunkCount) * kLaneSumCount * ChunkBytes);
+}
+
+void LaneSumSlab::MulAdd(unsigned laneIndex, unsigned sumIndex, uint8_t y, const uint8_t* data, unsigned bytes)
+{
+    for (unsigned offset = 0; offset < bytes;)
+    {
+        const unsigned chunkBytes = GetStripeBytes(offset, bytes - offset);
+        gf256_muladd_mem(Get(laneIndex, sumIndex, offset), y, data + offset, chunkBytes);
+        offset += chunkBytes;
+    }
+}
+
+void LaneSumSlab::Load(unsigned laneIndex, unsigned sumIndex, const uint8_t* src)
+{
+    for (unsigned offset = 0; offset < SymbolBytes;)
+    {
+        const unsigned chunkBytes = GetStripeBytes(offset, SymbolBytes - offset);
+        memcpy(Get(laneIndex, sumIndex, offset), src + offset, chunkBytes);
+        offset += chunkBytes;
+    }
+}
+
+void LaneSumSlab::Store(unsigned laneIndex, unsigned sumIndex, uint8_t* dest) const
+{
+    for (unsigned offset = 0; offset < SymbolBytes;)
+    {
+        const unsigned chunkBytes = GetStripeBytes(offset, SymbolBytes - offset);
+        memcpy(dest + offset, Get(laneIndex, sumIndex, offset), chunkBytes);
+        offset += chunkBytes;
+    }
+}
+
 
 //------------------------------------------------------------------------------
 // AlignedDataBuffer
@@ -64,11 +457,20 @@ AlignedDataBuffer::~AlignedDataBuffer()
     SIMDSafeFree(Data);
 }
 
-bool AlignedDataBuffer::Allocate(unsigned bytes)
+bool AlignedDataBuffer::Allocate(uint64_t bytes)
 {
     FECAL_DEBUG_ASSERT(bytes > 0);
+    if (bytes <= Capacity)
+        return true;
+
+    // If the size does not fit in the address space:
+    const size_t size = static_cast<size_t>(bytes);
+    if (size != bytes || size > static_cast<size_t>(-1) - kAlignmentBytes)
+        return false;
+
     SIMDSafeFree(Data);
-    Data = SIMDSafeAllocate(bytes);
+    Data = SIMDSafeAllocate(size);
+    Capacity = Data ? size : 0;
     return Data != nullptr;
 }
 
@@ -89,20 +491,36 @@ void GrowingAlignedByteMatrix::Free()
         Data             = nullptr;
         AllocatedRows    = 0;
         AllocatedColumns = 0;
+        AllocatedBytes   = 0;
     }
 }
 
-bool GrowingAlignedByteMatrix::Initialize(unsigned rows, unsigned columns)
+bool GrowingAlignedByteMatrix::Initialize(unsigned rows, unsigned columns, unsigned minRows)
 {
     Rows    = rows;
     Columns = columns;
-    AllocatedRows    = rows + kExtraRows;
+    AllocatedRows    = (rows > minRows ? rows : minRows) + kExtraRows;
     AllocatedColumns = NextAlignedOffset(columns + kMinExtraColumns);
 
-    SIMDSafeFree(Data);
-    Data = SIMDSafeAllocate(AllocatedRows * AllocatedColumns);
+    const size_t bytes = static_cast<size_t>(AllocatedRows) * AllocatedColumns;
+    if (!Data || bytes > AllocatedBytes)
+    {
+        SIMDSafeFree(Data);
+        Data = SIMDSafeAllocate(bytes);
+        if (!Data)
+        {
+            AllocatedRows    = 0;
+            AllocatedColumns = 0;
+            AllocatedBytes   = 0;
+            return false;
+        }
+        AllocatedBytes = bytes;
+    }
 
-    return Data != nullptr;
+    // Use all of the rows that fit in the buffer
+    AllocatedRows = AllocatedBytes / AllocatedColumns;
+
+    return true;
 }
 
 bool GrowingAlignedByteMatrix::Resize(unsigned rows, unsigned columns)
@@ -117,8 +535,9 @@ bool GrowingAlignedByteMatrix::Resize(unsigned rows, unsigned columns)
 
     const unsigned allocatedRows    = rows + kExtraRows;
     const unsigned allocatedColumns = NextAlignedOffset(columns + kMinExtraColumns);
+    const size_t allocatedBytes     = static_cast<size_t>(allocatedRows) * allocatedColumns;
 
-    uint8_t* buffer = SIMDSafeAllocate(allocatedRows * allocatedColumns);
+    uint8_t* buffer = SIMDSafeAllocate(allocatedBytes);
     if (!buffer)
     {
         Free();
@@ -155,6 +574,7 @@ bool GrowingAlignedByteMatrix::Resize(unsigned rows, unsigned columns)
 
     AllocatedRows    = allocatedRows;
     AllocatedColumns = allocatedColumns;
+    AllocatedBytes   = allocatedBytes;
     Rows    = rows;
     Columns = columns;
     Data    = buffer;
@@ -32,10 +32,15 @@
     This module provides core tools and constants used by the codec:
 
     + Debugging macros
+    + Statistics macros
     + Alignment
     + PCGRandom, Int32Hash
     + Parameters of the Siamese and Cauchy matrix structures
     + ICodec base class for Encoder and Decoder
+    + Row schedule cache
+    + Parallel task helpers
+    + Striped sum schedules
+    + Lane sum slab
     + EncoderAppDataWindow and DecoderAppDataWindow structures
     + Growing matrix structure
     + CustomBitSet
@@ -52,6 +57,7 @@
 #include <vector>
 #include <array>
 #include <algorithm>
+#include <chrono>
 
 namespace fecal {
 
@@ -76,6 +82,82 @@ namespace fecal {
 #endif
 
 
+//------------------------------------------------------------------------------
+// Statistics
+
+// Count the decoder work and time its stages for fecal_decoder_get_stats().
+// This adds a few clock reads to each decode, so it is off by default
+//#define FECAL_ENABLE_STATS
+
+#ifdef FECAL_ENABLE_STATS
+    #define FECAL_STATS(code) { code; }
+    #define FECAL_STATS_TIMER(name, total) StatsTimer name(total)
+#else
+    #define FECAL_STATS(code) ;
+    #define FECAL_STATS_TIMER(name, total) ;
+#endif
+
+#ifdef FECAL_ENABLE_STATS
+
+// Adds the nanoseconds from construction to destruction to a stats timer
+class StatsTimer
+{
+public:
+    explicit StatsTimer(uint64_t& total)
+        : Total(total)
+        , Start(GetNsec())
+    {
+    }
+    ~StatsTimer()
+    {
+        Total += GetNsec() - Start;
+    }
+
+    static uint64_t GetNsec()
+    {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count());
+    }
+
+protected:
+    uint64_t& Total;
+    const uint64_t Start;
+};
+
+#endif // FECAL_ENABLE_STATS
+
+
+//------------------------------------------------------------------------------
+// Prefetch
+
+// Prefetch the sources of a sum schedule a few sources before they are added,
+// since the random columns of a recovery row are usually not in cache
+#define FECAL_PREFETCH
+
+#if defined(_MSC_VER) && (defined(_M_ARM) || defined(_M_ARM64))
+    #define FECAL_PREFETCH_LINE(ptr) __prefetch(ptr)
+#elif defined(_MSC_VER)
+    #define FECAL_PREFETCH_LINE(ptr) _mm_prefetch(reinterpret_cast<const char*>(ptr), _MM_HINT_T0)
+#else
+    #define FECAL_PREFETCH_LINE(ptr) __builtin_prefetch(ptr)
+#endif
+
+// Bytes in each prefetched cache line
+static const unsigned kPrefetchLineBytes = 64;
+
+#if defined(GF256_TARGET_MOBILE)
+    // Number of sources to prefetch ahead of the one being added
+    static const unsigned kPrefetchDistance = 8;
+
+    // Number of cache lines prefetched from the head of each source,
+    // after which the hardware prefetcher follows the stream
+    static const unsigned kPrefetchLines = 2;
+#else
+    static const unsigned kPrefetchDistance = 16;
+    static const unsigned kPrefetchLines = 4;
+#endif
+
+
 //------------------------------------------------------------------------------
 // PCG PRNG
 // From http://www.pcg-random.org/
@@ -104,6 +186,49 @@ public:
     uint64_t State = 0, Inc = 0;
 };
 
+// Several PCG streams advanced in lock step.  Each step of a stream waits on
+// the multiply of the previous step, so interleaving independent streams
+// keeps several multiplies in flight, and the fixed-size loops can be
+// vectorized on targets with 64-bit vector multiplies
+class PCGRandomStreams
+{
+public:
+    static const unsigned kStreams = 4;
+
+    inline void Seed(uint64_t y, uint64_t x = 0)
+    {
+        for (unsigned k = 0; k < kStreams; ++k)
+        {
+            PCGRandom prng;
+            prng.Seed(y * kStreams + k, x);
+            State[k] = prng.State;
+            Inc[k] = prng.Inc;
+        }
+    }
+
+    // Generate the next value of each stream
+    GF256_FORCE_INLINE void Next(uint32_t* values)
+    {
+        for (unsigned k = 0; k < kStreams; ++k)
+        {
+            const uint64_t oldstate = State[k];
+            State[k] = oldstate * UINT64_C(6364136223846793005) + Inc[k];
+            const uint32_t xorshifted = (uint32_t)(((oldstate >> 18) ^ oldstate) >> 27);
+            const uint32_t rot = (uint32_t)(oldstate >> 59);
+            values[k] = (xorshifted >> rot) | (xorshifted << ((uint32_t)(-(int32_t)rot) & 31));
+        }
+    }
+
+    uint64_t State[kStreams] = {}, Inc[kStreams] = {};
+};
+
+// Map a 32-bit random value to 0..count-1 with a multiply and shift
+// From Lemire, "Fast Random Integer Generation in an Interval" (2019)
+GF256_FORCE_INLINE uint32_t ReduceRange(uint32_t value, uint32_t count)
+{
+    return (uint32_t)(((uint64_t)value * count) >> 32);
+}
+
 
 //------------------------------------------------------------------------------
 // Int32Hash
@@ -185,6 +310,145 @@ public:
 };
 
 
+//------------------------------------------------------------------------------
+// RowScheduleCache
+
+/*
+    Each recovery row draws pairCount pairs of random columns from a PRNG
+    seeded with (row, InputCount), and an opcode for each lane from a hash of
+    the row.  The encoder and decoder generate these for every row they touch,
+    and the decoder generates them more than once per row.
+
+    The cache stores the draws and opcodes for rows 0..RowCount-1 of one
+    InputCount.  It is immutable once initialized, so one cache can be shared
+    between any number of codecs on any threads.  Codecs fall back to the
+    generators for rows that are not in the cache.
+*/
+
+class RowScheduleCache : public ICodec
+{
+public:
+    // Generate the schedules for rows 0..row_count-1
+    FecalResult Initialize(unsigned input_count, unsigned row_count, FecalRowScheme row_scheme);
+
+    // Does the cache contain this row for the given input count and scheme?
+    GF256_FORCE_INLINE bool Contains(unsigned row, unsigned inputCount, FecalRowScheme scheme) const
+    {
+        return row < RowCount && inputCount == InputCount && scheme == Scheme;
+    }
+
+    // Returns the drawn columns of the row: element1, elementRX for each pair
+    GF256_FORCE_INLINE const uint32_t* GetColumns(unsigned row) const
+    {
+        return &Columns[static_cast<size_t>(row) * DrawCount];
+    }
+
+    // Returns the opcodes of the row for each lane
+    GF256_FORCE_INLINE const uint8_t* GetOpcodes(unsigned row) const
+    {
+        return &Opcodes[static_cast<size_t>(row) * kColumnLaneCount];
+    }
+
+    GF256_FORCE_INLINE unsigned GetInputCount() const
+    {
+        return InputCount;
+    }
+    GF256_FORCE_INLINE unsigned GetRowCount() const
+    {
+        return RowCount;
+    }
+
+protected:
+    unsigned InputCount = 0;
+    unsigned RowCount = 0;
+    FecalRowScheme Scheme = Fecal_RowScheme_Modulo;
+
+    // Number of columns drawn by each row
+    unsigned DrawCount = 0;
+
+    std::vector<uint32_t> Columns;
+    std::vector<uint8_t> Opcodes;
+};
+
+// Generator for the columns and opcodes of one row, reading from the cache
+// when it contains the row
+class RowSchedule
+{
+public:
+    // Start generating the given row
+    GF256_FORCE_INLINE void Initialize(const RowScheduleCache* cache, unsigned row, unsigned inputCount,
+        FecalRowScheme scheme)
+    {
+        Row = row;
+        InputCount = inputCount;
+        Scheme = scheme;
+
+        if (cache && cache->Contains(row, inputCount, scheme))
+        {
+            Columns = cache->GetColumns(row);
+            Opcodes = cache->GetOpcodes(row);
+        }
+        else
+        {
+            Columns = nullptr;
+            Opcodes = nullptr;
+            if (scheme == Fecal_RowScheme_MultiStream)
+            {
+                Streams.Seed(row, inputCount);
+                StreamIndex = PCGRandomStreams::kStreams;
+            }
+            else
+                Prng.Seed(row, inputCount);
+        }
+    }
+
+    // Returns the next drawn column
+    GF256_FORCE_INLINE unsigned NextColumn()
+    {
+        if (Columns)
+            return *Columns++;
+        if (Scheme != Fecal_RowScheme_MultiStream)
+            return Prng.Next() % InputCount;
+
+        // Draw j is taken from stream (j % kStreams)
+        if (StreamIndex >= PCGRandomStreams::kStreams)
+        {
+            Streams.Next(StreamValues);
+            StreamIndex = 0;
+        }
+        return ReduceRange(StreamValues[StreamIndex++], InputCount);
+    }
+
+    // Returns the opcode for the given lane
+    GF256_FORCE_INLINE unsigned GetOpcode(unsigned lane) const
+    {
+        if (Opcodes)
+            return Opcodes[lane];
+        return GetRowOpcode(lane, Row);
+    }
+
+protected:
+    const uint32_t* Columns = nullptr;
+    const uint8_t* Opcodes = nullptr;
+    FecalRowScheme Scheme = Fecal_RowScheme_Modulo;
+    PCGRandom Prng;
+    PCGRandomStreams Streams;
+    uint32_t StreamValues[PCGRandomStreams::kStreams];
+    unsigned StreamIndex = 0;
+    unsigned Row = 0;
+    unsigned InputCount = 0;
+};
+
+// Returns the opcode for the given lane and row, from the cache if it has the row.
+// The opcodes do not depend on the row scheme
+GF256_FORCE_INLINE unsigned GetRowOpcode(const RowScheduleCache* cache, unsigned lane, unsigned row, unsigned inputCount)
+{
+    if (cache && row < cache->GetRowCount() && inputCount == cache->GetInputCount())
+        return cache->GetOpcodes(row)[lane];
+    return GetRowOpcode(lane, row);
+}
+
+
 //------------------------------------------------------------------------------
 // AlignedDataBuffer
 //
@@ -194,12 +458,17 @@ struct AlignedDataBuffer
 {
     uint8_t* Data = nullptr;
 
+    // Number of bytes allocated
+    size_t Capacity = 0;
+
 
     // Free memory
     ~AlignedDataBuffer();
 
-    // Allocate memory
-    bool Allocate(unsigned bytes);
+    // Allocate memory, reusing the existing buffer if it is large enough
+    // New buffer contents have undefined initial state
+    // Returns false if the size does not fit in memory
+    bool Allocate(uint64_t bytes);
 };
 
 
@@ -228,12 +497,17 @@ struct GrowingAlignedByteMatrix
     unsigned AllocatedRows    = 0;
     unsigned AllocatedColumns = 0;
 
+    // Number of bytes allocated, which may be more than the allocated rows
+    // and columns if the matrix was initialized again with a smaller size
+    size_t AllocatedBytes = 0;
+
 
     ~GrowingAlignedByteMatrix();
 
-    // Initialize matrix to the given size
+    // Initialize matrix to the given size, reusing the buffer if it fits
+    // minRows: Allocate room for at least this many rows before growing
     // New elements have undefined initial state
-    bool Initialize(unsigned rows, unsigned columns);
+    bool Initialize(unsigned rows, unsigned columns, unsigned minRows = 0);
 
     // Growing mantaining existing data in the buffer
     // New elements have undefined initial state
@@ -242,7 +516,13 @@ struct GrowingAlignedByteMatrix
     uint8_t Get(unsigned row, unsigned column)
     {
         FECAL_DEBUG_ASSERT(Data && row < Rows && column < Columns);
-        return Data[row * AllocatedColumns + column];
+        return Data[static_cast<size_t>(row) * AllocatedColumns + column];
+    }
+
+    // Returns the start of the given row
+    GF256_FORCE_INLINE uint8_t* GetRow(unsigned row) const
+    {
+        return Data + static_cast<size_t>(row) * AllocatedColumns;
     }
 
     // Free allocated memory
@@ -386,7 +666,7 @@ struct CustomBitSet
 
         bitStart < kValidBits: Index to start looking
     */
-    unsigned FindFirstClear(unsigned bitStart)
+    unsigned FindFirstClear(unsigned bitStart) const
     {
         static_assert(kWordBits == 64, "Update this");
 
@@ -570,9 +850,80 @@ static GF256_FORCE_INLINE void SIMDSafeFree(void* ptr)
 }
 
 
+//------------------------------------------------------------------------------
+// Parallel Tasks
+
+// Minimum number of bytes in a byte range handed to a parallel task,
+// so that the task overhead is small compared to the work
+static const unsigned kMinTaskBytes = 16 * 1024;
+
+// Run task(context, i) for i in 0..taskCount-1 using the application executor
+// if one was provided, or on the calling thread otherwise
+inline void RunParallelTasks(
+    const FecalExecutor& executor,
+    unsigned taskCount,
+    FecalTaskFunction task,
+    void* context)
+{
+    if (executor.ParallelFor && executor.WorkerCount > 1 && taskCount > 1)
+    {
+        executor.ParallelFor(executor.Context, taskCount, task, context);
+        return;
+    }
+
+    for (unsigned i = 0; i < taskCount; ++i)
+        task(context, i);
+}
+
+// Returns the number of bytes in each range when splitting a buffer of the
+// given size so that there are about two tasks per executor worker, given
+// that each range will be processed by tasksPerRange tasks.
+// The result is a multiple of kAlignmentBytes and is at least kMinTaskBytes,
+// unless the whole buffer is smaller than that
+inline unsigned GetParallelRangeBytes(
+    const FecalExecutor& executor,
+    unsigned bytes,
+    unsigned tasksPerRange)
+{
+    unsigned rangeCount = 1;
+    if (executor.ParallelFor && executor.WorkerCount > 1)
+    {
+        rangeCount = (executor.WorkerCount * 2 + tasksPerRange - 1) / tasksPerRange;
+
+        const unsigned maxRangeCount = bytes / kMinTaskBytes;
+        if (rangeCount > maxRangeCount)
+            rangeCount = maxRangeCount;
+        if (rangeCount < 1)
+            rangeCount = 1;
+    }
+
+    return NextAlignedOffset((bytes + rangeCount - 1) / rangeCount);
+}
+
+
 //------------------------------------------------------------------------------
 // AppDataWindow
 
+/*
+    Largest supported symbol size.  Totals and offsets are 64-bit, but each
+    symbol is still addressed by the gf256 kernels with an int byte count.
+*/
+static const unsigned kMaxSymbolBytes = 0x7fffffff;
+
+/*
+    Variable-length symbols
+
+    In variable-length mode each original has its own length of up to
+    SymbolBytes.  The code treats each original as if it was padded with
+    zeroes to SymbolBytes, so only its real bytes are ever read.  The length
+    of each original is coded like kLengthBytes more bytes of its data, and
+    appended to each recovery symbol, so the decoder recovers the lengths of
+    the lost originals along with their data.
+*/
+
+// Number of bytes appended to each recovery symbol in variable-length mode
+static const unsigned kLengthBytes = FECAL_LENGTH_BYTES;
+
 // Base class for app data window shared between encoder and decoder
 struct AppDataWindow
 {
@@ -581,30 +932,108 @@ struct AppDataWindow
     uint64_t TotalBytes = 0;   // Total number of input bytes
     unsigned FinalBytes = 0;   // Number of bytes in the final symbol
     unsigned SymbolBytes = 0;  // Number of bytes in all other symbols
+    unsigned RecoveryBytes = 0; // Number of bytes in each recovery symbol
+
+    // Variable-length mode: Number of bytes in each column, or empty when
+    // the columns are all SymbolBytes except for the final one.  Columns
+    // the decoder has not received yet cover the whole recovery symbol
+    std::vector<unsigned> ColumnBytes;
+
+    // Optional shared row schedules
+    const RowScheduleCache* RowCache = nullptr;
+
+    // Row generation scheme shared by the encoder and decoder
+    FecalRowScheme RowScheme = Fecal_RowScheme_Modulo;
 
 
     // Set parameter for the window (should be done first)
     // Returns false if input is invalid
     bool SetParameters(unsigned input_count, uint64_t total_bytes);
 
-    GF256_FORCE_INLINE bool IsFinalColumn(unsigned column)
+    // Set parameters for variable-length mode (instead of SetParameters)
+    // input_bytes: Length of each original, or NULL if not known yet
+    // Returns false if input is invalid
+    bool SetVariableParameters(unsigned input_count, unsigned symbol_bytes, const unsigned* input_bytes);
+
+    GF256_FORCE_INLINE bool IsVariableLength() const
+    {
+        return !ColumnBytes.empty();
+    }
+
+    GF256_FORCE_INLINE bool IsFinalColumn(unsigned column) const
     {
         return (column == InputCount - 1);
     }
 
     // Helper function
-    GF256_FORCE_INLINE unsigned GetColumnBytes(unsigned column)
+    GF256_FORCE_INLINE unsigned GetColumnBytes(unsigned column) const
     {
+        if (!ColumnBytes.empty())
+            return ColumnBytes[column];
         return IsFinalColumn(column) ? FinalBytes : SymbolBytes;
     }
+
+    // Returns the number of bytes of the column within the given range
+    GF256_FORCE_INLINE unsigned GetColumnBytesInRange(unsigned column, unsigned offset, unsigned bytes) const
+    {
+        const unsigned columnBytes = GetColumnBytes(column);
+        if (columnBytes <= offset)
+            return 0;
+        return (columnBytes - offset < bytes) ? columnBytes - offset : bytes;
+    }
 };
 
 
+//------------------------------------------------------------------------------
+// ColumnLengths
+
+// Lengths of the originals in variable-length mode
+struct ColumnLengths
+{
+    // Length of each original, or zero if it is not known yet
+    std::vector<uint32_t> Lengths;
+
+    // Sums of the known lengths in each lane, like the lane sums of the data
+    uint32_t LaneSums[kColumnLaneCount][kColumnSumCount];
+
+
+    // Forget all lengths
+    void Reset(unsigned inputCount);
+
+    // Add the length of an original that was not known yet
+    void Add(unsigned column, uint32_t length);
+
+    // Returns the known lengths coded by the given recovery row, which is
+    // the value encoded by the encoder when all of the lengths are known
+    uint32_t EncodeRow(const AppDataWindow& window, unsigned row) const;
+};
+
+// Read the coded length from the end of a recovery symbol
+GF256_FORCE_INLINE uint32_t ReadLength(const uint8_t* data)
+{
+    return data[0] | ((uint32_t)data[1] << 8) | ((uint32_t)data[2] << 16) | ((uint32_t)data[3] << 24);
+}
+
+// Write the coded length to the end of a recovery symbol
+GF256_FORCE_INLINE void WriteLength(uint8_t* data, uint32_t length)
+{
+    data[0] = (uint8_t)length;
+    data[1] = (uint8_t)(length >> 8);
+    data[2] = (uint8_t)(length >> 16);
+    data[3] = (uint8_t)(length >> 24);
+}
+
+static_assert(kLengthBytes == 4, "Update ReadLength() and WriteLength()");
+
+
 //------------------------------------------------------------------------------
 // XORSummer
 
-// This optimization speeds up the codec by 15%
-#define FECAL_ADD2_OPT
+// Buffer several sources and add them with one pass over the destination
+#define FECAL_ADDN_OPT
+
+// Number of sources buffered before they are added to the destination
+static const unsigned kXORSummerSources = 8;
 
 class XORSummer
 {
@@ -614,20 +1043,19 @@ public:
     {
         DestBuffer = dest;
         Bytes = bytes;
-        Waiting = nullptr;
+        WaitingCount = 0;
     }
 
     // Accumulate some source data
     GF256_FORCE_INLINE void Add(const uint8_t* src)
     {
-#ifdef FECAL_ADD2_OPT
-        if (Waiting)
+#ifdef FECAL_ADDN_OPT
+        Waiting[WaitingCount++] = src;
+        if (WaitingCount >= kXORSummerSources)
         {
-            gf256_add2_mem(DestBuffer, src, Waiting, Bytes);
-            Waiting = nullptr;
+            gf256_addn_mem(DestBuffer, Waiting, WaitingCount, Bytes);
+            WaitingCount = 0;
         }
-        else
-            Waiting = src;
 #else
         gf256_add_mem(DestBuffer, src, Bytes);
 #endif
@@ -636,17 +1064,212 @@ public:
     // Finalize in the destination buffer
     GF256_FORCE_INLINE void Finalize()
     {
-#ifdef FECAL_ADD2_OPT
-        if (Waiting)
-            gf256_add_mem(DestBuffer, Waiting, Bytes);
+#ifdef FECAL_ADDN_OPT
+        if (WaitingCount > 0)
+            gf256_addn_mem(DestBuffer, Waiting, WaitingCount, Bytes);
+        WaitingCount = 0;
 #endif
     }
 
 protected:
     uint8_t* DestBuffer;
     unsigned Bytes;
-    const uint8_t* Waiting;
+    const void* Waiting[kXORSummerSources];
+    unsigned WaitingCount;
+};
+
+
+//------------------------------------------------------------------------------
+// SumSchedule
+
+/*
+    Large symbols do not fit in cache, so adding a long list of sources into a
+    destination one whole symbol at a time means the destination is read back
+    from memory for every source.  Instead the list of sources is recorded
+    once and then replayed for each stripe of kStripeBytes, so the destination
+    stripe stays in L1 cache while all of the sources are added into it.
+*/
+
+// Number of bytes processed at a time when replaying a schedule
+static const unsigned kStripeBytes = 8 * 1024;
+
+struct LaneSumSlab;
+
+class SumSchedule
+{
+public:
+    // Remove all sources
+    GF256_FORCE_INLINE void Clear()
+    {
+        Sources.clear();
+        LaneSources.clear();
+        Partials.clear();
+        Slab = nullptr;
+    }
+
+    // Add a source that covers the whole symbol
+    GF256_FORCE_INLINE void Add(const uint8_t* src)
+    {
+        Sources.push_back(src);
+    }
+
+    // Add a lane sum from the slab, which is replayed after the other sources
+    inline void AddLaneSum(const LaneSumSlab& slab, unsigned laneIndex, unsigned sumIndex);
+
+    // Add a column that only covers the first srcBytes of the symbol, such
+    // as the final column.  Past srcBytes the column is treated as zeroes
+    GF256_FORCE_INLINE void AddPartial(const uint8_t* src, unsigned srcBytes)
+    {
+        PartialSource partial;
+        partial.Data = src;
+        partial.Bytes = srcBytes;
+        Partials.push_back(partial);
+    }
+
+    // dest[0..bytes) = Sum of sources over [offset, offset + bytes)
+    void Store(uint8_t* dest, unsigned offset, unsigned bytes) const;
+
+    // dest[0..bytes) += Sum of sources over [offset, offset + bytes)
+    void Accumulate(uint8_t* dest, unsigned offset, unsigned bytes) const;
+
+    // dest[0..bytes) = Sum of sources + y * Sum of product sources over [offset, offset + bytes)
+    // The product is kept in registers, so no product workspace is needed
+    void StoreWithProduct(uint8_t* dest, uint8_t y, const SumSchedule& product,
+        unsigned offset, unsigned bytes) const;
+
+    // dest[0..bytes) += Sum of sources + y * Sum of product sources over [offset, offset + bytes)
+    void AccumulateWithProduct(uint8_t* dest, uint8_t y, const SumSchedule& product,
+        unsigned offset, unsigned bytes) const;
+
+    // Number of source bytes read when replaying over a whole symbol
+    inline uint64_t GetSourceBytes(unsigned symbolBytes) const
+    {
+        uint64_t bytes = static_cast<uint64_t>(Sources.size() + LaneSources.size()) * symbolBytes;
+        for (const PartialSource& partial : Partials)
+            bytes += partial.Bytes;
+        return bytes;
+    }
+
+protected:
+    std::vector<const uint8_t*> Sources;
+
+    // Sources that end before the end of the symbol
+    struct PartialSource
+    {
+        const uint8_t* Data;
+        unsigned Bytes;
+    };
+    std::vector<PartialSource> Partials;
+
+    // Lane sums at offset 0 in the slab they were added from
+    std::vector<const uint8_t*> LaneSources;
+    const LaneSumSlab* Slab = nullptr;
+
+
+    // Number of sources including the lane sums
+    GF256_FORCE_INLINE unsigned GetSourceCount() const
+    {
+        return static_cast<unsigned>(Sources.size() + LaneSources.size());
+    }
+
+    // Offset of the given byte within the lane sums
+    size_t GetLaneOffset(unsigned offset) const;
+
+    // Returns source i at the given offset, where the lane sums follow the
+    // other sources.  laneOffset: GetLaneOffset(offset)
+    GF256_FORCE_INLINE const uint8_t* GetSource(unsigned i, unsigned offset, size_t laneOffset) const
+    {
+        const unsigned count = static_cast<unsigned>(Sources.size());
+        return (i < count) ? Sources[i] + offset : LaneSources[i - count] + laneOffset;
+    }
+
+    // Add the partial sources over one stripe: Those that cover the whole
+    // stripe are given to the summer, and the rest are added to dest
+    void AddPartials(XORSummer& summer, uint8_t* dest, unsigned offset, unsigned bytes) const;
+
+    // Store or add the sum of sources, one stripe at a time
+    void Replay(bool store, uint8_t* dest, unsigned offset, unsigned bytes) const;
+
+    // Store or add the sum of sources and y times the product sources, one stripe at a time
+    void ReplayWithProduct(bool store, uint8_t* dest, uint8_t y, const SumSchedule& product,
+        unsigned offset, unsigned bytes) const;
 };
 
 
+//------------------------------------------------------------------------------
+// LaneSumSlab
+
+/*
+    The lane sums are stored in one allocation, split into chunks that are
+    each one stripe long (or one symbol long for small symbols).  Within
+    each chunk the sums of all lanes are stored next to each other:
+
+        Chunk 0: [Lane 0 Sum 0][Lane 0 Sum 1][Lane 0 Sum 2][Lane 1 Sum 0]...
+        Chunk 1: [Lane 0 Sum 0][Lane 0 Sum 1][Lane 0 Sum 2][Lane 1 Sum 0]...
+
+    So all of the lane sums that a row combines for one stripe come from one
+    contiguous block of memory rather than from 24 separate allocations.
+    A range of bytes that does not cross a stripe boundary is contiguous in
+    each lane sum.
+*/
+
+// Number of lane sums in the slab
+static const unsigned kLaneSumCount = kColumnLaneCount * kColumnSumCount;
+
+struct LaneSumSlab
+{
+    AlignedDataBuffer Buffer;
+
+    // Number of bytes of each lane sum in a chunk
+    unsigned ChunkBytes = 0;
+
+    // Number of bytes in each lane sum
+    unsigned SymbolBytes = 0;
+
+
+    // Allocate memory for the given symbol size
+    // New buffer contents have undefined initial state
+    bool Allocate(unsigned symbolBytes);
+
+    // Clear all lane sums to zero
+    void Clear();
+
+    // Returns the offset of the given byte within the lane sums
+    GF256_FORCE_INLINE size_t GetLaneOffset(unsigned offset) const
+    {
+        return static_cast<size_t>(offset / ChunkBytes) * (ChunkBytes * kLaneSumCount) + offset % ChunkBytes;
+    }
+
+    // Returns lane sum data at the given offset, contiguous to the end of the stripe
+    GF256_FORCE_INLINE uint8_t* Get(unsigned laneIndex, unsigned sumIndex, unsigned offset) const
+    {
+        FECAL_DEBUG_ASSERT(laneIndex < kColumnLaneCount && sumIndex < kColumnSumCount && offset < SymbolBytes);
+        return Buffer.Data + GetLaneOffset(offset) + (laneIndex * kColumnSumCount + sumIndex) * ChunkBytes;
+    }
+
+    // Sum(laneIndex, sumIndex) += y * data over the whole symbol
+    void MulAdd(unsigned laneIndex, unsigned sumIndex, uint8_t y, const uint8_t* data, unsigned bytes);
+
+    // Sum(laneIndex, sumIndex) = src over the whole symbol
+    void Load(unsigned laneIndex, unsigned sumIndex, const uint8_t* src);
+
+    // dest = Sum(laneIndex, sumIndex) over the whole symbol
+    void Store(unsigned laneIndex, unsigned sumIndex, uint8_t* dest) const;
+};
+
+inline void SumSchedule::AddLaneSum(const LaneSumSlab& slab, unsigned laneIndex, unsigned sumIndex)
+{
+    FECAL_DEBUG_ASSERT(!Slab || Slab == &slab);
+    Slab = &slab;
+    LaneSources.push_back(slab.Get(laneIndex, sumIndex, 0));
+}
+
+// Returns the number of bytes from offset to the end of its stripe, at most bytes
+GF256_FORCE_INLINE unsigned GetStripeBytes(unsigned offset, unsigned bytes)
+{
+    const unsigned stripeBytes = kStripeBytes - offset % kStripeBytes;
+    return (stripeBytes < bytes) ? stripeBytes : bytes;
+}
+
+
 } // namespace fecal
@@ -31,18 +31,83 @@
 namespace fecal {
 
 
+//------------------------------------------------------------------------------
+// RowHashSet
+
+void RowHashSet::Clear()
+{
+    if (Count > 0)
+        std::fill(Slots.begin(), Slots.end(), kRowEmptySlot);
+    Count = 0;
+    HasEmptySlotRow = false;
+}
+
+unsigned RowHashSet::FindSlot(unsigned row) const
+{
+    const unsigned mask = static_cast<unsigned>(Slots.size()) - 1;
+
+    // Fibonacci hash to spread out sequential row numbers
+    unsigned slot = (row * 0x9E3779B1u) & mask;
+
+    // Linear probing: The table is never more than half full
+    while (Slots[slot] != row && Slots[slot] != kRowEmptySlot)
+        slot = (slot + 1) & mask;
+
+    return slot;
+}
+
+void RowHashSet::Grow()
+{
+    std::vector<unsigned> oldSlots;
+    oldSlots.swap(Slots);
+
+    const unsigned slotCount = oldSlots.empty() ? kRowMinSlots : static_cast<unsigned>(oldSlots.size()) * 2;
+    Slots.assign(slotCount, kRowEmptySlot);
+
+    for (unsigned row : oldSlots)
+        if (row != kRowEmptySlot)
+            Slots[FindSlot(row)] = row;
+}
+
+bool RowHashSet::Insert(unsigned row)
+{
+    if (row == kRowEmptySlot)
+    {
+        if (HasEmptySlotRow)
+            return false;
+        HasEmptySlotRow = true;
+        return true;
+    }
+
+    // Keep the table at most half full
+    if ((Count + 1) * 2 > Slots.size())
+        Grow();
+
+    const unsigned slot = FindSlot(row);
+    if (Slots[slot] == row)
+        return false;
+
+    Slots[slot] = row;
+    ++Count;
+    return true;
+}
+
+
 //------------------------------------------------------------------------------
 // DecoderAppDataWindow
 
 void DecoderAppDataWindow::AllocateOriginals()
 {
-    OriginalData.resize(InputCount);
+    OriginalData.assign(InputCount, OriginalInfo());
+    OriginalGotCount = 0;
 
     // Allocate some space for recovery data too (20% of original data size)
+    RecoveryData.clear();
     RecoveryData.reserve(InputCount / 5 + 1);
+    RowSet.Clear();
 
     SubwindowCount = (InputCount + kSubwindowSize - 1) / kSubwindowSize;
-    Subwindows.resize(SubwindowCount);
+    Subwindows.assign(SubwindowCount, Subwindow());
 }
 
 bool DecoderAppDataWindow::AddOriginal(unsigned column, uint8_t* data)
@@ -59,17 +124,17 @@ bool DecoderAppDataWindow::AddOriginal(unsigned column, uint8_t* data)
     return true;
 }
 
-bool DecoderAppDataWindow::AddRecovery(uint8_t* data, unsigned row)
+bool DecoderAppDataWindow::AddRecovery(const uint8_t* data, unsigned row, bool readOnly)
 {
     FECAL_DEBUG_ASSERT(InputCount > 0); // SetParameters() must be called first
 
     // Trying to insert with duplicate ID: It will not be inserted
-    auto res = RowSet.insert(row);
-    if (!res.second)
+    if (!RowSet.Insert(row))
         return false;
 
     RecoveryInfo info;
-    info.Data = data;
+    info.Data = readOnly ? nullptr : const_cast<uint8_t*>(data);
+    info.ReceivedData = data;
     info.Row = row;
     info.UsedForSolution = false;
     RecoveryData.push_back(info);
@@ -134,32 +199,118 @@ unsigned DecoderAppDataWindow::FindNextLostElement(unsigned elementStart)
 //------------------------------------------------------------------------------
 // Decoder
 
-FecalResult Decoder::Initialize(unsigned input_count, uint64_t total_bytes)
+FecalResult Decoder::Initialize(unsigned input_count, uint64_t total_bytes, const FecalDecoderOptions* options)
 {
-    RecoveryMatrix.Window = &Window;
+    const FecalResult result = ApplyOptions(options);
+    if (result != Fecal_Success)
+        return result;
 
     if (!Window.SetParameters(input_count, total_bytes))
     {
         FECAL_DEBUG_BREAK; // Invalid input
         return Fecal_InvalidInput;
     }
+
+    return InitializeInput();
+}
+
+FecalResult Decoder::InitializeVariable(unsigned input_count, unsigned symbol_bytes, const FecalDecoderOptions* options)
+{
+    const FecalResult result = ApplyOptions(options);
+    if (result != Fecal_Success)
+        return result;
+
+    // The lengths of the originals are learned as they arrive or are recovered
+    if (!Window.SetVariableParameters(input_count, symbol_bytes, nullptr))
+    {
+        FECAL_DEBUG_BREAK; // Invalid input
+        return Fecal_InvalidInput;
+    }
+    Lengths.Reset(input_count);
+
+    return InitializeInput();
+}
+
+FecalResult Decoder::ApplyOptions(const FecalDecoderOptions* options)
+{
+    if (options)
+    {
+        if (static_cast<unsigned>(options->RowScheme) >= Fecal_RowScheme_Count)
+        {
+            FECAL_DEBUG_BREAK; // Invalid input
+            return Fecal_InvalidInput;
+        }
+
+        Executor = options->Executor;
+        ConstRecoveryData = options->ConstRecoveryData != 0;
+        OnlineDecode = options->OnlineDecode != 0;
+        Window.RowCache = reinterpret_cast<const RowScheduleCache*>( options->RowCache );
+        Window.RowScheme = options->RowScheme;
+    }
+
+    return Fecal_Success;
+}
+
+FecalResult Decoder::InitializeInput()
+{
+    RecoveryMatrix.Window = &Window;
+
+#ifdef FECAL_ENABLE_STATS
+    RecoveryMatrix.Stats = &Stats;
+    Stats = FecalDecoderStats();
+#endif // FECAL_ENABLE_STATS
+
     Window.AllocateOriginals();
 
+    // Online decoding adds each original into the lane sums as it arrives
+    if (OnlineDecode)
+    {
+        if (!LaneSums.Allocate(Window.SymbolBytes))
+            return Fecal_OutOfMemory;
+        LaneSums.Clear();
+    }
+
+    // Clear state from any previous input
+    RecoveryMatrix.Reset();
+    RecoveryMatrixSolved = false;
+    RecoveryAttempted = false;
+    OnlineSolveFailed = false;
+    RecoveredData.clear();
+
     return Fecal_Success;
 }
 
 FecalResult Decoder::AddOriginal(const FecalSymbol& symbol)
 {
+    // In variable-length mode an original can have any length up to SymbolBytes
+    const bool validBytes = Window.IsVariableLength() ?
+        (symbol.Bytes > 0 && symbol.Bytes <= Window.SymbolBytes) :
+        (symbol.Bytes == Window.GetColumnBytes(symbol.Index));
+
     if (symbol.Index >= Window.InputCount ||
         symbol.Data == nullptr ||
-        symbol.Bytes != Window.GetColumnBytes(symbol.Index))
+        !validBytes)
     {
         FECAL_DEBUG_BREAK; // Invalid input
         return Fecal_InvalidInput;
     }
 
     if (Window.AddOriginal(symbol.Index, (uint8_t*)symbol.Data))
+    {
+        if (Window.IsVariableLength())
+        {
+            Window.ColumnBytes[symbol.Index] = symbol.Bytes;
+            Lengths.Add(symbol.Index, symbol.Bytes);
+        }
+
+        // The recovery matrix columns have changed
         RecoveryAttempted = false;
+        RecoveryMatrixSolved = false;
+        OnlineSolveFailed = false;
+
+        if (OnlineDecode)
+            OnlineAddOriginal(symbol.Index, (const uint8_t*)symbol.Data);
+    }
 
     return Fecal_Success;
 }
@@ -167,18 +318,99 @@ FecalResult Decoder::AddOriginal(const FecalSymbol& symbol)
 FecalResult Decoder::AddRecovery(const FecalSymbol& symbol)
 {
     if (symbol.Data == nullptr ||
-        symbol.Bytes != Window.SymbolBytes)
+        symbol.Bytes != Window.RecoveryBytes)
     {
         FECAL_DEBUG_BREAK; // Invalid input
         return Fecal_InvalidInput;
     }
 
-    if (Window.AddRecovery((uint8_t*)symbol.Data, symbol.Index))
+    if (Window.AddRecovery((const uint8_t*)symbol.Data, symbol.Index, ConstRecoveryData))
+    {
         RecoveryAttempted = false;
+        OnlineSolveFailed = false;
+
+        if (OnlineDecode && Window.OriginalGotCount < Window.InputCount)
+        {
+            // Read-only recovery data cannot be modified until it is copied
+            if (!ConstRecoveryData)
+                OnlineAddRecovery(static_cast<unsigned>(Window.RecoveryData.size()) - 1);
+
+            // Solve as much of the recovery matrix as possible with the new row
+            const FecalResult result = SolveRecoveryMatrix();
+            if (result == Fecal_OutOfMemory)
+                return Fecal_OutOfMemory;
+
+            // Decode() cannot do better until more data arrives
+            OnlineSolveFailed = (result != Fecal_Success);
+        }
+    }
 
     return Fecal_Success;
 }
 
+void Decoder::OnlineAddOriginal(unsigned column, const uint8_t* data)
+{
+    const unsigned columnBytes = Window.GetColumnBytes(column);
+    const unsigned laneIndex = column % kColumnLaneCount;
+    const uint8_t CX = GetColumnValue(column);
+
+    LaneSums.MulAdd(laneIndex, 0, 1, data, columnBytes);
+    LaneSums.MulAdd(laneIndex, 1, CX, data, columnBytes);
+    LaneSums.MulAdd(laneIndex, 2, gf256_sqr(CX), data, columnBytes);
+
+    static_assert(kColumnSumCount == 3, "Update this");
+
+    const unsigned inputCount = Window.InputCount;
+    const unsigned drawCount = 2 * ((inputCount + kPairAddRate - 1) / kPairAddRate);
+    const unsigned rows = static_cast<unsigned>(Window.RecoveryData.size());
+
+    // For each recovery row received before this original:
+    for (unsigned recoveryIndex = 0; recoveryIndex < rows; ++recoveryIndex)
+    {
+        const RecoveryInfo& recovery = Window.RecoveryData[recoveryIndex];
+        if (!recovery.PairsEliminated)
+            continue;
+
+        // Find all the times the row drew this column
+        const unsigned* draws = &OnlineDraws[static_cast<size_t>(recoveryIndex) * drawCount];
+        const unsigned* drawsEnd = draws + drawCount;
+        const unsigned* draw = std::lower_bound(draws, drawsEnd, column * 2);
+
+        for (; draw < drawsEnd && (*draw >> 1) == column; ++draw)
+        {
+            if (*draw & 1)
+                gf256_muladd_mem(recovery.Data, GetRowValue(recovery.Row), data, columnBytes);
+            else
+                gf256_add_mem(recovery.Data, data, columnBytes);
+        }
+    }
+}
+
+void Decoder::OnlineAddRecovery(unsigned recoveryIndex)
+{
+    RecoveryInfo& recovery = Window.RecoveryData[recoveryIndex];
+
+    const unsigned inputCount = Window.InputCount;
+    const unsigned drawCount = 2 * ((inputCount + kPairAddRate - 1) / kPairAddRate);
+    const size_t drawsEnd = static_cast<size_t>(recoveryIndex + 1) * drawCount;
+    if (OnlineDraws.size() < drawsEnd)
+        OnlineDraws.resize(drawsEnd);
+    unsigned* draws = &OnlineDraws[drawsEnd - drawCount];
+
+    OnlineSum.Clear();
+    OnlineProduct.Clear();
+    ScheduleLightElimination(recovery, OnlineSum, OnlineProduct, draws);
+
+    // Recovery += Sum + RX * Product
+    OnlineSum.AccumulateWithProduct(
+        recovery.Data, GetRowValue(recovery.Row), OnlineProduct,
+        0, Window.SymbolBytes);
+
+    // Sort the draws so originals that arrive later can find this row
+    std::sort(draws, draws + drawCount);
+    recovery.PairsEliminated = true;
+}
+
 FecalResult Decoder::GetOriginal(unsigned column, FecalSymbol& symbol)
 {
     symbol.Index = column;
@@ -213,200 +445,528 @@ FecalResult Decoder::Decode(RecoveredSymbols& symbols)
     if (Window.OriginalGotCount + static_cast<unsigned>(Window.RecoveryData.size()) < Window.InputCount)
         return Fecal_NeedMoreData;
 
-    // If recovery was already attempted:
-    if (RecoveryAttempted)
+    // If recovery was already attempted, here or by an online solve:
+    if (RecoveryAttempted || OnlineSolveFailed)
         return Fecal_NeedMoreData;
     RecoveryAttempted = true;
 
-    // Generate updated recovery matrix
-    if (!RecoveryMatrix.GenerateMatrix())
-        return Fecal_OutOfMemory;
-
-    // Attempt to solve the linear system
-    if (!RecoveryMatrix.GaussianElimination())
-        return Fecal_NeedMoreData;
+    FECAL_STATS_TIMER(decodeTimer, Stats.DecodeNsec);
 
-    FecalResult result = EliminateOriginalData();
+    FecalResult result = SolveRecoveryMatrix();
     if (result != Fecal_Success)
         return result;
 
-    MultiplyLowerTriangle();
+    {
+        FECAL_STATS_TIMER(scheduleTimer, Stats.ScheduleNsec);
+
+        result = AllocateRecoveryWorkspace();
+        if (result != Fecal_Success)
+            return result;
+
+        ScheduleElimination();
+
+#ifdef FECAL_INVERSE_RECOVERY
+        if (InverseRecovery)
+            InvertRecoveryMatrix();
+#endif // FECAL_INVERSE_RECOVERY
+
+        FECAL_STATS(CountRecoveryBytes());
+    }
+
+    {
+        FECAL_STATS_TIMER(recoveryTimer, Stats.RecoveryNsec);
+
+        // The recovery steps are independent for each byte of the symbols, so
+        // the symbols are split into byte ranges that are recovered in parallel
+        RecoveryTaskContext context;
+        context.Codec = this;
+        context.StripeBytes = GetParallelRangeBytes(Executor, Window.SymbolBytes, 1);
+
+        const unsigned taskCount = (Window.SymbolBytes + context.StripeBytes - 1) / context.StripeBytes;
+        FECAL_STATS(TaskNsec.assign(taskCount * 2, 0));
+
+        RunParallelTasks(
+            Executor,
+            taskCount,
+            &Decoder::RecoveryTask,
+            &context);
+
+#ifdef FECAL_ENABLE_STATS
+        for (unsigned i = 0; i < taskCount; ++i)
+        {
+            Stats.EliminateNsec += TaskNsec[i * 2];
+            Stats.SolveNsec += TaskNsec[i * 2 + 1];
+        }
+#endif // FECAL_ENABLE_STATS
+
+        if (Window.IsVariableLength())
+            RecoverLengths();
+
+        StoreRecoveredData();
+    }
+
+    symbols.Symbols = &RecoveredData[0];
+    symbols.Count = static_cast<unsigned>(RecoveredData.size());
+
+    return Fecal_Success;
+}
+
+FecalResult Decoder::SolveRecoveryMatrix()
+{
+    // If the matrix was already solved as recovery data arrived:
+    if (RecoveryMatrixSolved)
+        return Fecal_Success;
+
+    FECAL_STATS(++Stats.SolveAttempts);
+
+    bool solved;
+
+#ifdef FECAL_SINGLE_LOSS
+    // With one lost column, any row with a nonzero coefficient is a solution
+    if (Window.OriginalGotCount + 1 == Window.InputCount)
+    {
+        FECAL_STATS_TIMER(geTimer, Stats.GaussianEliminationNsec);
+        FECAL_STATS(Stats.MatrixRows = static_cast<unsigned>(Window.RecoveryData.size()));
+        FECAL_STATS(Stats.MatrixColumns = 1);
+
+        solved = RecoveryMatrix.SolveSingleLoss();
+    }
+    else
+#endif // FECAL_SINGLE_LOSS
+    {
+        // Generate updated recovery matrix
+        {
+            FECAL_STATS_TIMER(generateTimer, Stats.GenerateMatrixNsec);
+
+            if (!RecoveryMatrix.GenerateMatrix())
+                return Fecal_OutOfMemory;
+        }
 
-    result = BackSubstitution();
+        FECAL_STATS(Stats.MatrixRows = RecoveryMatrix.Matrix.Rows);
+        FECAL_STATS(Stats.MatrixColumns = RecoveryMatrix.Matrix.Columns);
 
-    if (result == Fecal_Success)
+        // Attempt to solve the linear system
+        FECAL_STATS_TIMER(geTimer, Stats.GaussianEliminationNsec);
+
+        solved = RecoveryMatrix.GaussianElimination();
+    }
+
+    if (!solved)
     {
-        symbols.Symbols = &RecoveredData[0];
-        symbols.Count = static_cast<unsigned>(RecoveredData.size());
+        FECAL_STATS(++Stats.SolveFailures);
+        return Fecal_NeedMoreData;
     }
 
-    return result;
+    RecoveryMatrixSolved = true;
+    return Fecal_Success;
 }
 
-FecalResult Decoder::EliminateOriginalData()
+FecalResult Decoder::AllocateRecoveryWorkspace()
 {
-    // Allocate workspace
     const unsigned symbolBytes = Window.SymbolBytes;
-    if (!ProductWorkspace.Allocate(symbolBytes))
+    const unsigned rows = static_cast<unsigned>(Window.RecoveryData.size());
+
+    // Online decoding keeps all of the lane sums up to date already
+    if (!OnlineDecode)
+    {
+        // Collect the set of lane sums used by rows in the solution
+        unsigned* neededSums = NeededLaneSums;
+        for (unsigned laneIndex = 0; laneIndex < kColumnLaneCount; ++laneIndex)
+            neededSums[laneIndex] = 0;
+
+        for (unsigned matrixRowIndex = 0; matrixRowIndex < rows; ++matrixRowIndex)
+        {
+            const RecoveryInfo& recovery = Window.RecoveryData[matrixRowIndex];
+            if (!recovery.UsedForSolution)
+                continue;
+
+            for (unsigned laneIndex = 0; laneIndex < kColumnLaneCount; ++laneIndex)
+            {
+                const unsigned opcode = GetRowOpcode(Window.RowCache, laneIndex, recovery.Row, Window.InputCount);
+                neededSums[laneIndex] |= opcode | (opcode >> kColumnSumCount);
+            }
+        }
+
+        if (!LaneSums.Allocate(symbolBytes))
+            return Fecal_OutOfMemory;
+    }
+
+    InverseRecovery = false;
+#ifdef FECAL_INVERSE_RECOVERY
+    // Use the inverse if the symbols are large enough to pay for it
+    const unsigned columns = static_cast<unsigned>(RecoveryMatrix.Columns.size());
+    if (!RecoveryMatrix.SingleLossSolved &&
+        columns >= kInverseMinColumns &&
+        symbolBytes >= columns * kInverseMinBytesPerColumn)
+    {
+        if (!LowerInverse.Initialize(columns, columns) ||
+            !UpperInverse.Initialize(columns, columns))
+        {
+            return Fecal_OutOfMemory;
+        }
+        InverseRecovery = true;
+    }
+#endif // FECAL_INVERSE_RECOVERY
+
+    if (!ConstRecoveryData)
+        return Fecal_Success;
+
+    // Give each recovery row in the solution a buffer in the arena
+    const unsigned arenaStride = NextAlignedOffset(Window.RecoveryBytes);
+    unsigned arenaRows = 0;
+    for (unsigned matrixRowIndex = 0; matrixRowIndex < rows; ++matrixRowIndex)
+        if (Window.RecoveryData[matrixRowIndex].UsedForSolution)
+            ++arenaRows;
+    if (!RecoveryArena.Allocate(static_cast<uint64_t>(arenaStride) * arenaRows))
         return Fecal_OutOfMemory;
 
-    const unsigned rows = static_cast<unsigned>(Window.RecoveryData.size());
+    uint8_t* arenaData = RecoveryArena.Data;
+    for (unsigned matrixRowIndex = 0; matrixRowIndex < rows; ++matrixRowIndex)
+    {
+        RecoveryInfo& recovery = Window.RecoveryData[matrixRowIndex];
+        if (!recovery.UsedForSolution)
+        {
+            recovery.Data = nullptr;
+            continue;
+        }
 
-    // Eliminate data in sorted row order regardless of pivot order:
+        recovery.Data = arenaData;
+        arenaData += arenaStride;
+    }
+
+    return Fecal_Success;
+}
+
+void Decoder::RecoveryTask(void* context_v, unsigned taskIndex)
+{
+    const RecoveryTaskContext* context = reinterpret_cast<const RecoveryTaskContext*>( context_v );
+    Decoder* decoder = context->Codec;
+
+    const unsigned offset = taskIndex * context->StripeBytes;
+
+    unsigned rangeEnd = offset + context->StripeBytes;
+    if (rangeEnd > decoder->Window.SymbolBytes)
+        rangeEnd = decoder->Window.SymbolBytes;
+
+#ifdef FECAL_ENABLE_STATS
+    uint64_t eliminateNsec = 0, solveNsec = 0;
+#endif // FECAL_ENABLE_STATS
+
+    // Run all the steps on one stripe at a time so the data stays in cache
+    for (unsigned stripe = offset; stripe < rangeEnd;)
+    {
+        const unsigned bytes = GetStripeBytes(stripe, rangeEnd - stripe);
+
+        {
+            FECAL_STATS_TIMER(eliminateTimer, eliminateNsec);
+
+            decoder->CopyReceivedData(stripe, bytes);
+
+            if (!decoder->OnlineDecode)
+                for (unsigned laneIndex = 0; laneIndex < kColumnLaneCount; ++laneIndex)
+                    decoder->ComputeLaneSums(laneIndex, stripe, bytes);
+
+            decoder->EliminateOriginalData(stripe, bytes);
+        }
+
+        {
+            FECAL_STATS_TIMER(solveTimer, solveNsec);
+
+            decoder->SolveLostData(stripe, bytes);
+        }
+
+        stripe += bytes;
+    }
+
+#ifdef FECAL_ENABLE_STATS
+    // Each task writes only its own slots
+    decoder->TaskNsec[taskIndex * 2] = eliminateNsec;
+    decoder->TaskNsec[taskIndex * 2 + 1] = solveNsec;
+#endif // FECAL_ENABLE_STATS
+}
+
+void Decoder::SolveLostData(unsigned offset, unsigned bytes)
+{
+    if (RecoveryMatrix.SingleLossSolved)
+        RecoverSingleLoss(offset, bytes);
+    else if (InverseRecovery)
+        ApplyRecoveryInverse(offset, bytes);
+    else
+    {
+        MultiplyLowerTriangle(offset, bytes);
+        BackSubstitution(offset, bytes);
+    }
+}
+
+void Decoder::RecoverLengths()
+{
+    // The coded lengths follow the data in each recovery symbol
+    const unsigned offset = Window.SymbolBytes;
+
+    CopyReceivedData(offset, kLengthBytes);
+
+    // Eliminate the lengths of the received originals
+    const unsigned rows = static_cast<unsigned>(Window.RecoveryData.size());
     for (unsigned matrixRowIndex = 0; matrixRowIndex < rows; ++matrixRowIndex)
     {
         const RecoveryInfo& recovery = Window.RecoveryData[matrixRowIndex];
         if (!recovery.UsedForSolution)
             continue;
 
-        // Zero the product sum
-        memset(ProductWorkspace.Data, 0, symbolBytes);
+        uint8_t* recoveryLength = recovery.Data + offset;
+        WriteLength(recoveryLength, ReadLength(recoveryLength) ^ Lengths.EncodeRow(Window, recovery.Row));
+    }
+
+    SolveLostData(offset, kLengthBytes);
+}
+
+#ifdef FECAL_ENABLE_STATS
+
+void Decoder::CountRecoveryBytes()
+{
+    const unsigned symbolBytes = Window.SymbolBytes;
+    const unsigned rows = static_cast<unsigned>(Window.RecoveryData.size());
+    const uint64_t columns = RecoveryMatrix.Columns.size();
+
+    for (unsigned matrixRowIndex = 0; matrixRowIndex < rows; ++matrixRowIndex)
+    {
+        if (!Window.RecoveryData[matrixRowIndex].UsedForSolution)
+            continue;
+
+        if (ConstRecoveryData)
+            Stats.CopyBytes += Window.RecoveryBytes;
 
-        XORSummer summer1;
-        summer1.Initialize(recovery.Data, symbolBytes);
-        XORSummer summerRX;
-        summerRX.Initialize(ProductWorkspace.Data, symbolBytes);
+        Stats.EliminateBytes += RowSumSchedules[matrixRowIndex].GetSourceBytes(symbolBytes);
+        Stats.EliminateBytes += RowProductSchedules[matrixRowIndex].GetSourceBytes(symbolBytes);
+    }
+
+    // Online decoding computed the lane sums as the originals arrived
+    if (!OnlineDecode)
+    {
+        for (unsigned column = 0; column < Window.InputCount; ++column)
+        {
+            if (!Window.OriginalData[column].Data)
+                continue;
+
+            const unsigned neededSums = NeededLaneSums[column % kColumnLaneCount];
+            const unsigned sumCount = (neededSums & 1) + ((neededSums >> 1) & 1) + ((neededSums >> 2) & 1);
+            Stats.LaneSumBytes += static_cast<uint64_t>(sumCount) * Window.GetColumnBytes(column);
+        }
+    }
+
+    // The triangles or their inverses touch each pair of solution rows once
+    if (RecoveryMatrix.SingleLossSolved)
+        Stats.SolveBytes += symbolBytes;
+    else
+        Stats.SolveBytes += columns * columns * symbolBytes;
+}
+
+#endif // FECAL_ENABLE_STATS
+
+void Decoder::ScheduleElimination()
+{
+    const unsigned rows = static_cast<unsigned>(Window.RecoveryData.size());
+    if (RowSumSchedules.size() < rows)
+    {
+        RowSumSchedules.resize(rows);
+        RowProductSchedules.resize(rows);
+    }
+
+    for (unsigned matrixRowIndex = 0; matrixRowIndex < rows; ++matrixRowIndex)
+    {
+        const RecoveryInfo& recovery = Window.RecoveryData[matrixRowIndex];
+        if (!recovery.UsedForSolution)
+            continue;
+
+        SumSchedule& sum = RowSumSchedules[matrixRowIndex];
+        SumSchedule& prod = RowProductSchedules[matrixRowIndex];
+        sum.Clear();
+        prod.Clear();
 
         // Eliminate dense recovery data outside of matrix:
         for (unsigned laneIndex = 0; laneIndex < kColumnLaneCount; ++laneIndex)
         {
-            const unsigned opcode = GetRowOpcode(laneIndex, recovery.Row);
+            const unsigned opcode = GetRowOpcode(Window.RowCache, laneIndex, recovery.Row, Window.InputCount);
 
             // For summations into the RecoveryPacket buffer:
             unsigned mask = 1;
             for (unsigned sumIndex = 0; sumIndex < kColumnSumCount; ++sumIndex)
             {
                 if (opcode & mask)
-                    summer1.Add(GetLaneSum(laneIndex, sumIndex));
+                    sum.AddLaneSum(LaneSums, laneIndex, sumIndex);
                 mask <<= 1;
             }
 
-            // For summations into the ProductWorkspace buffer:
+            // For summations into the product that is multiplied by RX:
             for (unsigned sumIndex = 0; sumIndex < kColumnSumCount; ++sumIndex)
             {
                 if (opcode & mask)
-                    summerRX.Add(GetLaneSum(laneIndex, sumIndex));
+                    prod.AddLaneSum(LaneSums, laneIndex, sumIndex);
                 mask <<= 1;
             }
         }
 
         // Eliminate light recovery data outside of matrix:
-        const unsigned inputCount = Window.InputCount;
-        PCGRandom prng;
-        prng.Seed(recovery.Row, inputCount);
+        if (!recovery.PairsEliminated)
+            ScheduleLightElimination(recovery, sum, prod, nullptr);
+    }
+}
 
-        const unsigned pairCount = (inputCount + kPairAddRate - 1) / kPairAddRate;
-        for (unsigned i = 0; i < pairCount; ++i)
+void Decoder::ScheduleLightElimination(
+    const RecoveryInfo& recovery, SumSchedule& sum, SumSchedule& prod, unsigned* draws)
+{
+    const unsigned inputCount = Window.InputCount;
+    const unsigned symbolBytes = Window.SymbolBytes;
+    const unsigned pairCount = (inputCount + kPairAddRate - 1) / kPairAddRate;
+
+    RowSchedule schedule;
+    schedule.Initialize(Window.RowCache, recovery.Row, inputCount, Window.RowScheme);
+
+    for (unsigned i = 0; i < pairCount; ++i)
+    {
+        const unsigned element1 = schedule.NextColumn();
+        const uint8_t* original1 = Window.OriginalData[element1].Data;
+        if (original1)
         {
-            const unsigned element1 = prng.Next() % inputCount;
-            const uint8_t* original1 = Window.OriginalData[element1].Data;
-            if (original1)
-            {
-                if (element1 == inputCount - 1)
-                    gf256_add_mem(recovery.Data, original1, Window.FinalBytes);
-                else
-                    summer1.Add(original1);
-            }
+            const unsigned bytes1 = Window.GetColumnBytes(element1);
+            if (bytes1 < symbolBytes)
+                sum.AddPartial(original1, bytes1);
+            else
+                sum.Add(original1);
+        }
 
-            const unsigned elementRX = prng.Next() % inputCount;
-            const uint8_t* originalRX = Window.OriginalData[elementRX].Data;
-            if (originalRX)
-            {
-                if (elementRX == inputCount - 1)
-                    gf256_add_mem(ProductWorkspace.Data, originalRX, Window.FinalBytes);
-                else
-                    summerRX.Add(originalRX);
-            }
+        const unsigned elementRX = schedule.NextColumn();
+        const uint8_t* originalRX = Window.OriginalData[elementRX].Data;
+        if (originalRX)
+        {
+            const unsigned bytesRX = Window.GetColumnBytes(elementRX);
+            if (bytesRX < symbolBytes)
+                prod.AddPartial(originalRX, bytesRX);
+            else
+                prod.Add(originalRX);
         }
 
-        summer1.Finalize();
-        summerRX.Finalize();
+        if (draws)
+        {
+            draws[i * 2] = element1 * 2;
+            draws[i * 2 + 1] = elementRX * 2 + 1;
+        }
+    }
+}
+
+void Decoder::CopyReceivedData(unsigned offset, unsigned bytes)
+{
+    if (!ConstRecoveryData)
+        return;
 
-        const uint8_t RX = GetRowValue(recovery.Row);
-        gf256_muladd_mem(recovery.Data, RX, ProductWorkspace.Data, symbolBytes);
+    const unsigned rows = static_cast<unsigned>(Window.RecoveryData.size());
+    for (unsigned matrixRowIndex = 0; matrixRowIndex < rows; ++matrixRowIndex)
+    {
+        const RecoveryInfo& recovery = Window.RecoveryData[matrixRowIndex];
+        if (recovery.UsedForSolution)
+            memcpy(recovery.Data + offset, recovery.ReceivedData + offset, bytes);
     }
+}
 
-    return Fecal_Success;
+void Decoder::EliminateOriginalData(unsigned offset, unsigned bytes)
+{
+    const unsigned rows = static_cast<unsigned>(Window.RecoveryData.size());
+
+    // Eliminate data in sorted row order regardless of pivot order:
+    for (unsigned matrixRowIndex = 0; matrixRowIndex < rows; ++matrixRowIndex)
+    {
+        const RecoveryInfo& recovery = Window.RecoveryData[matrixRowIndex];
+        if (!recovery.UsedForSolution)
+            continue;
+
+        uint8_t* recoveryData = recovery.Data + offset;
+
+        // Recovery += Sum + RX * Product
+        const uint8_t RX = GetRowValue(recovery.Row);
+        RowSumSchedules[matrixRowIndex].AccumulateWithProduct(
+            recoveryData, RX, RowProductSchedules[matrixRowIndex], offset, bytes);
+    }
 }
 
-const uint8_t* Decoder::GetLaneSum(unsigned laneIndex, unsigned sumIndex)
+void Decoder::ComputeLaneSums(unsigned laneIndex, unsigned offset, unsigned bytes)
 {
-    AlignedDataBuffer& sum = LaneSums[laneIndex][sumIndex];
-    if (sum.Data)
-        return sum.Data;
+    // Buffers may remain allocated from previous input, so check the mask
+    const unsigned neededSums = NeededLaneSums[laneIndex];
 
-    const unsigned symbolBytes = Window.SymbolBytes;
-    if (!sum.Allocate(symbolBytes))
-        return nullptr;
+    // If no sums are needed for this lane:
+    if (neededSums == 0)
+        return;
+
+    uint8_t* sum0 = (neededSums & 1) ? LaneSums.Get(laneIndex, 0, offset) : nullptr;
+    uint8_t* sum1 = (neededSums & 2) ? LaneSums.Get(laneIndex, 1, offset) : nullptr;
+    uint8_t* sum2 = (neededSums & 4) ? LaneSums.Get(laneIndex, 2, offset) : nullptr;
 
-    memset(sum.Data, 0, symbolBytes);
+    if (sum0)
+        memset(sum0, 0, bytes);
+    if (sum1)
+        memset(sum1, 0, bytes);
+    if (sum2)
+        memset(sum2, 0, bytes);
 
-    const unsigned inputEnd = Window.InputCount - 1;
-    if (sumIndex == 0)
+    const unsigned inputCount = Window.InputCount;
+
+    if (sum0)
     {
         XORSummer summer;
-        summer.Initialize(sum.Data, symbolBytes);
+        summer.Initialize(sum0, bytes);
 
         // For each input column:
-        for (unsigned column = laneIndex; column < inputEnd; column += kColumnLaneCount)
+        // Columns that end within this range are added on their own
+        for (unsigned column = laneIndex; column < inputCount; column += kColumnLaneCount)
         {
             const uint8_t* data = Window.OriginalData[column].Data;
-            if (data)
-                summer.Add(data);
-        }
-        if (inputEnd % kColumnLaneCount == laneIndex)
-        {
-            const uint8_t* data = Window.OriginalData[inputEnd].Data;
-            if (data)
-                gf256_add_mem(sum.Data, data, Window.FinalBytes);
+            if (!data)
+                continue;
+
+            const unsigned columnBytes = Window.GetColumnBytesInRange(column, offset, bytes);
+            if (columnBytes >= bytes)
+                summer.Add(data + offset);
+            else if (columnBytes > 0)
+                gf256_add_mem(sum0, data + offset, columnBytes);
         }
 
         summer.Finalize();
-        return sum.Data;
     }
 
+    if (!sum1 && !sum2)
+        return;
+
     // For each input column:
-    for (unsigned column = laneIndex; column < inputEnd; column += kColumnLaneCount)
+    for (unsigned column = laneIndex; column < inputCount; column += kColumnLaneCount)
     {
         const uint8_t* data = Window.OriginalData[column].Data;
         if (!data)
             continue;
 
-        uint8_t CX_or_CX2 = GetColumnValue(column);
-        if (sumIndex == 2)
-            CX_or_CX2 = gf256_sqr(CX_or_CX2);
+        const unsigned columnBytes = Window.GetColumnBytesInRange(column, offset, bytes);
+        if (columnBytes <= 0)
+            continue;
 
-        gf256_muladd_mem(sum.Data, CX_or_CX2, data, symbolBytes);
-    }
-    if (inputEnd % kColumnLaneCount == laneIndex)
-    {
-        const uint8_t* data = Window.OriginalData[inputEnd].Data;
-        if (data)
-        {
-            uint8_t CX_or_CX2 = GetColumnValue(inputEnd);
-            if (sumIndex == 2)
-                CX_or_CX2 = gf256_sqr(CX_or_CX2);
+        const uint8_t CX = GetColumnValue(column);
 
-            gf256_muladd_mem(sum.Data, CX_or_CX2, data, Window.FinalBytes);
-        }
+        if (sum1)
+            gf256_muladd_mem(sum1, CX, data + offset, columnBytes);
+        if (sum2)
+            gf256_muladd_mem(sum2, gf256_sqr(CX), data + offset, columnBytes);
     }
 
-    return sum.Data;
-
     static_assert(kColumnSumCount == 3, "Update this");
 }
 
-void Decoder::MultiplyLowerTriangle()
+void Decoder::MultiplyLowerTriangle(unsigned offset, unsigned bytes)
 {
     const unsigned columns = static_cast<unsigned>(RecoveryMatrix.Columns.size());
-    const unsigned srcBytes = Window.SymbolBytes;
 
     // Multiply lower triangle following solution order from left to right:
     for (unsigned col_i = 0; col_i < columns - 1; ++col_i)
     {
         const unsigned matrixRowIndex_i = RecoveryMatrix.Pivots[col_i];
-        const uint8_t* srcData = Window.RecoveryData[matrixRowIndex_i].Data;
-        FECAL_DEBUG_ASSERT(srcData && srcBytes > 0);
+        const uint8_t* srcData = Window.RecoveryData[matrixRowIndex_i].Data + offset;
 
         for (unsigned col_j = col_i + 1; col_j < columns; ++col_j)
         {
@@ -416,58 +976,229 @@ void Decoder::MultiplyLowerTriangle()
             if (y == 0)
                 continue;
 
-            uint8_t* destData = Window.RecoveryData[matrixRowIndex_j].Data;
-            gf256_muladd_mem(destData, y, srcData, srcBytes);
+            uint8_t* destData = Window.RecoveryData[matrixRowIndex_j].Data + offset;
+            gf256_muladd_mem(destData, y, srcData, bytes);
         }
     }
 }
 
-FecalResult Decoder::BackSubstitution()
+void Decoder::BackSubstitution(unsigned offset, unsigned bytes)
 {
     const unsigned columns = static_cast<unsigned>(RecoveryMatrix.Columns.size());
-    const unsigned srcBytes = Window.SymbolBytes;
-
-    RecoveredData.resize(columns);
 
     // For each column starting with the right-most column:
     for (int col_i = columns - 1; col_i >= 0; --col_i)
     {
         const unsigned matrixRowIndex = RecoveryMatrix.Pivots[col_i];
-        uint8_t* recovery = Window.RecoveryData[matrixRowIndex].Data;
+        uint8_t* recovery = Window.RecoveryData[matrixRowIndex].Data + offset;
         const uint8_t y = RecoveryMatrix.Matrix.Get(matrixRowIndex, col_i);
         FECAL_DEBUG_ASSERT(y != 0);
         const unsigned originalColumn = RecoveryMatrix.Columns[col_i].Column;
+
+        // Skip the part of the range past the end of the original data
         const unsigned originalBytes = Window.GetColumnBytes(originalColumn);
+        if (offset >= originalBytes)
+            continue;
+        unsigned recoveryBytes = originalBytes - offset;
+        if (recoveryBytes > bytes)
+            recoveryBytes = bytes;
 
-        gf256_div_mem(recovery, recovery, y, originalBytes);
+        gf256_div_mem(recovery, recovery, y, recoveryBytes);
 
-        Window.OriginalData[originalColumn].Data = recovery;
+        // Eliminate from all other pivot rows above it:
+        for (unsigned col_j = 0; col_j < (unsigned)col_i; ++col_j)
+        {
+            unsigned pivot_j = RecoveryMatrix.Pivots[col_j];
+            const uint8_t x = RecoveryMatrix.Matrix.Get(pivot_j, col_i);
 
-        // Write recovered packet data
-        RecoveredData[col_i].Data = recovery;
-        RecoveredData[col_i].Bytes = originalBytes;
-        RecoveredData[col_i].Index = originalColumn;
+            if (x == 0)
+                continue;
+
+            gf256_muladd_mem(Window.RecoveryData[pivot_j].Data + offset, x, recovery, recoveryBytes);
+        }
+    }
+}
+
+void Decoder::InvertRecoveryMatrix()
+{
+    const unsigned columns = static_cast<unsigned>(RecoveryMatrix.Columns.size());
+    FECAL_DEBUG_ASSERT(LowerInverse.AllocatedColumns == UpperInverse.AllocatedColumns);
+
+    // Both triangles start from the identity
+    for (unsigned col_i = 0; col_i < columns; ++col_i)
+    {
+        uint8_t* lowerRow = LowerInverse.GetRow(col_i);
+        uint8_t* upperRow = UpperInverse.GetRow(col_i);
+        memset(lowerRow, 0, columns);
+        memset(upperRow, 0, columns);
+        lowerRow[col_i] = 1;
+        upperRow[col_i] = 1;
+    }
+
+    // Multiply lower triangle following solution order from left to right.
+    // Row i of the lower inverse is zero past column i
+    for (unsigned col_i = 0; col_i < columns - 1; ++col_i)
+    {
+        const uint8_t* srcRow = LowerInverse.GetRow(col_i);
+
+        for (unsigned col_j = col_i + 1; col_j < columns; ++col_j)
+        {
+            const unsigned matrixRowIndex_j = RecoveryMatrix.Pivots[col_j];
+            const uint8_t y = RecoveryMatrix.Matrix.Get(matrixRowIndex_j, col_i);
+
+            if (y == 0)
+                continue;
+
+            gf256_muladd_mem(LowerInverse.GetRow(col_j), y, srcRow, col_i + 1);
+        }
+    }
+
+    // Back-substitute upper triangle starting with the right-most column.
+    // Row i of the upper inverse is zero before column i
+    for (int col_i = columns - 1; col_i >= 0; --col_i)
+    {
+        const unsigned matrixRowIndex = RecoveryMatrix.Pivots[col_i];
+        uint8_t* srcRow = UpperInverse.GetRow(col_i);
+        const uint8_t y = RecoveryMatrix.Matrix.Get(matrixRowIndex, col_i);
+        FECAL_DEBUG_ASSERT(y != 0);
+
+        gf256_div_mem(srcRow, srcRow, y, columns);
 
         // Eliminate from all other pivot rows above it:
         for (unsigned col_j = 0; col_j < (unsigned)col_i; ++col_j)
         {
-            unsigned pivot_j = RecoveryMatrix.Pivots[col_j];
+            const unsigned pivot_j = RecoveryMatrix.Pivots[col_j];
             const uint8_t x = RecoveryMatrix.Matrix.Get(pivot_j, col_i);
 
             if (x == 0)
                 continue;
 
-            gf256_muladd_mem(Window.RecoveryData[pivot_j].Data, x, recovery, originalBytes);
+            gf256_muladd_mem(UpperInverse.GetRow(col_j), x, srcRow, columns);
         }
     }
+}
 
-    return Fecal_Success;
+void Decoder::ApplyRecoveryInverse(unsigned offset, unsigned bytes)
+{
+    const unsigned columns = static_cast<unsigned>(RecoveryMatrix.Columns.size());
+    const void* srcs[kInverseSources];
+
+    // Lower: Each row needs the rows before it, so go from the last row up
+    for (unsigned col_j = columns - 1; col_j > 0; --col_j)
+    {
+        const uint8_t* coefficients = LowerInverse.GetRow(col_j);
+        uint8_t* dest = Window.RecoveryData[RecoveryMatrix.Pivots[col_j]].Data + offset;
+
+        for (unsigned first = 0; first < col_j; first += kInverseSources)
+        {
+            unsigned count = col_j - first;
+            if (count > kInverseSources)
+                count = kInverseSources;
+
+            for (unsigned k = 0; k < count; ++k)
+                srcs[k] = Window.RecoveryData[RecoveryMatrix.Pivots[first + k]].Data + offset;
+
+            gf256_muladdn_mem(dest, coefficients + first, srcs, count, bytes);
+        }
+    }
+
+    // Upper: Each row needs the rows after it, so go from the first row down
+    for (unsigned col_i = 0; col_i < columns; ++col_i)
+    {
+        // Skip the part of the range past the end of the original data
+        const unsigned originalColumn = RecoveryMatrix.Columns[col_i].Column;
+        const unsigned originalBytes = Window.GetColumnBytes(originalColumn);
+        if (offset >= originalBytes)
+            continue;
+        unsigned recoveryBytes = originalBytes - offset;
+        if (recoveryBytes > bytes)
+            recoveryBytes = bytes;
+
+        const uint8_t* coefficients = UpperInverse.GetRow(col_i);
+        uint8_t* dest = Window.RecoveryData[RecoveryMatrix.Pivots[col_i]].Data + offset;
+
+        gf256_mul_mem(dest, dest, coefficients[col_i], recoveryBytes);
+
+        for (unsigned first = col_i + 1; first < columns; first += kInverseSources)
+        {
+            unsigned count = columns - first;
+            if (count > kInverseSources)
+                count = kInverseSources;
+
+            for (unsigned k = 0; k < count; ++k)
+                srcs[k] = Window.RecoveryData[RecoveryMatrix.Pivots[first + k]].Data + offset;
+
+            gf256_muladdn_mem(dest, coefficients + first, srcs, count, recoveryBytes);
+        }
+    }
+}
+
+void Decoder::RecoverSingleLoss(unsigned offset, unsigned bytes)
+{
+    const unsigned matrixRowIndex = RecoveryMatrix.Pivots[0];
+    uint8_t* recovery = Window.RecoveryData[matrixRowIndex].Data + offset;
+    const unsigned originalColumn = RecoveryMatrix.Columns[0].Column;
+
+    // Skip the part of the range past the end of the original data
+    const unsigned originalBytes = Window.GetColumnBytes(originalColumn);
+    if (offset >= originalBytes)
+        return;
+    unsigned recoveryBytes = originalBytes - offset;
+    if (recoveryBytes > bytes)
+        recoveryBytes = bytes;
+
+    gf256_div_mem(recovery, recovery, RecoveryMatrix.SingleLossValue, recoveryBytes);
+}
+
+void Decoder::StoreRecoveredData()
+{
+    const unsigned columns = static_cast<unsigned>(RecoveryMatrix.Columns.size());
+    RecoveredData.resize(columns);
+
+    for (unsigned col_i = 0; col_i < columns; ++col_i)
+    {
+        const unsigned matrixRowIndex = RecoveryMatrix.Pivots[col_i];
+        uint8_t* recovery = Window.RecoveryData[matrixRowIndex].Data;
+        const unsigned originalColumn = RecoveryMatrix.Columns[col_i].Column;
+
+        Window.OriginalData[originalColumn].Data = recovery;
+        Window.MarkGotElement(originalColumn);
+        ++Window.OriginalGotCount;
+
+        // The recovered length follows the recovered data, and is kept in
+        // bounds in case the recovery symbols did not match the originals
+        if (Window.IsVariableLength())
+        {
+            unsigned length = ReadLength(recovery + Window.SymbolBytes);
+            if (length <= 0 || length > Window.SymbolBytes)
+                length = Window.SymbolBytes;
+
+            Window.ColumnBytes[originalColumn] = length;
+            Lengths.Add(originalColumn, length);
+        }
+
+        // Write recovered packet data
+        RecoveredData[col_i].Data = recovery;
+        RecoveredData[col_i].Bytes = Window.GetColumnBytes(originalColumn);
+        RecoveredData[col_i].Index = originalColumn;
+    }
 }
 
 
 //------------------------------------------------------------------------------
 // RecoveryMatrixState
 
+void RecoveryMatrixState::Reset()
+{
+    Columns.clear();
+    Pivots.clear();
+    GEResumePivot = 0;
+    FilledRows = 0;
+    SingleLossSolved = false;
+    Matrix.Rows = 0;
+    Matrix.Columns = 0;
+}
+
 void RecoveryMatrixState::PopulateColumns(const unsigned columns)
 {
     Columns.resize(columns);
@@ -496,7 +1227,7 @@ bool RecoveryMatrixState::GenerateMatrix()
     const unsigned input_count = Window->InputCount;
     const unsigned columns = input_count - Window->OriginalGotCount;
     const unsigned rows = static_cast<unsigned>(Window->RecoveryData.size());
-    FECAL_DEBUG_ASSERT(rows >= columns);
+    FECAL_DEBUG_ASSERT(rows > 0 && columns > 0);
 
     // If column count changed:
     if (columns != (unsigned)Columns.size())
@@ -507,90 +1238,194 @@ bool RecoveryMatrixState::GenerateMatrix()
         Pivots.clear();
         GEResumePivot = 0;
         FilledRows = 0;
+        for (unsigned i = 0; i < rows; ++i)
+            Window->RecoveryData[i].UsedForSolution = false;
 
-        if (!Matrix.Initialize(rows, columns))
+        // A solution needs at least as many rows as columns
+        if (!Matrix.Initialize(rows, columns, columns))
+        {
+            Reset();
             return false;
+        }
     }
     else
     {
         // Otherwise we just added rows
         FECAL_DEBUG_ASSERT(FilledRows < rows);
         if (!Matrix.Resize(rows, columns))
+        {
+            Reset();
             return false;
+        }
     }
 
     const unsigned stride = Matrix.AllocatedColumns;
-    uint8_t* rowData = Matrix.Data + FilledRows * stride;
+    uint8_t* rowData = Matrix.GetRow(FilledRows);
 
     // For each row to fill:
     for (unsigned ii = FilledRows; ii < rows; ++ii, rowData += stride)
-    {
-        const unsigned row = Window->RecoveryData[ii].Row;
+        FillRow(Window->RecoveryData[ii].Row, rowData);
 
-        // Calculate row multiplier RX
-        const uint8_t RX = GetRowValue(row);
+    // Fill in revealed column pivots with their own value
+    Pivots.resize(rows);
+    for (unsigned i = FilledRows; i < rows; ++i)
+        Pivots[i] = i;
+
+    // If we have already performed some GE, then we need to eliminate new
+    // row data and we need to carry on elimination for new columns
+    if (GEResumePivot > 0)
+        ResumeGE(FilledRows, rows);
+
+    FilledRows = rows;
+
+    return true;
+}
+
+bool RecoveryMatrixState::SolveSingleLoss()
+{
+    const unsigned rows = static_cast<unsigned>(Window->RecoveryData.size());
+    FECAL_DEBUG_ASSERT(rows > 0 && Window->OriginalGotCount + 1 == Window->InputCount);
+
+    // Drop any matrix from a previous attempt with more lost columns
+    Reset();
+    PopulateColumns(1);
+
+    for (unsigned i = 0; i < rows; ++i)
+        Window->RecoveryData[i].UsedForSolution = false;
 
-        // Fill columns from left for new rows:
-        for (unsigned j = 0; j < columns; ++j)
+    // For each recovery row:
+    for (unsigned i = 0; i < rows; ++i)
+    {
+        uint8_t value;
+        FillRow(Window->RecoveryData[i].Row, &value);
+
+        if (value != 0)
         {
-            const unsigned column = Columns[j].Column;
+            Pivots.resize(1);
+            Pivots[0] = i;
+            Window->RecoveryData[i].UsedForSolution = true;
+            SingleLossValue = value;
+            SingleLossSolved = true;
+            return true;
+        }
+    }
 
-            // Generate opcode and parameters
-            const uint8_t CX = Columns[j].CX;
-            const uint8_t CX2 = gf256_sqr(CX);
-            const unsigned lane = column % kColumnLaneCount;
-            const unsigned opcode = GetRowOpcode(lane, row);
+    return false;
+}
+
+void RecoveryMatrixState::FillRow(const unsigned row, uint8_t* rowData) const
+{
+    const unsigned input_count = Window->InputCount;
+    const unsigned columns = static_cast<unsigned>(Columns.size());
 
-            unsigned value = opcode & 1;
-            if (opcode & 2)
-                value ^= CX;
-            if (opcode & 4)
-                value ^= CX2;
-            if (opcode & 8)
-                value ^= RX;
-            if (opcode & 16)
-                value ^= gf256_mul(CX, RX);
-            if (opcode & 32)
-                value ^= gf256_mul(CX2, RX);
-            rowData[j] = (uint8_t)value;
+    // Calculate row multiplier RX
+    const uint8_t RX = GetRowValue(row);
+
+    RowSchedule schedule;
+    schedule.Initialize(Window->RowCache, row, input_count, Window->RowScheme);
+
+    // Fill columns from left for new rows:
+    for (unsigned j = 0; j < columns; ++j)
+    {
+        const unsigned column = Columns[j].Column;
+
+        // Generate opcode and parameters
+        const uint8_t CX = Columns[j].CX;
+        const uint8_t CX2 = gf256_sqr(CX);
+        const unsigned lane = column % kColumnLaneCount;
+        const unsigned opcode = schedule.GetOpcode(lane);
+
+        unsigned value = opcode & 1;
+        if (opcode & 2)
+            value ^= CX;
+        if (opcode & 4)
+            value ^= CX2;
+        if (opcode & 8)
+            value ^= RX;
+        if (opcode & 16)
+            value ^= gf256_mul(CX, RX);
+        if (opcode & 32)
+            value ^= gf256_mul(CX2, RX);
+        rowData[j] = (uint8_t)value;
+    }
+
+    const unsigned pairCount = (input_count + kPairAddRate - 1) / kPairAddRate;
+
+    for (unsigned k = 0; k < pairCount; ++k)
+    {
+        const unsigned element1 = schedule.NextColumn();
+        if (!Window->OriginalData[element1].Data)
+        {
+            const unsigned matrixColumn = Window->OriginalData[element1].RecoveryMatrixColumn;
+            rowData[matrixColumn] ^= 1;
         }
 
-        PCGRandom prng;
-        prng.Seed(row, input_count);
+        const unsigned elementRX = schedule.NextColumn();
+        if (!Window->OriginalData[elementRX].Data)
+        {
+            const unsigned matrixColumn = Window->OriginalData[elementRX].RecoveryMatrixColumn;
+            rowData[matrixColumn] ^= RX;
+        }
+    } // for each pair of random columns
+}
 
-        const unsigned pairCount = (input_count + kPairAddRate - 1) / kPairAddRate;
+void RecoveryMatrixState::EliminateRowBlock(
+    const uint8_t* const* ge_rows, const unsigned pivotStart,
+    const unsigned pivotEnd, uint8_t* rem_row, const unsigned columnEnd)
+{
+    FECAL_DEBUG_ASSERT(pivotEnd - pivotStart <= kGEBlockPivots);
 
-        for (unsigned k = 0; k < pairCount; ++k)
+#ifdef FECAL_BLOCKED_GE
+    if (columnEnd - pivotEnd >= kGEBlockMinColumns)
+    {
+        // Columns up to here are updated one pivot at a time, since the block
+        // columns determine the multipliers for the following pivots
+        unsigned blockColumnEnd = pivotEnd;
+#ifdef GF256_ALIGNED_ACCESSES
+        blockColumnEnd = NextAlignedOffset(blockColumnEnd);
+        if (blockColumnEnd > columnEnd)
+            blockColumnEnd = columnEnd;
+#endif
+
+        uint8_t ys[kGEBlockPivots];
+        const void* srcs[kGEBlockPivots];
+        unsigned count = 0;
+
+        for (unsigned pivot_i = pivotStart; pivot_i < pivotEnd; ++pivot_i)
         {
-            const unsigned element1 = prng.Next() % input_count;
-            if (!Window->OriginalData[element1].Data)
-            {
-                const unsigned matrixColumn = Window->OriginalData[element1].RecoveryMatrixColumn;
-                rowData[matrixColumn] ^= 1;
-            }
+            // Skip if the element j,i is already zero
+            const uint8_t val_j = rem_row[pivot_i];
+            if (val_j == 0)
+                continue;
 
-            const unsigned elementRX = prng.Next() % input_count;
-            if (!Window->OriginalData[elementRX].Data)
-            {
-                const unsigned matrixColumn = Window->OriginalData[elementRX].RecoveryMatrixColumn;
-                rowData[matrixColumn] ^= RX;
-            }
-        } // for each pair of random columns
-    } // for each recovery row
+            // Calculate element j,i elimination constant based on pivot row value
+            const uint8_t* ge_row = ge_rows[pivot_i - pivotStart];
+            const uint8_t y = gf256_div(val_j, ge_row[pivot_i]);
 
-    // Fill in revealed column pivots with their own value
-    Pivots.resize(rows);
-    for (unsigned i = FilledRows; i < rows; ++i)
-        Pivots[i] = i;
+            // Remember what value was used to zero element j,i
+            rem_row[pivot_i] = y;
 
-    // If we have already performed some GE, then we need to eliminate new
-    // row data and we need to carry on elimination for new columns
-    if (GEResumePivot > 0)
-        ResumeGE(FilledRows, rows);
+            for (unsigned column = pivot_i + 1; column < blockColumnEnd; ++column)
+                rem_row[column] ^= gf256_mul(ge_row[column], y);
 
-    FilledRows = rows;
+            ys[count] = y;
+            srcs[count] = ge_row + blockColumnEnd;
+            ++count;
+        }
 
-    return true;
+        // Fold the rest of the pivot rows into the row in one pass
+        if (blockColumnEnd < columnEnd)
+            gf256_muladdn_mem(rem_row + blockColumnEnd, ys, srcs, count, columnEnd - blockColumnEnd);
+        return;
+    }
+#endif // FECAL_BLOCKED_GE
+
+    // Short rows are cheaper to eliminate one pivot at a time
+    for (unsigned pivot_i = pivotStart; pivot_i < pivotEnd; ++pivot_i)
+    {
+        const uint8_t* ge_row = ge_rows[pivot_i - pivotStart];
+        EliminateRow(ge_row, rem_row, pivot_i, columnEnd, ge_row[pivot_i]);
+    }
 }
 
 void RecoveryMatrixState::ResumeGE(const unsigned oldRows, const unsigned rows)
@@ -602,24 +1437,32 @@ void RecoveryMatrixState::ResumeGE(const unsigned oldRows, const unsigned rows)
         return;
     }
 
+    FECAL_STATS(++Stats->ResumeGECount);
+
     const unsigned stride = Matrix.AllocatedColumns;
     const unsigned columns = Matrix.Columns;
+    const uint8_t* ge_rows[kGEBlockPivots];
 
-    // For each pivot we have determined already:
-    for (unsigned pivot_i = 0; pivot_i < GEResumePivot; ++pivot_i)
+    // For each block of pivots we have determined already:
+    for (unsigned blockStart = 0; blockStart < GEResumePivot; blockStart += kGEBlockPivots)
     {
-        // Get the row for that pivot
-        const unsigned matrixRowIndex_i = Pivots[pivot_i];
-        const uint8_t* ge_row = Matrix.Data + stride * matrixRowIndex_i;
-        const uint8_t val_i = ge_row[pivot_i];
-        FECAL_DEBUG_ASSERT(val_i != 0);
+        unsigned blockEnd = blockStart + kGEBlockPivots;
+        if (blockEnd > GEResumePivot)
+            blockEnd = GEResumePivot;
 
-        uint8_t* rem_row = Matrix.Data + stride * oldRows;
+        // Get the rows for those pivots
+        for (unsigned pivot_i = blockStart; pivot_i < blockEnd; ++pivot_i)
+        {
+            ge_rows[pivot_i - blockStart] = Matrix.GetRow(Pivots[pivot_i]);
+            FECAL_DEBUG_ASSERT(ge_rows[pivot_i - blockStart][pivot_i] != 0);
+        }
+
+        uint8_t* rem_row = Matrix.GetRow(oldRows);
 
         // For each new row that was added:
         for (unsigned newRowIndex = oldRows; newRowIndex < rows; ++newRowIndex, rem_row += stride)
         {
-            EliminateRow(ge_row, rem_row, pivot_i, columns, val_i);
+            EliminateRowBlock(ge_rows, blockStart, blockEnd, rem_row, columns);
 
             FECAL_DEBUG_ASSERT(Pivots[newRowIndex] == newRowIndex);
         }
@@ -632,66 +1475,122 @@ bool RecoveryMatrixState::GaussianElimination()
     // since that requires extra memory operations.  Since the matrix will be dense we
     // have a good chance of going pretty far before we hit a zero
 
+    // Resume from the first pivot that was not found last time, which may be
+    // in a row that was just added
     if (GEResumePivot > 0)
-        return PivotedGaussianElimination(GEResumePivot);
+        return PivotedGaussianElimination(GEResumePivot, GEResumePivot);
 
     const unsigned columns = Matrix.Columns;
     const unsigned stride = Matrix.AllocatedColumns;
     const unsigned rows = Matrix.Rows;
-    uint8_t* ge_row = Matrix.Data;
+    const uint8_t* ge_rows[kGEBlockPivots];
 
-    for (unsigned pivot_i = 0; pivot_i < columns; ++pivot_i, ge_row += stride)
+    // For each block of pivots:
+    for (unsigned blockStart = 0; blockStart < columns; blockStart += kGEBlockPivots)
     {
-        const uint8_t val_i = ge_row[pivot_i];
-        if (val_i == 0)
-            return PivotedGaussianElimination(pivot_i);
+        unsigned blockEnd = blockStart + kGEBlockPivots;
+        if (blockEnd > columns)
+            blockEnd = columns;
+
+        // Bring each pivot row of the block up to date with the pivots before it
+        unsigned pivot_i = blockStart;
+        unsigned remainingRow = blockStart;
+        for (; pivot_i < blockEnd; ++pivot_i)
+        {
+            // If we ran out of rows before solving the matrix:
+            if (pivot_i >= rows)
+                break;
 
-        RecoveryInfo& rowInfo = Window->RecoveryData[pivot_i];
-        rowInfo.UsedForSolution = true;
+            uint8_t* ge_row = Matrix.GetRow(pivot_i);
+            EliminateRowBlock(ge_rows, blockStart, pivot_i, ge_row, columns);
+            remainingRow = pivot_i + 1;
 
-        uint8_t* rem_row = ge_row;
+            if (ge_row[pivot_i] == 0)
+                break;
+
+            RecoveryInfo& rowInfo = Window->RecoveryData[pivot_i];
+            rowInfo.UsedForSolution = true;
+
+            ge_rows[pivot_i - blockStart] = ge_row;
+        }
 
         // For each remaining row:
-        for (unsigned pivot_j = pivot_i + 1; pivot_j < rows; ++pivot_j)
+        uint8_t* rem_row = Matrix.GetRow(remainingRow);
+        for (unsigned pivot_j = remainingRow; pivot_j < rows; ++pivot_j, rem_row += stride)
+            EliminateRowBlock(ge_rows, blockStart, pivot_i, rem_row, columns);
+
+        if (pivot_i < blockEnd)
         {
-            rem_row += stride;
-            EliminateRow(ge_row, rem_row, pivot_i, columns, val_i);
+            if (pivot_i >= rows)
+            {
+                GEResumePivot = pivot_i;
+                return false;
+            }
+
+            return PivotedGaussianElimination(pivot_i, pivot_i + 1);
         }
     }
 
     return true;
 }
 
-bool RecoveryMatrixState::PivotedGaussianElimination(unsigned pivot_i)
+bool RecoveryMatrixState::PivotedGaussianElimination(unsigned pivot_i, unsigned pivot_j)
 {
     const unsigned columns = Matrix.Columns;
-    const unsigned stride = Matrix.AllocatedColumns;
     const unsigned rows = Matrix.Rows;
+    const uint8_t* ge_rows[kGEBlockPivots];
+
+    FECAL_STATS(++Stats->PivotedGECount);
 
-    // Resume from next row down...
-    // Note: This is designed to be called by the non-pivoted version
-    unsigned pivot_j = pivot_i + 1;
-    goto UsePivoting;
+    // Remaining rows have been eliminated by all of the pivots before this one.
+    // Within a block, rows are brought up to date only when searched or at the
+    // end of the block, so each row tracks how many pivots it has seen
+    RowProgress.resize(Matrix.AllocatedRows);
+    for (unsigned pivot_k = pivot_i; pivot_k < rows; ++pivot_k)
+        RowProgress[Pivots[pivot_k]] = pivot_i;
 
-    // For each pivot to determine:
-    for (; pivot_i < columns; ++pivot_i)
+    // For each block of pivots to determine:
+    for (unsigned blockStart = pivot_i; blockStart < columns; blockStart += kGEBlockPivots)
     {
-        pivot_j = pivot_i;
-UsePivoting:
-        for (; pivot_j < rows; ++pivot_j)
+        unsigned blockEnd = blockStart + kGEBlockPivots;
+        if (blockEnd > columns)
+            blockEnd = columns;
+
+        for (; pivot_i < blockEnd; ++pivot_i, pivot_j = pivot_i)
         {
-            const unsigned matrixRowIndex_j = Pivots[pivot_j];
-            const uint8_t* ge_row = Matrix.Data + stride * matrixRowIndex_j;
-            const uint8_t val_i = ge_row[pivot_i];
-            if (val_i == 0)
-                continue;
+            // Resume searching for the first pivot from the given row
+            for (; pivot_j < rows; ++pivot_j)
+            {
+                FECAL_STATS(++Stats->PivotRowsSearched);
+
+                const unsigned matrixRowIndex_j = Pivots[pivot_j];
+                uint8_t* rem_row = Matrix.GetRow(matrixRowIndex_j);
+
+                // Catch up on the pivots found so far in this block
+                const unsigned progress = RowProgress[matrixRowIndex_j];
+                if (progress < pivot_i)
+                {
+                    EliminateRowBlock(ge_rows + (progress - blockStart), progress, pivot_i, rem_row, columns);
+                    RowProgress[matrixRowIndex_j] = pivot_i;
+                }
+
+                if (rem_row[pivot_i] != 0)
+                    break;
+            }
+
+            // Remember where we failed last time
+            if (pivot_j >= rows)
+            {
+                GEResumePivot = pivot_i;
+                return false;
+            }
 
             // Swap out the pivot index for this one
+            const unsigned matrixRowIndex_j = Pivots[pivot_j];
             if (pivot_i != pivot_j)
             {
-                const unsigned temp = Pivots[pivot_i];
-                Pivots[pivot_i] = Pivots[pivot_j];
-                Pivots[pivot_j] = temp;
+                Pivots[pivot_j] = Pivots[pivot_i];
+                Pivots[pivot_i] = matrixRowIndex_j;
             }
 
             RecoveryInfo& rowInfo = Window->RecoveryData[matrixRowIndex_j];
@@ -701,23 +1600,21 @@ UsePivoting:
             if (pivot_i >= columns - 1)
                 return true;
 
-            // For each remaining row:
-            for (unsigned pivot_k = pivot_i + 1; pivot_k < rows; ++pivot_k)
-            {
-                const unsigned matrixRowIndex_k = Pivots[pivot_k];
-                uint8_t* rem_row = Matrix.Data + stride * matrixRowIndex_k;
+            ge_rows[pivot_i - blockStart] = Matrix.GetRow(matrixRowIndex_j);
+        }
 
-                EliminateRow(ge_row, rem_row, pivot_i, columns, val_i);
+        // Eliminate the block from rows that were not searched
+        for (unsigned pivot_k = blockEnd; pivot_k < rows; ++pivot_k)
+        {
+            const unsigned matrixRowIndex_k = Pivots[pivot_k];
+            const unsigned progress = RowProgress[matrixRowIndex_k];
+            if (progress < blockEnd)
+            {
+                uint8_t* rem_row = Matrix.GetRow(matrixRowIndex_k);
+                EliminateRowBlock(ge_rows + (progress - blockStart), progress, blockEnd, rem_row, columns);
+                RowProgress[matrixRowIndex_k] = blockEnd;
             }
-
-            goto NextPivot;
         }
-
-        // Remember where we failed last time
-        GEResumePivot = pivot_i;
-
-        return false;
-NextPivot:;
     }
 
     return true;
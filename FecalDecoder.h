@@ -81,25 +81,85 @@
     diagonal is eliminated by dividing each recovery packet by the diagonal.
     The recovery packets now contain original data.
 
+    Steps (4) and (5) operate on each byte of the symbols independently, so
+    they are performed over ranges of bytes that can run in parallel using an
+    executor provided by the application.  The sources eliminated from each
+    row are recorded once, and then all of the steps are run for one stripe
+    of kStripeBytes at a time so the working set stays in cache.
+
+    With the online decoding option, most of step (4) happens as data arrives.
+    Each original is added into the sums and eliminated from the recovery
+    packets received before it, and each recovery packet has the light sums of
+    the originals received before it eliminated.  Decoding then only has to
+    add the lane sums into the recovery packets used in the solution.
+
     The original data are prefixed by a length field so that the original data
     length can be recovered, since we support variable length input data.
 */
 
 #include "FecalCommon.h"
 
-#include <unordered_set>
-
 namespace fecal {
 
 
+//------------------------------------------------------------------------------
+// RowHashSet
+
+// Marks an unused slot in the RowHashSet table
+static const unsigned kRowEmptySlot = ~(unsigned)0;
+
+// Minimum number of slots to allocate in the RowHashSet table
+static const unsigned kRowMinSlots = 64;
+
+// Set of row numbers that uses open addressing in one table, so that it can be
+// cleared and filled again for the next input without allocating memory
+class RowHashSet
+{
+public:
+    // Remove all rows, keeping the allocated table
+    void Clear();
+
+    // Insert a row
+    // Returns false if the row is already in the set
+    bool Insert(unsigned row);
+
+protected:
+    // Table of rows, where the number of slots is a power of two
+    std::vector<unsigned> Slots;
+
+    // Number of rows in the table
+    unsigned Count = 0;
+
+    // Is kRowEmptySlot in the set?  It cannot be stored in the table
+    bool HasEmptySlotRow = false;
+
+
+    // Find the slot for the given row, which is either empty or contains it
+    unsigned FindSlot(unsigned row) const;
+
+    // Double the size of the table
+    void Grow();
+};
+
+
 //------------------------------------------------------------------------------
 // DecoderAppDataWindow
 
 struct RecoveryInfo
 {
+    // Buffer that recovery is performed in
     uint8_t* Data = nullptr;
+
+    // Recovery data as received, which is the same as Data unless the
+    // received data is read-only and must be copied before recovery
+    const uint8_t* ReceivedData = nullptr;
+
     unsigned Row = 0;
     bool UsedForSolution = false;
+
+    // Online decoding: Have the light sums of received originals been
+    // eliminated from Data as they arrived?
+    bool PairsEliminated = false;
 };
 
 struct OriginalInfo
@@ -134,15 +194,16 @@ struct DecoderAppDataWindow : AppDataWindow
     unsigned OriginalGotCount = 0;
 
     // Check if row has been seen yet
-    std::unordered_set<unsigned> RowSet;
+    RowHashSet RowSet;
 
 
-    // Allocate originals
+    // Allocate originals and clear any data received for previous input
     void AllocateOriginals();
 
     // Add symbol data
+    // readOnly: Data will be copied into a workspace before it is modified
     // Returns false if we already have the data
-    bool AddRecovery(uint8_t* data, unsigned row);
+    bool AddRecovery(const uint8_t* data, unsigned row, bool readOnly);
 
     // Add original data
     // Returns false if we already have the data
@@ -160,6 +221,21 @@ struct DecoderAppDataWindow : AppDataWindow
 //------------------------------------------------------------------------------
 // RecoveryMatrixState
 
+// Eliminate a block of pivots from each remaining row in one pass, folding
+// the columns past the block with a single multi-source muladd
+#define FECAL_BLOCKED_GE
+
+// Number of pivots eliminated together
+static const unsigned kGEBlockPivots = 8;
+
+// Rows with fewer columns past the block are eliminated one pivot at a time,
+// since the matrix then fits in cache and the block setup costs more than it saves
+static const unsigned kGEBlockMinColumns = 256;
+
+// Solve a single lost column directly from one recovery row, without
+// generating the recovery matrix or running GE
+#define FECAL_SINGLE_LOSS
+
 /*
     We maintain a GF(2^^8) byte matrix that can grow a little in rows and
     columns to reattempt solving with a larger matrix that includes more
@@ -195,25 +271,59 @@ public:
     // Pivot to resume at when we get more data
     unsigned GEResumePivot = 0;
 
+    // Number of pivots eliminated from each matrix row so far during pivoted GE
+    std::vector<unsigned> RowProgress;
+
     // Number of matrix rows we already filled
     unsigned FilledRows = 0;
 
+    // Single loss: Was the one lost column solved without the matrix?
+    bool SingleLossSolved = false;
+
+    // Single loss: Coefficient of the lost column in the pivot row
+    uint8_t SingleLossValue = 0;
+
+#ifdef FECAL_ENABLE_STATS
+    // Statistics owned by the decoder
+    FecalDecoderStats* Stats = nullptr;
+#endif // FECAL_ENABLE_STATS
+
+
+    // Clear the matrix for new input, keeping the allocated memory
+    void Reset();
 
     // Populate Rows and Columns arrays
     void PopulateColumns(const unsigned columns);
 
-    // Generate the matrix
+    // Generate the matrix, adding rows for new recovery data
+    // There may be fewer rows than columns
     bool GenerateMatrix();
 
+    // Single loss: Pick the first recovery row with a nonzero coefficient
+    // for the only lost column as the pivot
+    // Returns false if no row can solve for the column
+    bool SolveSingleLoss();
+
     // Attempt to put the matrix in upper-triangular form
+    // If this fails for lack of rows, it resumes where it left off next time
     bool GaussianElimination();
 
 protected:
     // Resume GE from a previous failure point
     void ResumeGE(const unsigned oldRows, const unsigned rows);
 
+    // Fill rowData[] with the coefficients of the lost Columns in a recovery row
+    void FillRow(const unsigned row, uint8_t* rowData) const;
+
     // Run GE with pivots after a column is found to be zero
-    bool PivotedGaussianElimination(unsigned pivot_i);
+    // pivot_j: First row to search for the next pivot
+    bool PivotedGaussianElimination(unsigned pivot_i, unsigned pivot_j);
+
+    // Eliminate pivots pivotStart..pivotEnd-1 from rem_row[] in order
+    // ge_rows: Row for each pivot, starting with pivotStart
+    void EliminateRowBlock(
+        const uint8_t* const* ge_rows, const unsigned pivotStart,
+        const unsigned pivotEnd, uint8_t* rem_row, const unsigned columnEnd);
 
     // rem_row[] += ge_row[] * y
     GF256_FORCE_INLINE void MulAddRows(
@@ -259,13 +369,45 @@ protected:
 //------------------------------------------------------------------------------
 // Decoder
 
+/*
+    Inverse recovery: Rather than running the lower triangle and back
+    substitution steps over the recovery data one row operation at a time,
+    the same steps are run on the identity matrix to get the inverses of the
+    lower and upper triangles.  Each recovery row is then updated in place
+    with one multi-source muladd pass per triangle:
+
+        Lower: For j = n-1 down to 1: R[j] += sum(i < j) Linv[j][i] * R[i]
+        Upper: For i = 0 up to n-1:   R[i] = sum(k >= i) Uinv[i][k] * R[k]
+
+    Going down through the lower triangle and up through the upper triangle
+    means each pass only reads rows it has not written yet.  The inverses
+    cost about n^3 / 3 byte operations, so this is only used when the
+    symbols are large compared to the matrix.
+*/
+#define FECAL_INVERSE_RECOVERY
+
+// Minimum number of recovered columns for inverse recovery
+static const unsigned kInverseMinColumns = 16;
+
+// Minimum symbol bytes per recovered column for inverse recovery
+static const unsigned kInverseMinBytesPerColumn = 16;
+
+// Number of recovery rows added to a row in each pass
+static const unsigned kInverseSources = 16;
+
 class Decoder : public ICodec
 {
 public:
     virtual ~Decoder() {}
 
     // Initialize the decoder
-    FecalResult Initialize(unsigned input_count, uint64_t total_bytes);
+    // This may be called again to reuse the decoder for new input data
+    // options: Optional decoder options, may be NULL to keep the current ones
+    FecalResult Initialize(unsigned input_count, uint64_t total_bytes, const FecalDecoderOptions* options = nullptr);
+
+    // Initialize the decoder for variable-length originals
+    // symbol_bytes: Number of bytes in the longest original
+    FecalResult InitializeVariable(unsigned input_count, unsigned symbol_bytes, const FecalDecoderOptions* options = nullptr);
 
     // Add original data
     FecalResult AddOriginal(const FecalSymbol& symbol);
@@ -279,37 +421,164 @@ public:
     // Get original data
     FecalResult GetOriginal(unsigned column, FecalSymbol& symbol);
 
+#ifdef FECAL_ENABLE_STATS
+    // Get the statistics collected since Initialize()
+    void GetStats(FecalDecoderStats& stats) const
+    {
+        stats = Stats;
+    }
+#endif // FECAL_ENABLE_STATS
+
 protected:
     // Window of original data
     DecoderAppDataWindow Window;
 
+    // Application executor for parallel work
+    FecalExecutor Executor = FecalExecutor();
+
+    // Are the received recovery buffers read-only?
+    bool ConstRecoveryData = false;
+
+    // Copies of read-only recovery data used in the solution
+    AlignedDataBuffer RecoveryArena;
+
+    // Eliminate original data from recovery data as it arrives?
+    bool OnlineDecode = false;
+
+    // Online decoding: Columns drawn by each writable recovery row, sorted.
+    // Entries are column * 2 for the sum, and column * 2 + 1 for the product
+    std::vector<unsigned> OnlineDraws;
+
+    // Online decoding: Sources eliminated from a recovery row as it arrives
+    SumSchedule OnlineSum;
+    SumSchedule OnlineProduct;
+
     // Matrix containing recovery packets that may admit a solution
     RecoveryMatrixState RecoveryMatrix;
 
     // Has recovery been attempted with the latest inputs?
     bool RecoveryAttempted = false;
 
+    // Online decoding: Did the solve in AddRecovery() fail with the latest inputs?
+    bool OnlineSolveFailed = false;
+
+    // Has the recovery matrix been solved with the latest inputs?
+    bool RecoveryMatrixSolved = false;
+
     // Recovered data array returned to application
     std::vector<FecalSymbol> RecoveredData;
 
+    // Inverse recovery: Are the originals recovered with the triangle inverses?
+    bool InverseRecovery = false;
+
+    // Inverse recovery: Inverses of the lower and upper triangles, in solution order
+    GrowingAlignedByteMatrix LowerInverse;
+    GrowingAlignedByteMatrix UpperInverse;
+
     // Sums for each lane
-    AlignedDataBuffer LaneSums[kColumnLaneCount][kColumnSumCount];
+    // Only the sums used by recovery rows in the solution are computed,
+    // unless online decoding is keeping all of them up to date
+    LaneSumSlab LaneSums;
 
-    // Output workspace
-    AlignedDataBuffer ProductWorkspace;
+    // Bitmask of the sums used by recovery rows in the solution for each lane
+    unsigned NeededLaneSums[kColumnLaneCount] = {};
 
+    // Lengths of the received originals in variable-length mode
+    ColumnLengths Lengths;
 
-    // Recovery step: Eliminate original data that was successfully received
-    FecalResult EliminateOriginalData();
 
-    // Get lane sum for original data we have
-    const uint8_t* GetLaneSum(unsigned laneIndex, unsigned sumIndex);
+    // Sources of the sum and product for each recovery row in the solution
+    std::vector<SumSchedule> RowSumSchedules;
+    std::vector<SumSchedule> RowProductSchedules;
+
+#ifdef FECAL_ENABLE_STATS
+    // Counters and stage timers returned by GetStats()
+    FecalDecoderStats Stats = FecalDecoderStats();
+
+    // Elimination and solution nanoseconds of each recovery task, added to
+    // Stats once all of the tasks have completed
+    std::vector<uint64_t> TaskNsec;
+#endif // FECAL_ENABLE_STATS
+
+
+    // Validate and keep the options, if any
+    FecalResult ApplyOptions(const FecalDecoderOptions* options);
+
+    // Allocate the originals and clear all state after the window parameters are set
+    FecalResult InitializeInput();
+
+    // Online decoding: Add original data to the lane sums and eliminate it
+    // from the recovery rows that were received before it
+    void OnlineAddOriginal(unsigned column, const uint8_t* data);
+
+    // Online decoding: Eliminate the light sums of received original data
+    // from the recovery row that was just received
+    void OnlineAddRecovery(unsigned recoveryIndex);
+
+    // Generate the recovery matrix with any new rows and try to solve it
+    FecalResult SolveRecoveryMatrix();
+
+    // Allocate the lane sums needed for the solution,
+    // and the copies of read-only recovery data that will be modified
+    FecalResult AllocateRecoveryWorkspace();
+
+    // Inverse recovery: Run the lower triangle and back substitution steps
+    // on the identity to fill LowerInverse and UpperInverse
+    void InvertRecoveryMatrix();
+
+    // Record the sources to eliminate from each recovery row in the solution
+    void ScheduleElimination();
+
+    // Record the received original data in the light sums of a recovery row
+    // draws: If not NULL, the drawn columns are written here as in OnlineDraws
+    void ScheduleLightElimination(const RecoveryInfo& recovery,
+        SumSchedule& sum, SumSchedule& prod, unsigned* draws);
+
+    // Parameters for RecoveryTask()
+    struct RecoveryTaskContext
+    {
+        Decoder* Codec;
+        unsigned StripeBytes;
+    };
+
+    // Parallel task: Run all of the recovery steps for one range of bytes
+    static void RecoveryTask(void* context, unsigned taskIndex);
+
+    // Recovery step: Copy read-only recovery data into the arena
+    void CopyReceivedData(unsigned offset, unsigned bytes);
+
+    // Recovery step: Compute needed lane sums over the given range of bytes
+    void ComputeLaneSums(unsigned laneIndex, unsigned offset, unsigned bytes);
+
+    // Recovery step: Eliminate original data that was successfully received
+    void EliminateOriginalData(unsigned offset, unsigned bytes);
 
     // Recovery step: Multiply lower triangle following solution order
-    void MultiplyLowerTriangle();
+    void MultiplyLowerTriangle(unsigned offset, unsigned bytes);
 
     // Recovery step: Back-substitute upper triangle to reveal original data
-    FecalResult BackSubstitution();
+    void BackSubstitution(unsigned offset, unsigned bytes);
+
+    // Recovery step: Multiply the recovery data by the triangle inverses in place
+    void ApplyRecoveryInverse(unsigned offset, unsigned bytes);
+
+    // Recovery step: Divide the one pivot row by its coefficient for a single loss
+    void RecoverSingleLoss(unsigned offset, unsigned bytes);
+
+    // Recovery step: Solve for the lost data once the received data is eliminated
+    void SolveLostData(unsigned offset, unsigned bytes);
+
+    // Variable-length mode: Recover the lengths from the end of the recovery symbols
+    void RecoverLengths();
+
+    // Point the original data at the recovered data and fill RecoveredData,
+    // marking the recovered originals as received
+    void StoreRecoveredData();
+
+#ifdef FECAL_ENABLE_STATS
+    // Add the bytes that the scheduled recovery steps will read to Stats
+    void CountRecoveryBytes();
+#endif // FECAL_ENABLE_STATS
 };
 
 
@@ -52,11 +52,14 @@ void EncoderAppDataWindow::SetEncoderInput(void* const * const input_data)
 // Encoder
 
 // This optimization speeds up encoding by about 5%
-#ifdef FECAL_ADD2_OPT
+#ifdef FECAL_ADDN_OPT
 #define FECAL_ADD2_ENC_SETUP_OPT
 #endif
 
-FecalResult Encoder::Initialize(unsigned input_count, void* const * const input_data, uint64_t total_bytes)
+// Bitmask of all the sums in a lane
+static const unsigned kAllLaneSums = (1 << kColumnSumCount) - 1;
+
+FecalResult Encoder::Initialize(unsigned input_count, void* const * const input_data, uint64_t total_bytes, const FecalEncoderOptions* options)
 {
     // Validate input and set parameters
     if (!Window.SetParameters(input_count, total_bytes))
@@ -64,181 +67,748 @@ FecalResult Encoder::Initialize(unsigned input_count, void* const * const input_
         FECAL_DEBUG_BREAK; // Invalid input
         return Fecal_InvalidInput;
     }
+
+    return InitializeInput(input_data, options);
+}
+
+FecalResult Encoder::InitializeVariable(unsigned input_count, void* const * const input_data, const unsigned* input_bytes, const FecalEncoderOptions* options)
+{
+    if (!input_bytes)
+    {
+        FECAL_DEBUG_BREAK; // Invalid input
+        return Fecal_InvalidInput;
+    }
+
+    // The recovery symbols are as long as the longest original
+    unsigned symbolBytes = 0;
+    for (unsigned column = 0; column < input_count; ++column)
+        if (symbolBytes < input_bytes[column])
+            symbolBytes = input_bytes[column];
+
+    // Validate input and set parameters
+    if (!Window.SetVariableParameters(input_count, symbolBytes, input_bytes))
+    {
+        FECAL_DEBUG_BREAK; // Invalid input
+        return Fecal_InvalidInput;
+    }
+
+    Lengths.Reset(input_count);
+    for (unsigned column = 0; column < input_count; ++column)
+        Lengths.Add(column, input_bytes[column]);
+
+    return InitializeInput(input_data, options);
+}
+
+FecalResult Encoder::InitializeInput(void* const * const input_data, const FecalEncoderOptions* options)
+{
     Window.AllocateOriginals();
-    Window.SetEncoderInput(input_data);
+    if (input_data)
+        Window.SetEncoderInput(input_data);
+    else
+        std::fill(Window.OriginalData.begin(), Window.OriginalData.end(), nullptr);
+
+    if (options)
+    {
+        if (static_cast<unsigned>(options->RowScheme) >= Fecal_RowScheme_Count)
+        {
+            FECAL_DEBUG_BREAK; // Invalid input
+            return Fecal_InvalidInput;
+        }
+
+        Executor = options->Executor;
+        LazyLaneSums = options->LazyLaneSums != 0;
+        Backend = options->Backend;
+        Window.RowCache = reinterpret_cast<const RowScheduleCache*>( options->RowCache );
+        Window.RowScheme = options->RowScheme;
+    }
 
     const unsigned symbolBytes = Window.SymbolBytes;
 
     // Allocate lane sums
+    if (!LaneSums.Allocate(symbolBytes))
+        return Fecal_OutOfMemory;
+
+    BackendLaneSumsValid = false;
+    if (Backend.LaneSums || Backend.EncodeRows)
+    {
+        const FecalResult result = InitializeBackend();
+        if (result != Fecal_Success)
+            return result;
+    }
+
+    // Without input data, the sums are built up as each original is added
+    if (!input_data)
+    {
+        LaneSums.Clear();
+        for (unsigned laneIndex = 0; laneIndex < kColumnLaneCount; ++laneIndex)
+            ComputedLaneSums[laneIndex] = kAllLaneSums;
+        OriginalAddedCount = 0;
+        return Fecal_Success;
+    }
+    OriginalAddedCount = Window.InputCount;
+
+    for (unsigned laneIndex = 0; laneIndex < kColumnLaneCount; ++laneIndex)
+        ComputedLaneSums[laneIndex] = 0;
+
+    // A backend computes all of the sums up front
+    if (Backend.LaneSums && ComputeBackendLaneSums())
+        return Fecal_Success;
+
+    // Without an executor, the sums can be computed by the encode calls as needed
+    if (LazyLaneSums && !Executor.ParallelFor)
+        return Fecal_Success;
+
+    // Each lane is independent, and each lane can also be split into byte
+    // ranges for an executor to work on in parallel
+    LaneSumTaskContext context;
+    context.Codec = this;
+    context.StripeBytes = GetParallelRangeBytes(Executor, symbolBytes, kColumnLaneCount);
+    context.StripeCount = (symbolBytes + context.StripeBytes - 1) / context.StripeBytes;
+
+    RunParallelTasks(
+        Executor,
+        kColumnLaneCount * context.StripeCount,
+        &Encoder::LaneSumTask,
+        &context);
+
+    for (unsigned laneIndex = 0; laneIndex < kColumnLaneCount; ++laneIndex)
+        ComputedLaneSums[laneIndex] = kAllLaneSums;
+
+    return Fecal_Success;
+}
+
+FecalResult Encoder::AddOriginal(const FecalSymbol& symbol)
+{
+    // If encoder is not initialized:
+    if (!LaneSums.Buffer.Data)
+        return Fecal_InvalidInput;
+
+    const unsigned column = symbol.Index;
+    if (column >= Window.InputCount ||
+        symbol.Data == nullptr ||
+        symbol.Bytes != Window.GetColumnBytes(column))
+    {
+        FECAL_DEBUG_BREAK; // Invalid input
+        return Fecal_InvalidInput;
+    }
+
+    // If we already have the data:
+    if (Window.OriginalData[column])
+        return Fecal_Success;
+
+    const uint8_t* data = reinterpret_cast<const uint8_t*>( symbol.Data );
+    Window.OriginalData[column] = data;
+    ++OriginalAddedCount;
+    BackendLaneSumsValid = false;
+
+    const unsigned laneIndex = column % kColumnLaneCount;
+    const uint8_t CX = GetColumnValue(column);
+
+    // Sum[0] += Data, Sum[1] += CX * Data, Sum[2] += CX^2 * Data
+    LaneSums.MulAdd(laneIndex, 0, 1, data, symbol.Bytes);
+    LaneSums.MulAdd(laneIndex, 1, CX, data, symbol.Bytes);
+    LaneSums.MulAdd(laneIndex, 2, gf256_sqr(CX), data, symbol.Bytes);
+
+    static_assert(kColumnSumCount == 3, "Update this");
+
+    return Fecal_Success;
+}
+
+static_assert(kLaneSumCount == FECAL_LANE_SUM_COUNT, "Update fecal.h");
+
+FecalResult Encoder::InitializeBackend()
+{
+    const unsigned inputCount = Window.InputCount;
+    const unsigned symbolBytes = Window.SymbolBytes;
+
+    // Allocate contiguous lane sums for the backend
+    BackendLaneSumStride = NextAlignedOffset(symbolBytes);
+    if (!BackendLaneSums.Allocate(static_cast<uint64_t>(BackendLaneSumStride) * kLaneSumCount))
+        return Fecal_OutOfMemory;
+
+    BackendData.resize(inputCount + kLaneSumCount);
+    BackendBytes.resize(inputCount + kLaneSumCount);
+    BackendColumnValues.resize(inputCount);
+
+    for (unsigned column = 0; column < inputCount; ++column)
+    {
+        BackendBytes[column] = Window.GetColumnBytes(column);
+        BackendColumnValues[column] = GetColumnValue(column);
+    }
+
+    // Lane sum (laneIndex, sumIndex) is source inputCount + laneIndex * kColumnSumCount + sumIndex
+    for (unsigned i = 0; i < kLaneSumCount; ++i)
+    {
+        BackendData[inputCount + i] = BackendLaneSums.Data + static_cast<size_t>(i) * BackendLaneSumStride;
+        BackendBytes[inputCount + i] = symbolBytes;
+    }
+
+    return Fecal_Success;
+}
+
+void Encoder::GetBackendSources(FecalBackendSources& sources)
+{
+    const unsigned inputCount = Window.InputCount;
+
+    // Originals may have been added since the last call
+    std::copy(Window.OriginalData.begin(), Window.OriginalData.end(), BackendData.begin());
+
+    sources.InputCount = inputCount;
+    sources.SymbolBytes = Window.SymbolBytes;
+    sources.SourceCount = inputCount + kLaneSumCount;
+    sources.Data = &BackendData[0];
+    sources.Bytes = &BackendBytes[0];
+    sources.ColumnValues = &BackendColumnValues[0];
+}
+
+bool Encoder::ComputeBackendLaneSums()
+{
+    FecalBackendSources sources;
+    GetBackendSources(sources);
+
+    uint8_t* laneSums[kLaneSumCount];
+    for (unsigned i = 0; i < kLaneSumCount; ++i)
+        laneSums[i] = BackendLaneSums.Data + static_cast<size_t>(i) * BackendLaneSumStride;
+
+    if (0 != Backend.LaneSums(Backend.Context, &sources, laneSums))
+        return false;
+
+    // Copy the sums into the slab for the CPU paths
     for (unsigned laneIndex = 0; laneIndex < kColumnLaneCount; ++laneIndex)
     {
         for (unsigned sumIndex = 0; sumIndex < kColumnSumCount; ++sumIndex)
+            LaneSums.Load(laneIndex, sumIndex, laneSums[laneIndex * kColumnSumCount + sumIndex]);
+        ComputedLaneSums[laneIndex] = kAllLaneSums;
+    }
+
+    BackendLaneSumsValid = true;
+    return true;
+}
+
+bool Encoder::EncodeBackendRows(unsigned firstRow, unsigned count, FecalSymbol* symbols)
+{
+    // Rows may select any of the sums, so they must all be ready
+    unsigned allOpcodes[kColumnLaneCount];
+    for (unsigned laneIndex = 0; laneIndex < kColumnLaneCount; ++laneIndex)
+        allOpcodes[laneIndex] = kAllLaneSums;
+    ComputeSelectedLaneSums(allOpcodes);
+
+    // Copy the sums out of the slab if they were computed on the CPU
+    if (!BackendLaneSumsValid)
+    {
+        for (unsigned laneIndex = 0; laneIndex < kColumnLaneCount; ++laneIndex)
+            for (unsigned sumIndex = 0; sumIndex < kColumnSumCount; ++sumIndex)
+            {
+                const unsigned i = laneIndex * kColumnSumCount + sumIndex;
+                LaneSums.Store(laneIndex, sumIndex, BackendLaneSums.Data + static_cast<size_t>(i) * BackendLaneSumStride);
+            }
+        BackendLaneSumsValid = true;
+    }
+
+    const unsigned inputCount = Window.InputCount;
+    const unsigned pairCount = (inputCount + kPairAddRate - 1) / kPairAddRate;
+
+    // Each of the sum and product takes one column per pair and up to one
+    // lane sum per lane and sum index
+    const unsigned listCount = pairCount + kLaneSumCount;
+    BackendSourceList.resize(static_cast<size_t>(listCount) * 2 * count);
+    BackendRows.resize(count);
+
+    for (unsigned i = 0; i < count; ++i)
+    {
+        const unsigned row = firstRow + i;
+
+        RowSchedule schedule;
+        schedule.Initialize(Window.RowCache, row, inputCount, Window.RowScheme);
+
+        unsigned* sumSources = &BackendSourceList[static_cast<size_t>(listCount) * 2 * i];
+        unsigned* productSources = sumSources + listCount;
+        unsigned sumCount = 0, productCount = 0;
+
+        // Same column order as Encode()
+        for (unsigned j = 0; j < pairCount; ++j)
         {
-            if (!LaneSums[laneIndex][sumIndex].Allocate(symbolBytes))
-                return Fecal_OutOfMemory;
+            sumSources[sumCount++] = schedule.NextColumn();
+            productSources[productCount++] = schedule.NextColumn();
+        }
 
-            // Clear memory in each lane sum
-            memset(LaneSums[laneIndex][sumIndex].Data, 0, symbolBytes);
+        for (unsigned laneIndex = 0; laneIndex < kColumnLaneCount; ++laneIndex)
+        {
+            const unsigned opcode = schedule.GetOpcode(laneIndex);
+            const unsigned laneSource = inputCount + laneIndex * kColumnSumCount;
+
+            unsigned mask = 1;
+            for (unsigned sumIndex = 0; sumIndex < kColumnSumCount; ++sumIndex, mask <<= 1)
+                if (opcode & mask)
+                    sumSources[sumCount++] = laneSource + sumIndex;
+
+            for (unsigned sumIndex = 0; sumIndex < kColumnSumCount; ++sumIndex, mask <<= 1)
+                if (opcode & mask)
+                    productSources[productCount++] = laneSource + sumIndex;
         }
+
+        FecalBackendRow& backendRow = BackendRows[i];
+        backendRow.Output = symbols[i].Data;
+        backendRow.RX = GetRowValue(row);
+        backendRow.SumSources = sumSources;
+        backendRow.SumCount = sumCount;
+        backendRow.ProductSources = productSources;
+        backendRow.ProductCount = productCount;
     }
 
-    // Allocate workspace
-    if (!ProductWorkspace.Allocate(symbolBytes))
-        return Fecal_OutOfMemory;
+    FecalBackendSources sources;
+    GetBackendSources(sources);
 
-    // TBD: Unroll first set of 8 lanes to avoid the extra memset above?
-    // TBD: Use GetLaneSum() approach do to minimal work for small output?
+    if (0 != Backend.EncodeRows(Backend.Context, &sources, &BackendRows[0], count))
+        return false;
 
-#ifdef FECAL_ADD2_ENC_SETUP_OPT
-    for (unsigned laneIndex = 0; laneIndex < kColumnLaneCount; ++laneIndex)
+    // Append the coded lengths of the originals
+    if (Window.IsVariableLength())
     {
-        // Sum[0] += Data
-        XORSummer sum;
-        sum.Initialize(LaneSums[laneIndex][0].Data, symbolBytes);
+        for (unsigned i = 0; i < count; ++i)
+        {
+            uint8_t* outputLength = reinterpret_cast<uint8_t*>(symbols[i].Data) + Window.SymbolBytes;
+            WriteLength(outputLength, Lengths.EncodeRow(Window, firstRow + i));
+        }
+    }
+
+    return true;
+}
+
+void Encoder::LaneSumTask(void* context_v, unsigned taskIndex)
+{
+    const LaneSumTaskContext* context = reinterpret_cast<const LaneSumTaskContext*>( context_v );
+    Encoder* encoder = context->Codec;
+
+    const unsigned laneIndex = taskIndex % kColumnLaneCount;
+    const unsigned offset = (taskIndex / kColumnLaneCount) * context->StripeBytes;
 
-        const unsigned columnEnd = input_count - 1;
+    unsigned rangeEnd = offset + context->StripeBytes;
+    if (rangeEnd > encoder->Window.SymbolBytes)
+        rangeEnd = encoder->Window.SymbolBytes;
+
+    // Work on one stripe at a time so the sums stay in cache across columns
+    for (unsigned stripe = offset; stripe < rangeEnd;)
+    {
+        const unsigned bytes = GetStripeBytes(stripe, rangeEnd - stripe);
+
+        encoder->ComputeLaneSums(laneIndex, kAllLaneSums, stripe, bytes);
+
+        stripe += bytes;
+    }
+}
+
+void Encoder::ComputeSelectedLaneSums(const unsigned* opcodes)
+{
+    const unsigned symbolBytes = Window.SymbolBytes;
 
-        for (unsigned column = laneIndex; column < columnEnd; column += kColumnLaneCount)
+    // For each lane:
+    for (unsigned laneIndex = 0; laneIndex < kColumnLaneCount; ++laneIndex)
+    {
+        // Opcode bits select sums for the sum and then for the product
+        const unsigned opcode = opcodes[laneIndex];
+        const unsigned selected = (opcode | (opcode >> kColumnSumCount)) & kAllLaneSums;
+        unsigned missing = selected & ~ComputedLaneSums[laneIndex];
+        if (missing == 0)
+            continue;
+
+        // Once a second row needs more sums from a lane, more rows are likely
+        // to follow, so finish the lane to avoid reading its data again
+        if (ComputedLaneSums[laneIndex] != 0)
+            missing = kAllLaneSums & ~ComputedLaneSums[laneIndex];
+
+        for (unsigned offset = 0; offset < symbolBytes;)
         {
-            const uint8_t* columnData = reinterpret_cast<const uint8_t*>(input_data[column]);
-            sum.Add(columnData);
+            const unsigned bytes = GetStripeBytes(offset, symbolBytes - offset);
+            ComputeLaneSums(laneIndex, missing, offset, bytes);
+            offset += bytes;
         }
 
-        if ((columnEnd % kColumnLaneCount) == laneIndex)
+        ComputedLaneSums[laneIndex] |= missing;
+    }
+}
+
+void Encoder::ComputeLaneSums(unsigned laneIndex, unsigned sums, unsigned offset, unsigned bytes)
+{
+    uint8_t* sum0 = (sums & 1) ? LaneSums.Get(laneIndex, 0, offset) : nullptr;
+    uint8_t* sum1 = (sums & 2) ? LaneSums.Get(laneIndex, 1, offset) : nullptr;
+    uint8_t* sum2 = (sums & 4) ? LaneSums.Get(laneIndex, 2, offset) : nullptr;
+
+    // TBD: Unroll first set of columns to avoid the extra memset?
+    if (sum0)
+        memset(sum0, 0, bytes);
+    if (sum1)
+        memset(sum1, 0, bytes);
+    if (sum2)
+        memset(sum2, 0, bytes);
+
+    const unsigned inputCount = Window.InputCount;
+
+#ifdef FECAL_ADD2_ENC_SETUP_OPT
+    if (sum0)
+    {
+        // Sum[0] += Data
+        XORSummer sum;
+        sum.Initialize(sum0, bytes);
+
+        // Columns that end within this range are added on their own
+        for (unsigned column = laneIndex; column < inputCount; column += kColumnLaneCount)
         {
-            const uint8_t* columnData = reinterpret_cast<const uint8_t*>(input_data[columnEnd]);
-            gf256_add_mem(LaneSums[laneIndex][0].Data, columnData, Window.FinalBytes);
+            const unsigned columnBytes = Window.GetColumnBytesInRange(column, offset, bytes);
+            if (columnBytes >= bytes)
+                sum.Add(Window.OriginalData[column] + offset);
+            else if (columnBytes > 0)
+                gf256_add_mem(sum0, Window.OriginalData[column] + offset, columnBytes);
         }
 
         sum.Finalize();
     }
+
+    if (!sum1 && !sum2)
+        return;
 #endif
 
-    // For each input column:
-    for (unsigned column = 0; column < input_count; ++column)
+    // For each input column in this lane:
+    for (unsigned column = laneIndex; column < inputCount; column += kColumnLaneCount)
     {
-        const uint8_t* columnData = reinterpret_cast<const uint8_t*>(input_data[column]);
-        const unsigned columnBytes = Window.GetColumnBytes(column);
-        const unsigned laneIndex = column % kColumnLaneCount;
+        const unsigned columnBytes = Window.GetColumnBytesInRange(column, offset, bytes);
+        if (columnBytes <= 0)
+            continue;
+
+        const uint8_t* columnData = Window.OriginalData[column] + offset;
         const uint8_t CX = GetColumnValue(column);
         const uint8_t CX2 = gf256_sqr(CX);
 
 #ifndef FECAL_ADD2_ENC_SETUP_OPT
         // Sum[0] += Data
-        gf256_add_mem(LaneSums[laneIndex][0].Data, columnData, columnBytes);
+        if (sum0)
+            gf256_add_mem(sum0, columnData, columnBytes);
 #endif
 
         // Sum[1] += CX * Data
-        gf256_muladd_mem(LaneSums[laneIndex][1].Data, CX, columnData, columnBytes);
+        if (sum1)
+            gf256_muladd_mem(sum1, CX, columnData, columnBytes);
 
         // Sum[2] += CX^2 * Data
-        gf256_muladd_mem(LaneSums[laneIndex][2].Data, CX2, columnData, columnBytes);
+        if (sum2)
+            gf256_muladd_mem(sum2, CX2, columnData, columnBytes);
     }
 
-    return Fecal_Success;
-
     static_assert(kColumnSumCount == 3, "Update this");
 }
 
 FecalResult Encoder::Encode(FecalSymbol& symbol)
 {
     // If encoder is not initialized:
-    if (!ProductWorkspace.Data)
+    if (!LaneSums.Buffer.Data)
         return Fecal_InvalidInput;
 
     const unsigned symbolBytes = Window.SymbolBytes;
-    if (symbol.Bytes != symbolBytes)
+    if (symbol.Bytes != Window.RecoveryBytes)
         return Fecal_InvalidInput;
 
+    // If some originals have not been added yet:
+    if (OriginalAddedCount < Window.InputCount)
+        return Fecal_NeedMoreData;
+
+    // Offload to the backend if the application provided one
+    if (Backend.EncodeRows && EncodeBackendRows(symbol.Index, 1, &symbol))
+        return Fecal_Success;
+
     // Load parameters
     const unsigned count = Window.InputCount;
     uint8_t* outputSum = reinterpret_cast<uint8_t*>( symbol.Data );
-    uint8_t* outputProduct = ProductWorkspace.Data;
 
     const unsigned row = symbol.Index;
 
+    // Record the sources of the two sums, to replay for each stripe
+    SumSchedule& sum = EncodeSumSchedule;
+    SumSchedule& prod = EncodeProductSchedule;
+    sum.Clear();
+    prod.Clear();
+
     // Initialize LDPC
-    PCGRandom prng;
-    prng.Seed(row, count);
+    RowSchedule schedule;
+    schedule.Initialize(Window.RowCache, row, count, Window.RowScheme);
 
     // Accumulate original data into the two sums
     const unsigned pairCount = (Window.InputCount + kPairAddRate - 1) / kPairAddRate;
-    // Unrolled first loop:
-    {
-        const unsigned element1 = prng.Next() % count;
-        const uint8_t* original1 = Window.OriginalData[element1];
-
-        const unsigned elementRX = prng.Next() % count;
-        const uint8_t* originalRX = Window.OriginalData[elementRX];
-
-        // Sum = Original[element1]
-        if (Window.IsFinalColumn(element1))
-        {
-            memcpy(outputSum, original1, Window.FinalBytes);
-            memset(outputSum + Window.FinalBytes, 0, symbolBytes - Window.FinalBytes);
-        }
-        else
-            memcpy(outputSum, original1, symbolBytes);
-
-        // Product = Original[elementRX]
-        if (Window.IsFinalColumn(elementRX))
-        {
-            memcpy(outputProduct, originalRX, Window.FinalBytes);
-            memset(outputProduct + Window.FinalBytes, 0, symbolBytes - Window.FinalBytes);
-        }
-        else
-            memcpy(outputProduct, originalRX, symbolBytes);
-    }
-
-    XORSummer sum;
-    sum.Initialize(outputSum, symbolBytes);
-    XORSummer prod;
-    prod.Initialize(outputProduct, symbolBytes);
-
-    for (unsigned i = 1; i < pairCount; ++i)
+    for (unsigned i = 0; i < pairCount; ++i)
     {
-        const unsigned element1   = prng.Next() % count;
+        const unsigned element1   = schedule.NextColumn();
         const uint8_t* original1  = Window.OriginalData[element1];
 
-        const unsigned elementRX  = prng.Next() % count;
+        const unsigned elementRX  = schedule.NextColumn();
         const uint8_t* originalRX = Window.OriginalData[elementRX];
 
         // Sum += Original[element1]
-        if (Window.IsFinalColumn(element1))
-            gf256_add_mem(outputSum, original1, Window.FinalBytes);
+        const unsigned bytes1 = Window.GetColumnBytes(element1);
+        if (bytes1 < symbolBytes)
+            sum.AddPartial(original1, bytes1);
         else
             sum.Add(original1);
 
         // Product += Original[elementRX]
-        if (Window.IsFinalColumn(elementRX))
-            gf256_add_mem(outputProduct, originalRX, Window.FinalBytes);
+        const unsigned bytesRX = Window.GetColumnBytes(elementRX);
+        if (bytesRX < symbolBytes)
+            prod.AddPartial(originalRX, bytesRX);
         else
             prod.Add(originalRX);
     }
 
+    // Compute the operations to run for each lane for this row
+    unsigned opcodes[kColumnLaneCount];
+    for (unsigned laneIndex = 0; laneIndex < kColumnLaneCount; ++laneIndex)
+        opcodes[laneIndex] = schedule.GetOpcode(laneIndex);
+
+    ComputeSelectedLaneSums(opcodes);
+
     // For each lane:
     for (unsigned laneIndex = 0; laneIndex < kColumnLaneCount; ++laneIndex)
     {
-        // Compute the operations to run for this lane and row
-        unsigned opcode = GetRowOpcode(laneIndex, row);
+        const unsigned opcode = opcodes[laneIndex];
 
         // Sum += Random Lanes
         unsigned mask = 1;
         for (unsigned sumIndex = 0; sumIndex < kColumnSumCount; ++sumIndex, mask <<= 1)
             if (opcode & mask)
-                sum.Add(LaneSums[laneIndex][sumIndex].Data);
+                sum.AddLaneSum(LaneSums, laneIndex, sumIndex);
 
         // Product += Random Lanes
         for (unsigned sumIndex = 0; sumIndex < kColumnSumCount; ++sumIndex, mask <<= 1)
             if (opcode & mask)
-                prod.Add(LaneSums[laneIndex][sumIndex].Data);
+                prod.AddLaneSum(LaneSums, laneIndex, sumIndex);
     }
 
-    sum.Finalize();
-    prod.Finalize();
+    const uint8_t RX = GetRowValue(row);
+
+    // Output = Sum + RX * Product
+    sum.StoreWithProduct(outputSum, RX, prod, 0, symbolBytes);
+
+    // Append the coded lengths of the originals
+    if (Window.IsVariableLength())
+        WriteLength(outputSum + symbolBytes, Lengths.EncodeRow(Window, row));
+
+    return Fecal_Success;
+}
 
-    // Sum += RX * Product
-    gf256_muladd_mem(outputSum, GetRowValue(row), outputProduct, symbolBytes);
+
+
+/*
+    Batch encoding
+
+    For a batch of rows, each original column is added into about
+    2 * count / kPairAddRate of the outputs.  Rather than streaming the
+    originals through the cache once per output, the random columns for all
+    rows are drawn up front and sorted by column.  The symbols are then split
+    into tiles sized so that one tile of every output and product sum stays
+    in cache, and each tile of original data is visited exactly once.
+*/
+
+// Target number of bytes of output tiles kept hot in L2 cache during a batch
+static const unsigned kBatchWorkingSetBytes = 512 * 1024;
+
+// Minimum tile size, to amortize the per-tile overhead
+static const unsigned kBatchMinTileBytes = 64;
+
+FecalResult Encoder::EncodeBatch(unsigned firstRow, unsigned count, FecalSymbol* symbols)
+{
+    // If encoder is not initialized:
+    if (!LaneSums.Buffer.Data)
+        return Fecal_InvalidInput;
+
+    if (count <= 0 || !symbols || firstRow + count < firstRow)
+        return Fecal_InvalidInput;
+
+    // If some originals have not been added yet:
+    if (OriginalAddedCount < Window.InputCount)
+        return Fecal_NeedMoreData;
+
+    const unsigned symbolBytes = Window.SymbolBytes;
+    for (unsigned i = 0; i < count; ++i)
+    {
+        if (!symbols[i].Data || symbols[i].Bytes != Window.RecoveryBytes)
+            return Fecal_InvalidInput;
+        symbols[i].Index = firstRow + i;
+    }
+
+    if (count == 1)
+        return Encode(symbols[0]);
+
+    // Offload to the backend if the application provided one
+    if (Backend.EncodeRows && EncodeBackendRows(firstRow, count, symbols))
+        return Fecal_Success;
+
+    // Load parameters
+    const unsigned inputCount = Window.InputCount;
+    const unsigned pairCount = (inputCount + kPairAddRate - 1) / kPairAddRate;
+    const unsigned drawCount = pairCount * 2;
+
+    // Pick a tile size that keeps the working set in cache
+    unsigned tileBytes = kBatchWorkingSetBytes / (2 * count + kColumnLaneCount * kColumnSumCount);
+    tileBytes &= ~(kBatchMinTileBytes - 1);
+    if (tileBytes < kBatchMinTileBytes)
+        tileBytes = kBatchMinTileBytes;
+    if (tileBytes > kStripeBytes)
+        tileBytes = kStripeBytes;
+    if (tileBytes > symbolBytes)
+        tileBytes = symbolBytes;
+
+    // Allocate product tiles
+    const uint64_t productBytes = static_cast<uint64_t>(tileBytes) * count;
+    if (!BatchProducts.Allocate(productBytes))
+        return Fecal_OutOfMemory;
+
+    // Draw random columns and opcodes for all rows
+    BatchDraws.resize(static_cast<size_t>(drawCount) * count);
+    BatchOpcodes.resize(kColumnLaneCount * count);
+    BatchColumnStarts.assign(inputCount + 1, 0);
+
+    for (unsigned i = 0; i < count; ++i)
+    {
+        const unsigned row = firstRow + i;
+
+        RowSchedule schedule;
+        schedule.Initialize(Window.RowCache, row, inputCount, Window.RowScheme);
+
+        unsigned* draws = &BatchDraws[static_cast<size_t>(drawCount) * i];
+        for (unsigned j = 0; j < drawCount; ++j)
+        {
+            const unsigned column = schedule.NextColumn();
+            draws[j] = column;
+            ++BatchColumnStarts[column + 1];
+        }
+
+        for (unsigned laneIndex = 0; laneIndex < kColumnLaneCount; ++laneIndex)
+            BatchOpcodes[kColumnLaneCount * i + laneIndex] = schedule.GetOpcode(laneIndex);
+    }
+
+    // Compute the sums selected by any row in the batch
+    unsigned batchOpcodes[kColumnLaneCount] = {};
+    for (unsigned i = 0; i < count; ++i)
+        for (unsigned laneIndex = 0; laneIndex < kColumnLaneCount; ++laneIndex)
+            batchOpcodes[laneIndex] |= BatchOpcodes[kColumnLaneCount * i + laneIndex];
+
+    ComputeSelectedLaneSums(batchOpcodes);
+
+    // Convert column counts into column start offsets
+    for (unsigned column = 0; column < inputCount; ++column)
+        BatchColumnStarts[column + 1] += BatchColumnStarts[column];
+
+    // Scatter destinations into their column lists, using the column starts
+    // as fill pointers, which shifts each start to the end of its column
+    BatchDestinations.resize(static_cast<size_t>(drawCount) * count);
+    for (unsigned i = 0; i < count; ++i)
+    {
+        const unsigned* draws = &BatchDraws[static_cast<size_t>(drawCount) * i];
+        for (unsigned j = 0; j < drawCount; ++j)
+        {
+            // Even draws go to the sum, odd draws go to the product
+            BatchDestinations[BatchColumnStarts[draws[j]]++] = 2 * i + (j & 1);
+        }
+    }
+
+    // Shift the column starts back into place
+    for (unsigned column = inputCount - 1; column > 0; --column)
+        BatchColumnStarts[column] = BatchColumnStarts[column - 1];
+    BatchColumnStarts[0] = 0;
+
+    uint8_t* products = BatchProducts.Data;
+
+    // For each tile:
+    // Tiles do not cross stripe boundaries, so each tile of a lane sum is contiguous
+    for (unsigned offset = 0; offset < symbolBytes;)
+    {
+        unsigned bytes = symbolBytes - offset;
+        if (bytes > tileBytes)
+            bytes = tileBytes;
+        bytes = GetStripeBytes(offset, bytes);
+
+        // Clear the sum and product tiles
+        for (unsigned i = 0; i < count; ++i)
+        {
+            memset(reinterpret_cast<uint8_t*>(symbols[i].Data) + offset, 0, bytes);
+            memset(products + static_cast<size_t>(i) * tileBytes, 0, bytes);
+        }
+
+        // Single pass over the original data in this tile:
+        for (unsigned column = 0; column < inputCount; ++column)
+        {
+            const unsigned destStart = BatchColumnStarts[column];
+            const unsigned destEnd = BatchColumnStarts[column + 1];
+            if (destStart >= destEnd)
+                continue;
+
+            const unsigned columnBytes = Window.GetColumnBytes(column);
+            if (offset >= columnBytes)
+                continue;
+            unsigned srcBytes = columnBytes - offset;
+            if (srcBytes > bytes)
+                srcBytes = bytes;
+
+            const uint8_t* src = Window.OriginalData[column] + offset;
+
+            for (unsigned k = destStart; k < destEnd; ++k)
+            {
+                const unsigned dest = BatchDestinations[k];
+                const unsigned i = dest >> 1;
+                uint8_t* destData;
+                if (dest & 1)
+                    destData = products + static_cast<size_t>(i) * tileBytes;
+                else
+                    destData = reinterpret_cast<uint8_t*>(symbols[i].Data) + offset;
+
+                gf256_add_mem(destData, src, srcBytes);
+            }
+        }
+
+        // For each row:
+        for (unsigned i = 0; i < count; ++i)
+        {
+            uint8_t* outputSum = reinterpret_cast<uint8_t*>(symbols[i].Data) + offset;
+            uint8_t* outputProduct = products + static_cast<size_t>(i) * tileBytes;
+
+            XORSummer sum;
+            sum.Initialize(outputSum, bytes);
+            XORSummer prod;
+            prod.Initialize(outputProduct, bytes);
+
+            // For each lane:
+            for (unsigned laneIndex = 0; laneIndex < kColumnLaneCount; ++laneIndex)
+            {
+                const unsigned opcode = BatchOpcodes[kColumnLaneCount * i + laneIndex];
+
+                // Sum += Random Lanes
+                unsigned mask = 1;
+                for (unsigned sumIndex = 0; sumIndex < kColumnSumCount; ++sumIndex, mask <<= 1)
+                    if (opcode & mask)
+                        sum.Add(LaneSums.Get(laneIndex, sumIndex, offset));
+
+                // Product += Random Lanes
+                for (unsigned sumIndex = 0; sumIndex < kColumnSumCount; ++sumIndex, mask <<= 1)
+                    if (opcode & mask)
+                        prod.Add(LaneSums.Get(laneIndex, sumIndex, offset));
+            }
+
+            sum.Finalize();
+            prod.Finalize();
+
+            // Sum += RX * Product
+            gf256_muladd_mem(outputSum, GetRowValue(firstRow + i), outputProduct, bytes);
+        }
+
+        offset += bytes;
+    }
+
+    // Append the coded lengths of the originals
+    if (Window.IsVariableLength())
+    {
+        for (unsigned i = 0; i < count; ++i)
+        {
+            uint8_t* outputLength = reinterpret_cast<uint8_t*>(symbols[i].Data) + symbolBytes;
+            WriteLength(outputLength, Lengths.EncodeRow(Window, firstRow + i));
+        }
+    }
 
     return Fecal_Success;
 }
@@ -31,11 +31,31 @@
 /*
     Encoder
 
-    The encoder builds up sums of input data on Initialize().
+    The encoder builds up sums of input data for each lane on Initialize(),
+    in parallel with an executor.  With the LazyLaneSums option and no
+    executor, each sum is instead only computed the first time Encode() or
+    EncodeBatch() selects it, so producing one or two recovery symbols does
+    not pay for all of the sums.
 
     When Encode() is called it will combine these sums in a deterministic way.
 
+    The encoder can also be initialized without input data, and then each
+    original is added into the three sums of its lane by AddOriginal() as
+    the application produces it.  Encoding is possible as soon as the last
+    original has been added.
+
     Encode returns a pointer to the Sum workspace.
+
+    EncodeBatch() produces the same output as calling Encode() for each row,
+    but it plans all of the rows up front and then makes a single pass over
+    the original data and lane sums for each tile of bytes, so that each
+    piece of input data is read from memory once for the whole batch.
+
+    With a backend, the lane sums and the recovery symbols are described to
+    the application's callbacks instead, which may run them on a GPU.  The
+    lane sums are also kept in one contiguous buffer in that case, in the
+    source order of FecalBackendSources.  If a callback fails, the encoder
+    does the same work on the CPU.
 */
 
 #include "FecalCommon.h"
@@ -71,20 +91,120 @@ public:
     virtual ~Encoder() {}
 
     // Initialize the encoder
-    FecalResult Initialize(unsigned input_count, void* const * const input_data, uint64_t total_bytes);
+    // This may be called again to reuse the encoder for new input data
+    // input_data: May be NULL to add each original with AddOriginal()
+    // options: Optional encoder options, may be NULL to keep the current ones
+    FecalResult Initialize(unsigned input_count, void* const * const input_data, uint64_t total_bytes, const FecalEncoderOptions* options = nullptr);
+
+    // Initialize the encoder for variable-length originals
+    // input_bytes: Number of bytes in each original
+    FecalResult InitializeVariable(unsigned input_count, void* const * const input_data, const unsigned* input_bytes, const FecalEncoderOptions* options = nullptr);
+
+    // Add an original when initialized without input data
+    FecalResult AddOriginal(const FecalSymbol& symbol);
 
     // Generate the next recovery packet for the data
     FecalResult Encode(FecalSymbol& symbol);
 
+    // Generate recovery packets for rows firstRow..firstRow+count-1
+    FecalResult EncodeBatch(unsigned firstRow, unsigned count, FecalSymbol* symbols);
+
 protected:
     // Application data set
     EncoderAppDataWindow Window;
 
+    // Application executor for parallel work
+    FecalExecutor Executor = FecalExecutor();
+
+    // Compute each lane sum the first time a row selects it?
+    bool LazyLaneSums = false;
+
     // Sums for each lane
-    AlignedDataBuffer LaneSums[kColumnLaneCount][kColumnSumCount];
+    LaneSumSlab LaneSums;
+
+    // Lengths of the originals in variable-length mode
+    ColumnLengths Lengths;
+
+    // Bitmask of the sums computed so far for each lane
+    unsigned ComputedLaneSums[kColumnLaneCount] = {};
+
+    // Number of originals available, which is less than InputCount until
+    // all of the originals are added with AddOriginal()
+    unsigned OriginalAddedCount = 0;
+
+    // Sources of the sum and product for Encode()
+    SumSchedule EncodeSumSchedule;
+    SumSchedule EncodeProductSchedule;
+
+    // Batch workspace: One tile of product sum for each row in the batch
+    AlignedDataBuffer BatchProducts;
+
+    // Batch plan: For each column, the list of sums it is added into.
+    // Destination 2*i is the sum for row i and 2*i+1 is its product
+    std::vector<unsigned> BatchColumnStarts;
+    std::vector<unsigned> BatchDestinations;
+
+    // Batch plan: Random columns drawn for each row, in PRNG order
+    std::vector<unsigned> BatchDraws;
+
+    // Batch plan: Opcodes for each row and lane
+    std::vector<unsigned> BatchOpcodes;
+
+    // Application backend for offloading work
+    FecalEncoderBackend Backend = FecalEncoderBackend();
+
+    // Backend lane sums, one after another every BackendLaneSumStride bytes
+    AlignedDataBuffer BackendLaneSums;
+    unsigned BackendLaneSumStride = 0;
+
+    // Are the backend lane sums up to date with the lane sum slab?
+    bool BackendLaneSumsValid = false;
+
+    // Backend source tables: Data, Bytes and ColumnValues
+    std::vector<const uint8_t*> BackendData;
+    std::vector<unsigned> BackendBytes;
+    std::vector<uint8_t> BackendColumnValues;
+
+    // Backend rows and their source lists
+    std::vector<FecalBackendRow> BackendRows;
+    std::vector<unsigned> BackendSourceList;
+
+
+    // Set the input data and options after the window parameters are set
+    FecalResult InitializeInput(void* const * const input_data, const FecalEncoderOptions* options);
+
+    // Parameters for LaneSumTask()
+    struct LaneSumTaskContext
+    {
+        Encoder* Codec;
+        unsigned StripeBytes;
+        unsigned StripeCount;
+    };
+
+    // Parallel task: Compute one range of bytes for one lane
+    static void LaneSumTask(void* context, unsigned taskIndex);
+
+    // Compute lane sums for the given lane over the given range of bytes
+    // sums: Bitmask of the sums to compute
+    void ComputeLaneSums(unsigned laneIndex, unsigned sums, unsigned offset, unsigned bytes);
+
+    // Compute any of the sums selected by the opcodes that are not ready yet
+    // opcodes: One opcode for each lane
+    void ComputeSelectedLaneSums(const unsigned* opcodes);
+
+    // Allocate backend buffers and fill in the source tables
+    FecalResult InitializeBackend();
+
+    // Fill in the backend source descriptions for the current originals
+    void GetBackendSources(FecalBackendSources& sources);
+
+    // Compute the lane sums with the backend
+    // Returns false if the backend failed
+    bool ComputeBackendLaneSums();
 
-    // Output workspace
-    AlignedDataBuffer ProductWorkspace;
+    // Generate recovery packets for rows firstRow..firstRow+count-1 with the backend
+    // Returns false if the backend failed
+    bool EncodeBackendRows(unsigned firstRow, unsigned count, FecalSymbol* symbols);
 };
 
 
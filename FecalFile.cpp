@@ -0,0 +1,518 @@
+/*
+    Copyright (c) 2017 Christopher A. Taylor.  All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice,
+      this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright notice,
+      this list of conditions and the following disclaimer in the documentation
+      and/or other materials provided with the distribution.
+    * Neither the name of Fecal nor the names of its contributors may be
+      used to endorse or promote products derived from this software without
+      specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+    ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+    LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+    CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+    SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+    CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+    ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+    POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "FecalFile.h"
+
+#include <cstdio>
+#include <string>
+
+#ifdef _WIN32
+    #ifndef WIN32_LEAN_AND_MEAN
+        #define WIN32_LEAN_AND_MEAN
+    #endif
+    #include <windows.h>
+#else
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+namespace fecal {
+
+
+//------------------------------------------------------------------------------
+// MappedFile
+
+#ifdef _WIN32
+
+bool MappedFile::OpenRead(const char* path)
+{
+    Close();
+
+    HANDLE file = ::CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, nullptr,
+        OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+        return false;
+    File = file;
+
+    LARGE_INTEGER size;
+    if (!::GetFileSizeEx(file, &size))
+    {
+        Close();
+        return false;
+    }
+    Bytes = static_cast<uint64_t>(size.QuadPart);
+
+    return Map(false);
+}
+
+bool MappedFile::OpenWrite(const char* path, uint64_t bytes)
+{
+    Close();
+
+    HANDLE file = ::CreateFileA(path, GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ, nullptr,
+        OPEN_ALWAYS, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+        return false;
+    File = file;
+
+    LARGE_INTEGER size;
+    size.QuadPart = static_cast<LONGLONG>(bytes);
+    if (size.QuadPart < 0 ||
+        !::SetFilePointerEx(file, size, nullptr, FILE_BEGIN) ||
+        !::SetEndOfFile(file))
+    {
+        Close();
+        return false;
+    }
+    Bytes = bytes;
+
+    return Map(true);
+}
+
+bool MappedFile::Map(bool writable)
+{
+    // The whole file must fit in the address space
+    if (Bytes <= 0 || static_cast<size_t>(Bytes) != Bytes)
+    {
+        Close();
+        return false;
+    }
+
+    Mapping = ::CreateFileMappingA(File, nullptr, writable ? PAGE_READWRITE : PAGE_READONLY, 0, 0, nullptr);
+    if (!Mapping)
+    {
+        Close();
+        return false;
+    }
+
+    Data = reinterpret_cast<uint8_t*>( ::MapViewOfFile(Mapping, writable ? FILE_MAP_WRITE : FILE_MAP_READ, 0, 0, 0) );
+    if (!Data)
+    {
+        Close();
+        return false;
+    }
+
+    return true;
+}
+
+bool MappedFile::Flush()
+{
+    return ::FlushViewOfFile(Data, 0) && ::FlushFileBuffers(File);
+}
+
+void MappedFile::Close()
+{
+    if (Data)
+        ::UnmapViewOfFile(Data);
+    if (Mapping)
+        ::CloseHandle(Mapping);
+    if (File)
+        ::CloseHandle(File);
+
+    Data = nullptr;
+    Mapping = nullptr;
+    File = nullptr;
+    Bytes = 0;
+}
+
+#else // _WIN32
+
+bool MappedFile::OpenRead(const char* path)
+{
+    Close();
+
+    File = ::open(path, O_RDONLY);
+    if (File < 0)
+        return false;
+
+    struct stat info;
+    if (::fstat(File, &info) != 0)
+    {
+        Close();
+        return false;
+    }
+    Bytes = static_cast<uint64_t>(info.st_size);
+
+    return Map(false);
+}
+
+bool MappedFile::OpenWrite(const char* path, uint64_t bytes)
+{
+    Close();
+
+    File = ::open(path, O_RDWR | O_CREAT, 0644);
+    if (File < 0)
+        return false;
+
+    const off_t size = static_cast<off_t>(bytes);
+    if (size < 0 || static_cast<uint64_t>(size) != bytes ||
+        ::ftruncate(File, size) != 0)
+    {
+        Close();
+        return false;
+    }
+    Bytes = bytes;
+
+    return Map(true);
+}
+
+bool MappedFile::Map(bool writable)
+{
+    // The whole file must fit in the address space
+    const size_t size = static_cast<size_t>(Bytes);
+    if (Bytes <= 0 || size != Bytes)
+    {
+        Close();
+        return false;
+    }
+
+    const int protection = writable ? (PROT_READ | PROT_WRITE) : PROT_READ;
+    void* data = ::mmap(nullptr, size, protection, MAP_SHARED, File, 0);
+    if (data == MAP_FAILED)
+    {
+        Close();
+        return false;
+    }
+    Data = reinterpret_cast<uint8_t*>( data );
+
+    // All of the file is read, so ask for it to be read ahead
+    ::posix_madvise(data, size, POSIX_MADV_WILLNEED);
+
+    return true;
+}
+
+bool MappedFile::Flush()
+{
+    return ::msync(Data, static_cast<size_t>(Bytes), MS_SYNC) == 0;
+}
+
+void MappedFile::Close()
+{
+    if (Data)
+        ::munmap(Data, static_cast<size_t>(Bytes));
+    if (File >= 0)
+        ::close(File);
+
+    Data = nullptr;
+    File = -1;
+    Bytes = 0;
+}
+
+#endif // _WIN32
+
+
+//------------------------------------------------------------------------------
+// File replacement
+
+#ifdef _WIN32
+
+static bool ReplaceFileWith(const char* path, const char* tempPath)
+{
+    return ::MoveFileExA(tempPath, path, MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH) != 0;
+}
+
+static void RemoveFile(const char* path)
+{
+    ::DeleteFileA(path);
+}
+
+#else // _WIN32
+
+static bool ReplaceFileWith(const char* path, const char* tempPath)
+{
+    return ::rename(tempPath, path) == 0;
+}
+
+static void RemoveFile(const char* path)
+{
+    ::unlink(path);
+}
+
+#endif // _WIN32
+
+
+//------------------------------------------------------------------------------
+// File layout
+
+// Get the number of bytes in each symbol for a file split into input_count
+// symbols, or 0 if the file cannot be split that way
+static unsigned GetFileSymbolBytes(unsigned input_count, uint64_t total_bytes)
+{
+    if (input_count <= 0 || total_bytes < input_count)
+        return 0;
+
+    const uint64_t symbolBytes = (total_bytes + input_count - 1) / input_count;
+    if (symbolBytes > kMaxSymbolBytes)
+        return 0;
+
+    // The final input must not be empty
+    if (symbolBytes * (input_count - 1) >= total_bytes)
+        return 0;
+
+    return static_cast<unsigned>(symbolBytes);
+}
+
+
+//------------------------------------------------------------------------------
+// FileEncoder
+
+FecalResult FileEncoder::Initialize(const char* path, unsigned input_count, const FecalEncoderOptions* options)
+{
+    if (!path || input_count <= 0)
+    {
+        FECAL_DEBUG_BREAK; // Invalid input
+        return Fecal_InvalidInput;
+    }
+
+    if (!Input.OpenRead(path))
+        return Fecal_FileError;
+
+    SymbolBytes = GetFileSymbolBytes(input_count, Input.Bytes);
+    if (SymbolBytes <= 0)
+    {
+        Input.Close();
+        return Fecal_InvalidInput;
+    }
+
+    // Point each input into the mapping
+    InputData.resize(input_count);
+    for (unsigned i = 0; i < input_count; ++i)
+        InputData[i] = Input.Data + static_cast<size_t>(i) * SymbolBytes;
+
+    return Codec.Initialize(input_count, &InputData[0], Input.Bytes, options);
+}
+
+FecalResult FileEncoder::EncodeToFile(unsigned firstRow, unsigned count, const char* outputPath)
+{
+    // If encoder is not initialized:
+    if (InputData.empty() || !Input.Data)
+        return Fecal_InvalidInput;
+
+    if (!outputPath || count <= 0 || firstRow + count < firstRow)
+        return Fecal_InvalidInput;
+
+    // Write a temporary file next to the output, so that a failure partway
+    // does not leave a truncated output file behind
+    const std::string tempPath = std::string(outputPath) + kFileTempSuffix;
+
+    MappedFile output;
+    if (!output.OpenWrite(tempPath.c_str(), static_cast<uint64_t>(count) * SymbolBytes))
+    {
+        RemoveFile(tempPath.c_str());
+        return Fecal_FileError;
+    }
+
+    // Encode each batch straight into the output mapping
+    FecalResult result = Fecal_Success;
+    for (unsigned done = 0; done < count && result == Fecal_Success;)
+    {
+        unsigned batchCount = count - done;
+        if (batchCount > kFileEncodeBatchSymbols)
+            batchCount = kFileEncodeBatchSymbols;
+
+        BatchSymbols.resize(batchCount);
+        for (unsigned i = 0; i < batchCount; ++i)
+        {
+            BatchSymbols[i].Data = output.Data + static_cast<size_t>(done + i) * SymbolBytes;
+            BatchSymbols[i].Bytes = SymbolBytes;
+        }
+
+        result = Codec.EncodeBatch(firstRow + done, batchCount, &BatchSymbols[0]);
+        done += batchCount;
+    }
+
+    if (result == Fecal_Success && !output.Flush())
+        result = Fecal_FileError;
+
+    // The file must be closed before it can be renamed on Windows
+    output.Close();
+
+    if (result == Fecal_Success && !ReplaceFileWith(outputPath, tempPath.c_str()))
+        result = Fecal_FileError;
+
+    if (result != Fecal_Success)
+        RemoveFile(tempPath.c_str());
+
+    return result;
+}
+
+
+//------------------------------------------------------------------------------
+// FileDecoder
+
+FileDecoder::~FileDecoder()
+{
+    for (MappedFile* file : RecoveryFiles)
+        delete file;
+}
+
+FecalResult FileDecoder::Initialize(const char* path, unsigned input_count, uint64_t total_bytes,
+    const FecalDecoderOptions* options)
+{
+    for (MappedFile* file : RecoveryFiles)
+        delete file;
+    RecoveryFiles.clear();
+
+    if (!path)
+    {
+        FECAL_DEBUG_BREAK; // Invalid input
+        return Fecal_InvalidInput;
+    }
+
+    SymbolBytes = GetFileSymbolBytes(input_count, total_bytes);
+    if (SymbolBytes <= 0)
+    {
+        FECAL_DEBUG_BREAK; // Invalid input
+        return Fecal_InvalidInput;
+    }
+    InputCount = input_count;
+
+    if (!Output.OpenWrite(path, total_bytes))
+        return Fecal_FileError;
+
+    // Recovery files are mapped read-only, so the decoder must copy them
+    FecalDecoderOptions decoderOptions = FecalDecoderOptions();
+    if (options)
+        decoderOptions = *options;
+    decoderOptions.ConstRecoveryData = 1;
+
+    return Codec.Initialize(input_count, total_bytes, &decoderOptions);
+}
+
+unsigned FileDecoder::GetInputBytes(unsigned input_index) const
+{
+    if (input_index == InputCount - 1)
+        return static_cast<unsigned>(Output.Bytes - static_cast<uint64_t>(input_index) * SymbolBytes);
+    return SymbolBytes;
+}
+
+FecalResult FileDecoder::AddOriginal(unsigned input_index)
+{
+    // If decoder is not initialized:
+    if (!Output.Data)
+        return Fecal_InvalidInput;
+
+    if (input_index >= InputCount)
+    {
+        FECAL_DEBUG_BREAK; // Invalid input
+        return Fecal_InvalidInput;
+    }
+
+    FecalSymbol symbol;
+    symbol.Data = Output.Data + static_cast<size_t>(input_index) * SymbolBytes;
+    symbol.Bytes = GetInputBytes(input_index);
+    symbol.Index = input_index;
+
+    return Codec.AddOriginal(symbol);
+}
+
+FecalResult FileDecoder::AddRecoveryFile(const char* path, unsigned firstRow)
+{
+    // If decoder is not initialized:
+    if (!Output.Data)
+        return Fecal_InvalidInput;
+
+    if (!path)
+    {
+        FECAL_DEBUG_BREAK; // Invalid input
+        return Fecal_InvalidInput;
+    }
+
+    MappedFile* file = new(std::nothrow) MappedFile;
+    if (!file)
+        return Fecal_OutOfMemory;
+
+    if (!file->OpenRead(path))
+    {
+        delete file;
+        return Fecal_FileError;
+    }
+
+    // The file must hold a whole number of symbols
+    const uint64_t count = file->Bytes / SymbolBytes;
+    if (file->Bytes % SymbolBytes != 0 ||
+        static_cast<uint64_t>(firstRow) + count - 1 > 0xffffffff)
+    {
+        delete file;
+        return Fecal_InvalidInput;
+    }
+
+    RecoveryFiles.push_back(file);
+
+    for (unsigned i = 0; i < static_cast<unsigned>(count); ++i)
+    {
+        FecalSymbol symbol;
+        symbol.Data = file->Data + static_cast<size_t>(i) * SymbolBytes;
+        symbol.Bytes = SymbolBytes;
+        symbol.Index = firstRow + i;
+
+        const FecalResult result = Codec.AddRecovery(symbol);
+        if (result != Fecal_Success)
+            return result;
+    }
+
+    return Fecal_Success;
+}
+
+FecalResult FileDecoder::AddRecovery(const FecalSymbol& symbol)
+{
+    // If decoder is not initialized:
+    if (!Output.Data)
+        return Fecal_InvalidInput;
+
+    return Codec.AddRecovery(symbol);
+}
+
+FecalResult FileDecoder::Decode()
+{
+    // If decoder is not initialized:
+    if (!Output.Data)
+        return Fecal_InvalidInput;
+
+    RecoveredSymbols symbols;
+    const FecalResult result = Codec.Decode(symbols);
+    if (result != Fecal_Success)
+        return result;
+
+    // Write the recovered inputs into their places in the file
+    for (unsigned i = 0; i < symbols.Count; ++i)
+    {
+        const FecalSymbol& symbol = symbols.Symbols[i];
+        memcpy(Output.Data + static_cast<size_t>(symbol.Index) * SymbolBytes, symbol.Data, symbol.Bytes);
+    }
+
+    if (!Output.Flush())
+        return Fecal_FileError;
+
+    return Fecal_Success;
+}
+
+
+} // namespace fecal
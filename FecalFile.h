@@ -0,0 +1,193 @@
+/*
+    Copyright (c) 2017 Christopher A. Taylor.  All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice,
+      this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright notice,
+      this list of conditions and the following disclaimer in the documentation
+      and/or other materials provided with the distribution.
+    * Neither the name of Fecal nor the names of its contributors may be
+      used to endorse or promote products derived from this software without
+      specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+    ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+    LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+    CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+    SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+    CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+    ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+    POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#pragma once
+
+/*
+    File Codec
+
+    The file encoder and decoder protect an object stored in a file without
+    reading it into application buffers.  The file is memory-mapped and split
+    into input_count symbols in order, so the original data pointers of the
+    block codec point straight into the mapping:
+
+        Input i -> File bytes [i * SymbolBytes, (i + 1) * SymbolBytes)
+
+    where SymbolBytes = ceil(file bytes / input_count), and the final input
+    holds whatever is left.  Recovery symbols are written by EncodeBatch()
+    straight into a mapping of the output file, one symbol after another, so
+    symbol r of an output file written from first_row has index first_row + r.
+    The output is written under a temporary name and renamed once it is
+    complete, so a failed encode never leaves a partial output file.
+
+    The decoder maps the object file read-write, at its full size, and reads
+    the received originals from it in place.  The mapped recovery files are
+    read-only, so the decoder makes its own copies of the recovery symbols it
+    uses, and the recovered originals are written back into the object file.
+
+    The page cache does the reading and writing, and each mapping is advised
+    that all of it will be needed soon so that it is read ahead in order.
+*/
+
+#include "FecalEncoder.h"
+#include "FecalDecoder.h"
+
+namespace fecal {
+
+
+//------------------------------------------------------------------------------
+// MappedFile
+
+// Memory-mapped view of a whole file
+class MappedFile
+{
+public:
+    // Mapped file data
+    uint8_t* Data = nullptr;
+
+    // Number of bytes in the file
+    uint64_t Bytes = 0;
+
+
+    ~MappedFile()
+    {
+        Close();
+    }
+
+    // Map an existing file read-only
+    // Returns false if the file cannot be opened or is empty
+    bool OpenRead(const char* path);
+
+    // Open or create a file, set its size to the given number of bytes, and
+    // map it read-write.  Existing data within the new size is kept
+    // Returns false on failure
+    bool OpenWrite(const char* path, uint64_t bytes);
+
+    // Write modified data back to the file
+    // Returns false on failure
+    bool Flush();
+
+    // Unmap and close the file
+    void Close();
+
+protected:
+#ifdef _WIN32
+    void* File = nullptr;
+    void* Mapping = nullptr;
+#else
+    int File = -1;
+#endif
+
+    // Map the open file after its size is known
+    bool Map(bool writable);
+};
+
+
+//------------------------------------------------------------------------------
+// FileEncoder
+
+// Maximum number of recovery symbols produced by each EncodeBatch() call
+static const unsigned kFileEncodeBatchSymbols = 64;
+
+// Appended to the output path for the file written before it is renamed
+static const char* const kFileTempSuffix = ".fecaltmp";
+
+class FileEncoder : public ICodec
+{
+public:
+    // Initialize the encoder with the file to protect
+    FecalResult Initialize(const char* path, unsigned input_count, const FecalEncoderOptions* options);
+
+    // Write recovery symbols for rows firstRow..firstRow+count-1 to a file
+    FecalResult EncodeToFile(unsigned firstRow, unsigned count, const char* outputPath);
+
+protected:
+    // Mapped object file
+    MappedFile Input;
+
+    // Pointer to each input within the mapping
+    std::vector<void*> InputData;
+
+    // Number of bytes in each symbol
+    unsigned SymbolBytes = 0;
+
+    // Block encoder reading the mapping
+    Encoder Codec;
+
+    // Symbols for one batch
+    std::vector<FecalSymbol> BatchSymbols;
+};
+
+
+//------------------------------------------------------------------------------
+// FileDecoder
+
+class FileDecoder : public ICodec
+{
+public:
+    virtual ~FileDecoder();
+
+    // Initialize the decoder with the file to recover into
+    FecalResult Initialize(const char* path, unsigned input_count, uint64_t total_bytes,
+        const FecalDecoderOptions* options);
+
+    // Mark an input that is intact in the file
+    FecalResult AddOriginal(unsigned input_index);
+
+    // Add all of the recovery symbols in a file written by EncodeToFile()
+    FecalResult AddRecoveryFile(const char* path, unsigned firstRow);
+
+    // Add one recovery symbol, which must stay available until decoding
+    FecalResult AddRecovery(const FecalSymbol& symbol);
+
+    // Try to decode, writing the recovered inputs into the file
+    FecalResult Decode();
+
+protected:
+    // Mapped object file
+    MappedFile Output;
+
+    // Number of inputs in the file
+    unsigned InputCount = 0;
+
+    // Number of bytes in each symbol
+    unsigned SymbolBytes = 0;
+
+    // Mapped recovery files
+    std::vector<MappedFile*> RecoveryFiles;
+
+    // Block decoder reading the mappings
+    Decoder Codec;
+
+
+    // Number of bytes in the given input
+    unsigned GetInputBytes(unsigned input_index) const;
+};
+
+
+} // namespace fecal
@@ -0,0 +1,433 @@
+/*
+    Copyright (c) 2017 Christopher A. Taylor.  All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice,
+      this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright notice,
+      this list of conditions and the following disclaimer in the documentation
+      and/or other materials provided with the distribution.
+    * Neither the name of Fecal nor the names of its contributors may be
+      used to endorse or promote products derived from this software without
+      specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+    ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+    LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+    CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+    SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+    CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+    ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+    POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "FecalInterleaved.h"
+
+namespace fecal {
+
+
+//------------------------------------------------------------------------------
+// InterleavedLayout
+
+unsigned GetInterleavedBlockCount(unsigned input_count, uint64_t total_bytes)
+{
+    uint64_t blockCount = (input_count + kInterleavedMaxBlockInputs - 1) / kInterleavedMaxBlockInputs;
+
+    const uint64_t bytesBlockCount = (total_bytes + kInterleavedMaxBlockBytes - 1) / kInterleavedMaxBlockBytes;
+    if (blockCount < bytesBlockCount)
+        blockCount = bytesBlockCount;
+
+    if (blockCount > input_count)
+        blockCount = input_count;
+    if (blockCount < 1)
+        blockCount = 1;
+
+    return static_cast<unsigned>(blockCount);
+}
+
+bool InterleavedLayout::SetParameters(unsigned input_count, uint64_t total_bytes, unsigned block_count)
+{
+    if (input_count <= 0 || total_bytes < input_count ||
+        block_count <= 0 || block_count > input_count)
+    {
+        FECAL_DEBUG_BREAK; // Invalid input
+        return false;
+    }
+
+    InputCount = input_count;
+    BlockCount = block_count;
+
+    const uint64_t symbolBytes = (total_bytes + input_count - 1) / input_count;
+    if (symbolBytes > kMaxSymbolBytes)
+    {
+        FECAL_DEBUG_BREAK; // Symbols too large
+        return false;
+    }
+
+    SymbolBytes = static_cast<unsigned>(symbolBytes);
+    FinalBytes = static_cast<unsigned>(total_bytes % SymbolBytes);
+    if (FinalBytes <= 0)
+        FinalBytes = SymbolBytes;
+
+    FECAL_DEBUG_ASSERT(SymbolBytes >= FinalBytes && FinalBytes != 0);
+
+    return true;
+}
+
+
+//------------------------------------------------------------------------------
+// InterleavedEncoder
+
+InterleavedEncoder::~InterleavedEncoder()
+{
+    for (Encoder* block : Blocks)
+        delete block;
+}
+
+FecalResult InterleavedEncoder::Initialize(unsigned input_count, void* const * const input_data, uint64_t total_bytes,
+    unsigned block_count, const FecalEncoderOptions* options)
+{
+    if (!Layout.SetParameters(input_count, total_bytes, block_count))
+    {
+        FECAL_DEBUG_BREAK; // Invalid input
+        return Fecal_InvalidInput;
+    }
+
+    if (options)
+    {
+        Executor = options->Executor;
+        RowCache = options->RowCache;
+        RowScheme = options->RowScheme;
+    }
+
+    // Gather the input pointers for each block
+    BlockInputs.resize(input_count);
+    for (unsigned block = 0; block < block_count; ++block)
+    {
+        void** blockInputs = &BlockInputs[Layout.GetBlockStart(block)];
+        const unsigned blockInputCount = Layout.GetBlockInputCount(block);
+
+        for (unsigned column = 0; column < blockInputCount; ++column)
+            blockInputs[column] = input_data[Layout.GetInputIndex(block, column)];
+    }
+
+    // Pad the final input so every block has full symbols
+    if (Layout.IsFinalPadded())
+    {
+        const unsigned finalIndex = input_count - 1;
+        if (!PaddedFinal.Allocate(Layout.SymbolBytes))
+            return Fecal_OutOfMemory;
+        memcpy(PaddedFinal.Data, input_data[finalIndex], Layout.FinalBytes);
+        memset(PaddedFinal.Data + Layout.FinalBytes, 0, Layout.SymbolBytes - Layout.FinalBytes);
+
+        const unsigned finalBlock = finalIndex % block_count;
+        BlockInputs[Layout.GetBlockStart(finalBlock) + finalIndex / block_count] = PaddedFinal.Data;
+    }
+
+    Blocks.reserve(block_count);
+    while (Blocks.size() < block_count)
+    {
+        Encoder* block = new(std::nothrow) Encoder;
+        if (!block)
+            return Fecal_OutOfMemory;
+        Blocks.push_back(block);
+    }
+
+    // Each block is set up as a separate task
+    BlockResults.resize(block_count);
+    RunParallelTasks(Executor, block_count, &InterleavedEncoder::InitializeTask, this);
+
+    for (unsigned block = 0; block < block_count; ++block)
+        if (BlockResults[block] != Fecal_Success)
+            return BlockResults[block];
+
+    return Fecal_Success;
+}
+
+void InterleavedEncoder::InitializeTask(void* context, unsigned taskIndex)
+{
+    InterleavedEncoder* encoder = reinterpret_cast<InterleavedEncoder*>( context );
+    const InterleavedLayout& layout = encoder->Layout;
+
+    // Use the executor within the block only if there is one block
+    FecalEncoderOptions blockOptions = FecalEncoderOptions();
+    blockOptions.RowCache = encoder->RowCache;
+    blockOptions.RowScheme = encoder->RowScheme;
+    if (layout.BlockCount == 1)
+        blockOptions.Executor = encoder->Executor;
+
+    const unsigned blockInputCount = layout.GetBlockInputCount(taskIndex);
+
+    encoder->BlockResults[taskIndex] = encoder->Blocks[taskIndex]->Initialize(
+        blockInputCount,
+        &encoder->BlockInputs[layout.GetBlockStart(taskIndex)],
+        static_cast<uint64_t>(blockInputCount) * layout.SymbolBytes,
+        &blockOptions);
+}
+
+FecalResult InterleavedEncoder::Encode(FecalSymbol& symbol)
+{
+    // If encoder is not initialized:
+    if (Blocks.size() < Layout.BlockCount || Layout.BlockCount <= 0)
+        return Fecal_InvalidInput;
+
+    FecalSymbol blockSymbol = symbol;
+    blockSymbol.Index = symbol.Index / Layout.BlockCount;
+
+    return Blocks[symbol.Index % Layout.BlockCount]->Encode(blockSymbol);
+}
+
+FecalResult InterleavedEncoder::EncodeBatch(unsigned firstRow, unsigned count, FecalSymbol* symbols)
+{
+    // If encoder is not initialized:
+    if (Blocks.size() < Layout.BlockCount || Layout.BlockCount <= 0)
+        return Fecal_InvalidInput;
+
+    if (count <= 0 || !symbols || firstRow + count < firstRow)
+        return Fecal_InvalidInput;
+
+    const unsigned blockCount = Layout.BlockCount;
+
+    // Plan the rows for each block
+    BatchFirstRows.resize(blockCount);
+    BatchCounts.resize(blockCount);
+    BatchOffsets.resize(blockCount);
+    BatchSymbols.resize(count);
+
+    unsigned offset = 0;
+    for (unsigned block = 0; block < blockCount; ++block)
+    {
+        // First row in the batch that belongs to this block
+        const unsigned skip = (block + blockCount - firstRow % blockCount) % blockCount;
+
+        BatchOffsets[block] = offset;
+        BatchFirstRows[block] = (firstRow + skip) / blockCount;
+        BatchCounts[block] = (skip < count) ? (count - skip + blockCount - 1) / blockCount : 0;
+
+        for (unsigned i = skip; i < count; i += blockCount)
+            BatchSymbols[offset++] = symbols[i];
+    }
+    FECAL_DEBUG_ASSERT(offset == count);
+
+    // Each block is encoded as a separate task
+    BlockResults.resize(blockCount);
+    RunParallelTasks(Executor, blockCount, &InterleavedEncoder::EncodeBatchTask, this);
+
+    for (unsigned block = 0; block < blockCount; ++block)
+        if (BlockResults[block] != Fecal_Success)
+            return BlockResults[block];
+
+    for (unsigned i = 0; i < count; ++i)
+        symbols[i].Index = firstRow + i;
+
+    return Fecal_Success;
+}
+
+void InterleavedEncoder::EncodeBatchTask(void* context, unsigned taskIndex)
+{
+    InterleavedEncoder* encoder = reinterpret_cast<InterleavedEncoder*>( context );
+
+    const unsigned count = encoder->BatchCounts[taskIndex];
+    if (count <= 0)
+    {
+        encoder->BlockResults[taskIndex] = Fecal_Success;
+        return;
+    }
+
+    encoder->BlockResults[taskIndex] = encoder->Blocks[taskIndex]->EncodeBatch(
+        encoder->BatchFirstRows[taskIndex],
+        count,
+        &encoder->BatchSymbols[encoder->BatchOffsets[taskIndex]]);
+}
+
+
+//------------------------------------------------------------------------------
+// InterleavedDecoder
+
+InterleavedDecoder::~InterleavedDecoder()
+{
+    for (Decoder* block : Blocks)
+        delete block;
+}
+
+FecalResult InterleavedDecoder::Initialize(unsigned input_count, uint64_t total_bytes,
+    unsigned block_count, const FecalDecoderOptions* options)
+{
+    if (!Layout.SetParameters(input_count, total_bytes, block_count))
+    {
+        FECAL_DEBUG_BREAK; // Invalid input
+        return Fecal_InvalidInput;
+    }
+
+    // Use the executor within the block only if there is one block
+    FecalDecoderOptions blockOptions = FecalDecoderOptions();
+    if (options)
+    {
+        Executor = options->Executor;
+        blockOptions = *options;
+        if (block_count > 1)
+            blockOptions.Executor = FecalExecutor();
+    }
+
+    if (Layout.IsFinalPadded() && !PaddedFinal.Allocate(Layout.SymbolBytes))
+        return Fecal_OutOfMemory;
+
+    Blocks.reserve(block_count);
+    for (unsigned block = 0; block < block_count; ++block)
+    {
+        Decoder* decoder = new(std::nothrow) Decoder;
+        if (!decoder)
+            return Fecal_OutOfMemory;
+        Blocks.push_back(decoder);
+
+        const unsigned blockInputCount = Layout.GetBlockInputCount(block);
+        const FecalResult result = decoder->Initialize(
+            blockInputCount,
+            static_cast<uint64_t>(blockInputCount) * Layout.SymbolBytes,
+            &blockOptions);
+        if (result != Fecal_Success)
+            return result;
+    }
+
+    BlockComplete.assign(block_count, false);
+    BlockResults.resize(block_count);
+    BlockRecovered.resize(block_count);
+
+    return Fecal_Success;
+}
+
+FecalResult InterleavedDecoder::AddOriginal(const FecalSymbol& symbol)
+{
+    if (symbol.Index >= Layout.InputCount ||
+        symbol.Data == nullptr ||
+        symbol.Bytes != Layout.GetInputBytes(symbol.Index) ||
+        Blocks.size() < Layout.BlockCount)
+    {
+        FECAL_DEBUG_BREAK; // Invalid input
+        return Fecal_InvalidInput;
+    }
+
+    FecalSymbol blockSymbol = symbol;
+    blockSymbol.Index = symbol.Index / Layout.BlockCount;
+
+    // Pad the final input so every block has full symbols
+    if (symbol.Index == Layout.InputCount - 1 && Layout.IsFinalPadded())
+    {
+        memcpy(PaddedFinal.Data, symbol.Data, Layout.FinalBytes);
+        memset(PaddedFinal.Data + Layout.FinalBytes, 0, Layout.SymbolBytes - Layout.FinalBytes);
+
+        blockSymbol.Data = PaddedFinal.Data;
+        blockSymbol.Bytes = Layout.SymbolBytes;
+    }
+
+    return Blocks[symbol.Index % Layout.BlockCount]->AddOriginal(blockSymbol);
+}
+
+FecalResult InterleavedDecoder::AddRecovery(const FecalSymbol& symbol)
+{
+    if (Blocks.size() < Layout.BlockCount)
+        return Fecal_InvalidInput;
+
+    FecalSymbol blockSymbol = symbol;
+    blockSymbol.Index = symbol.Index / Layout.BlockCount;
+
+    return Blocks[symbol.Index % Layout.BlockCount]->AddRecovery(blockSymbol);
+}
+
+FecalResult InterleavedDecoder::Decode(RecoveredSymbols& symbols)
+{
+    // Default return values
+    symbols.Symbols = nullptr;
+    symbols.Count = 0;
+
+    if (Blocks.size() < Layout.BlockCount)
+        return Fecal_InvalidInput;
+
+    const unsigned blockCount = Layout.BlockCount;
+
+    DecodeBlocks.clear();
+    for (unsigned block = 0; block < blockCount; ++block)
+        if (!BlockComplete[block])
+            DecodeBlocks.push_back(block);
+
+    // Each block is decoded as a separate task
+    RunParallelTasks(
+        Executor,
+        static_cast<unsigned>(DecodeBlocks.size()),
+        &InterleavedDecoder::DecodeTask,
+        this);
+
+    FecalResult result = Fecal_Success;
+
+    for (unsigned block : DecodeBlocks)
+    {
+        const FecalResult blockResult = BlockResults[block];
+        if (blockResult != Fecal_Success)
+        {
+            if (result == Fecal_Success || blockResult != Fecal_NeedMoreData)
+                result = blockResult;
+            continue;
+        }
+
+        BlockComplete[block] = true;
+
+        // Convert recovered symbols back to input indices
+        const RecoveredSymbols& recovered = BlockRecovered[block];
+        for (unsigned i = 0; i < recovered.Count; ++i)
+        {
+            FecalSymbol symbol = recovered.Symbols[i];
+            symbol.Index = Layout.GetInputIndex(block, symbol.Index);
+            symbol.Bytes = Layout.GetInputBytes(symbol.Index);
+            RecoveredData.push_back(symbol);
+        }
+    }
+
+    if (result != Fecal_Success)
+        return result;
+
+    if (!RecoveredData.empty())
+    {
+        symbols.Symbols = &RecoveredData[0];
+        symbols.Count = static_cast<unsigned>(RecoveredData.size());
+    }
+
+    return Fecal_Success;
+}
+
+void InterleavedDecoder::DecodeTask(void* context, unsigned taskIndex)
+{
+    InterleavedDecoder* decoder = reinterpret_cast<InterleavedDecoder*>( context );
+    const unsigned block = decoder->DecodeBlocks[taskIndex];
+
+    decoder->BlockResults[block] = decoder->Blocks[block]->Decode(decoder->BlockRecovered[block]);
+}
+
+FecalResult InterleavedDecoder::GetOriginal(unsigned input_index, FecalSymbol& symbol)
+{
+    symbol.Index = input_index;
+    symbol.Data = nullptr;
+    symbol.Bytes = 0;
+
+    if (input_index >= Layout.InputCount || Blocks.size() < Layout.BlockCount)
+    {
+        FECAL_DEBUG_BREAK; // Invalid input
+        return Fecal_InvalidInput;
+    }
+
+    const FecalResult result = Blocks[input_index % Layout.BlockCount]->GetOriginal(
+        input_index / Layout.BlockCount, symbol);
+
+    symbol.Index = input_index;
+    if (result == Fecal_Success)
+        symbol.Bytes = Layout.GetInputBytes(input_index);
+
+    return result;
+}
+
+
+} // namespace fecal
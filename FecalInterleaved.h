@@ -0,0 +1,227 @@
+/*
+    Copyright (c) 2017 Christopher A. Taylor.  All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice,
+      this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright notice,
+      this list of conditions and the following disclaimer in the documentation
+      and/or other materials provided with the distribution.
+    * Neither the name of Fecal nor the names of its contributors may be
+      used to endorse or promote products derived from this software without
+      specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+    ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+    LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+    CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+    SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+    CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+    ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+    POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#pragma once
+
+/*
+    Interleaved Codec
+
+    The interleaved encoder and decoder split a large input into several
+    blocks, each handled by an ordinary Encoder or Decoder:
+
+        Input i    -> Block (i % BlockCount), column (i / BlockCount)
+        Recovery r -> Block (r % BlockCount), row (r / BlockCount)
+
+    Interleaving the columns spreads a burst of loss over all of the blocks,
+    and interleaving the rows gives each block an equal share of the recovery
+    symbols.  The blocks are independent, so they are set up, encoded and
+    recovered as separate tasks for the application executor.
+
+    Every block must have symbols of the same size, so if the final input is
+    shorter than the others it is copied into a zero-padded buffer.
+*/
+
+#include "FecalEncoder.h"
+#include "FecalDecoder.h"
+
+namespace fecal {
+
+
+//------------------------------------------------------------------------------
+// InterleavedLayout
+
+// Largest block that fecal_interleaved_block_count() suggests
+static const unsigned kInterleavedMaxBlockInputs = 4096;
+static const uint64_t kInterleavedMaxBlockBytes = 8 * 1024 * 1024;
+
+// Suggest a number of blocks so that each block is small enough
+unsigned GetInterleavedBlockCount(unsigned input_count, uint64_t total_bytes);
+
+// Mapping from input and recovery indices to blocks
+struct InterleavedLayout
+{
+    unsigned InputCount = 0;
+    unsigned BlockCount = 0;
+    unsigned SymbolBytes = 0;
+    unsigned FinalBytes = 0;
+
+
+    // Set parameters for the layout (should be done first)
+    // Returns false if input is invalid
+    bool SetParameters(unsigned input_count, uint64_t total_bytes, unsigned block_count);
+
+    // Number of inputs in the given block
+    GF256_FORCE_INLINE unsigned GetBlockInputCount(unsigned block) const
+    {
+        return (InputCount - block + BlockCount - 1) / BlockCount;
+    }
+
+    // Offset of the first input of the block when all blocks are concatenated
+    GF256_FORCE_INLINE unsigned GetBlockStart(unsigned block) const
+    {
+        const unsigned remainder = InputCount % BlockCount;
+        return block * (InputCount / BlockCount) + (block < remainder ? block : remainder);
+    }
+
+    // Input index for the given column in the given block
+    GF256_FORCE_INLINE unsigned GetInputIndex(unsigned block, unsigned column) const
+    {
+        return column * BlockCount + block;
+    }
+
+    // Number of bytes in the given input
+    GF256_FORCE_INLINE unsigned GetInputBytes(unsigned input) const
+    {
+        return (input == InputCount - 1) ? FinalBytes : SymbolBytes;
+    }
+
+    // Is the final input padded to a full symbol?
+    GF256_FORCE_INLINE bool IsFinalPadded() const
+    {
+        return FinalBytes < SymbolBytes;
+    }
+};
+
+
+//------------------------------------------------------------------------------
+// InterleavedEncoder
+
+class InterleavedEncoder : public ICodec
+{
+public:
+    virtual ~InterleavedEncoder();
+
+    // Initialize the encoder
+    FecalResult Initialize(unsigned input_count, void* const * const input_data, uint64_t total_bytes,
+        unsigned block_count, const FecalEncoderOptions* options);
+
+    // Generate a recovery packet
+    FecalResult Encode(FecalSymbol& symbol);
+
+    // Generate recovery packets for rows firstRow..firstRow+count-1
+    FecalResult EncodeBatch(unsigned firstRow, unsigned count, FecalSymbol* symbols);
+
+protected:
+    // Mapping from input and recovery indices to blocks
+    InterleavedLayout Layout;
+
+    // Application executor for parallel work
+    FecalExecutor Executor = FecalExecutor();
+
+    // Optional shared row schedules for the blocks
+    FecalRowCache RowCache = nullptr;
+
+    // Row generation scheme for the blocks
+    FecalRowScheme RowScheme = Fecal_RowScheme_Modulo;
+
+    // Encoder for each block
+    std::vector<Encoder*> Blocks;
+
+    // Input data pointers for each block, concatenated in block order
+    std::vector<void*> BlockInputs;
+
+    // Final input padded to a full symbol
+    AlignedDataBuffer PaddedFinal;
+
+    // Result of the last task run for each block
+    std::vector<FecalResult> BlockResults;
+
+    // Batch workspace: Symbols for each block, concatenated in block order
+    std::vector<FecalSymbol> BatchSymbols;
+
+    // Batch plan: First row, number of rows, and offset in BatchSymbols for each block
+    std::vector<unsigned> BatchFirstRows;
+    std::vector<unsigned> BatchCounts;
+    std::vector<unsigned> BatchOffsets;
+
+
+    // Parallel task: Initialize one block
+    static void InitializeTask(void* context, unsigned taskIndex);
+
+    // Parallel task: Encode a batch for one block
+    static void EncodeBatchTask(void* context, unsigned taskIndex);
+};
+
+
+//------------------------------------------------------------------------------
+// InterleavedDecoder
+
+class InterleavedDecoder : public ICodec
+{
+public:
+    virtual ~InterleavedDecoder();
+
+    // Initialize the decoder
+    FecalResult Initialize(unsigned input_count, uint64_t total_bytes,
+        unsigned block_count, const FecalDecoderOptions* options);
+
+    // Add original data
+    FecalResult AddOriginal(const FecalSymbol& symbol);
+
+    // Add recovery data
+    FecalResult AddRecovery(const FecalSymbol& symbol);
+
+    // Try to decode all of the blocks
+    FecalResult Decode(RecoveredSymbols& symbols);
+
+    // Get original data
+    FecalResult GetOriginal(unsigned input_index, FecalSymbol& symbol);
+
+protected:
+    // Mapping from input and recovery indices to blocks
+    InterleavedLayout Layout;
+
+    // Application executor for parallel work
+    FecalExecutor Executor = FecalExecutor();
+
+    // Decoder for each block
+    std::vector<Decoder*> Blocks;
+
+    // Has each block recovered all of its data?
+    std::vector<bool> BlockComplete;
+
+    // Final input padded to a full symbol
+    AlignedDataBuffer PaddedFinal;
+
+    // Blocks to decode in the current Decode() call
+    std::vector<unsigned> DecodeBlocks;
+
+    // Result of the last Decode() for each block
+    std::vector<FecalResult> BlockResults;
+    std::vector<RecoveredSymbols> BlockRecovered;
+
+    // Recovered data from all blocks returned to application
+    std::vector<FecalSymbol> RecoveredData;
+
+
+    // Parallel task: Decode one block
+    static void DecodeTask(void* context, unsigned taskIndex);
+};
+
+
+} // namespace fecal
@@ -0,0 +1,220 @@
+/*
+    Copyright (c) 2017 Christopher A. Taylor.  All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice,
+      this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright notice,
+      this list of conditions and the following disclaimer in the documentation
+      and/or other materials provided with the distribution.
+    * Neither the name of Fecal nor the names of its contributors may be
+      used to endorse or promote products derived from this software without
+      specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+    ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+    LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+    CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+    SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+    CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+    ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+    POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "FecalPlanner.h"
+
+#include <map>
+#include <mutex>
+
+namespace fecal {
+
+
+//------------------------------------------------------------------------------
+// FailureTable
+
+double FailureTable::GetFailureRate(unsigned extra) const
+{
+    if (Trials <= 0)
+        return 1.;
+    if (extra > kPlanMaxExtra)
+        extra = kPlanMaxExtra;
+
+    uint64_t failures = 0;
+    for (unsigned e = extra + 1; e < static_cast<unsigned>(NeededExtra.size()); ++e)
+        failures += NeededExtra[e];
+
+    return failures / static_cast<double>(Trials);
+}
+
+
+//------------------------------------------------------------------------------
+// Planner
+
+FecalResult SimulateFailureTable(
+    unsigned inputCount,
+    unsigned lossCount,
+    FecalRowScheme rowScheme,
+    unsigned trials,
+    FailureTable& table)
+{
+    table.Trials = 0;
+    table.NeededExtra.assign(kPlanMaxExtra + 2, 0);
+
+    if (lossCount <= 0 || lossCount > inputCount ||
+        static_cast<unsigned>(rowScheme) >= Fecal_RowScheme_Count)
+    {
+        FECAL_DEBUG_BREAK; // Invalid input
+        return Fecal_InvalidInput;
+    }
+
+    // One-byte symbols: Only the rows and columns of the matrix are used
+    DecoderAppDataWindow window;
+    if (!window.SetParameters(inputCount, inputCount))
+        return Fecal_InvalidInput;
+    window.RowScheme = rowScheme;
+
+    RecoveryMatrixState matrix;
+    matrix.Window = &window;
+
+#ifdef FECAL_ENABLE_STATS
+    FecalDecoderStats stats = FecalDecoderStats();
+    matrix.Stats = &stats;
+#endif // FECAL_ENABLE_STATS
+
+    // The window only checks whether the data pointers are set
+    uint8_t placeholder = 0;
+
+    std::vector<unsigned> deck(inputCount);
+    std::vector<bool> lost(inputCount);
+
+    PCGRandom prng;
+    prng.Seed(inputCount, (static_cast<uint64_t>(lossCount) << 8) | rowScheme);
+
+    for (unsigned trial = 0; trial < trials; ++trial)
+    {
+        window.AllocateOriginals();
+        matrix.Reset();
+
+        // Pick the lost columns with a partial shuffle
+        for (unsigned i = 0; i < inputCount; ++i)
+            deck[i] = i;
+        lost.assign(inputCount, false);
+        for (unsigned i = 0; i < lossCount; ++i)
+        {
+            const unsigned j = i + prng.Next() % (inputCount - i);
+            std::swap(deck[i], deck[j]);
+            lost[deck[i]] = true;
+        }
+
+        for (unsigned column = 0; column < inputCount; ++column)
+            if (!lost[column])
+                window.AddOriginal(column, &placeholder);
+
+        // The recovery rows start anywhere, in the order they were sent
+        const unsigned firstRow = prng.Next();
+
+        unsigned extra = kPlanMaxExtra + 1;
+        for (unsigned rows = 1; rows <= lossCount + kPlanMaxExtra; ++rows)
+        {
+            window.AddRecovery(&placeholder, firstRow + rows - 1, true);
+
+            // Decoding is attempted once there are as many rows as losses
+            if (rows < lossCount)
+                continue;
+
+            bool solved;
+#ifdef FECAL_SINGLE_LOSS
+            if (lossCount == 1)
+                solved = matrix.SolveSingleLoss();
+            else
+#endif // FECAL_SINGLE_LOSS
+            {
+                if (!matrix.GenerateMatrix())
+                    return Fecal_OutOfMemory;
+                solved = matrix.GaussianElimination();
+            }
+
+            if (solved)
+            {
+                extra = rows - lossCount;
+                break;
+            }
+        }
+
+        ++table.NeededExtra[extra];
+        ++table.Trials;
+    }
+
+    return Fecal_Success;
+}
+
+// Parameters of a cached failure table
+struct FailureTableKey
+{
+    unsigned InputCount;
+    unsigned LossCount;
+    unsigned RowScheme;
+    unsigned Trials;
+
+    bool operator<(const FailureTableKey& other) const
+    {
+        if (InputCount != other.InputCount)
+            return InputCount < other.InputCount;
+        if (LossCount != other.LossCount)
+            return LossCount < other.LossCount;
+        if (RowScheme != other.RowScheme)
+            return RowScheme < other.RowScheme;
+        return Trials < other.Trials;
+    }
+};
+
+static std::mutex PlanCacheLock;
+static std::map<FailureTableKey, FailureTable> PlanCache;
+
+FecalResult GetFailureTable(
+    unsigned inputCount,
+    unsigned lossCount,
+    FecalRowScheme rowScheme,
+    unsigned trials,
+    FailureTable& table)
+{
+    if (trials <= 0)
+        trials = kPlanDefaultTrials;
+
+    FailureTableKey key;
+    key.InputCount = inputCount;
+    key.LossCount = lossCount;
+    key.RowScheme = static_cast<unsigned>(rowScheme);
+    key.Trials = trials;
+
+    {
+        std::lock_guard<std::mutex> locker(PlanCacheLock);
+        auto found = PlanCache.find(key);
+        if (found != PlanCache.end())
+        {
+            table = found->second;
+            return Fecal_Success;
+        }
+    }
+
+    // Simulate without holding the lock, since it can take a while.
+    // Two threads may both simulate a new table, and get the same result
+    const FecalResult result = SimulateFailureTable(inputCount, lossCount, rowScheme, trials, table);
+    if (result != Fecal_Success)
+        return result;
+
+    std::lock_guard<std::mutex> locker(PlanCacheLock);
+    if (PlanCache.size() >= kPlanMaxCachedTables)
+        PlanCache.clear();
+    PlanCache[key] = table;
+
+    return Fecal_Success;
+}
+
+
+} // namespace fecal
@@ -0,0 +1,113 @@
+/*
+    Copyright (c) 2017 Christopher A. Taylor.  All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice,
+      this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright notice,
+      this list of conditions and the following disclaimer in the documentation
+      and/or other materials provided with the distribution.
+    * Neither the name of Fecal nor the names of its contributors may be
+      used to endorse or promote products derived from this software without
+      specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+    ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+    LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+    CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+    SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+    CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+    ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+    POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#pragma once
+
+/*
+    Recovery Planner
+
+    The decoder fails to solve the recovery matrix about 1% of the time when
+    it has exactly as many recovery symbols as losses, and each extra recovery
+    symbol makes failure much less likely.  The planner measures this for a
+    given input_count and loss count by running the decoder's matrix steps
+    (GenerateMatrix and GaussianElimination) on random loss patterns, without
+    any symbol data.  Each simulated decode adds one recovery row at a time
+    until the matrix is solved, so one run gives the failure rate for every
+    number of extra recovery symbols:
+
+        FailureRate(extra) = Trials needing more than extra extra rows / Trials
+
+    The simulations are deterministic for each parameter set, and the tables
+    are cached so that planning for a parameter set costs one lookup after
+    the first call.
+*/
+
+#include "FecalDecoder.h"
+
+namespace fecal {
+
+
+//------------------------------------------------------------------------------
+// FailureTable
+
+// Largest number of extra recovery rows simulated beyond the loss count
+static const unsigned kPlanMaxExtra = 32;
+
+// Number of simulated decodes when the application does not choose
+static const unsigned kPlanDefaultTrials = 1000;
+
+// Number of cached tables, after which the cache is emptied
+static const unsigned kPlanMaxCachedTables = 1024;
+
+// Distribution of the extra recovery rows needed to decode
+struct FailureTable
+{
+    // Number of simulated decodes
+    unsigned Trials = 0;
+
+    // Number of trials that needed exactly e extra rows, for e <= kPlanMaxExtra.
+    // The last entry counts the trials that needed more than kPlanMaxExtra
+    std::vector<unsigned> NeededExtra;
+
+
+    // Fraction of the trials that failed with the given number of extra rows.
+    // Past kPlanMaxExtra this is the rate at kPlanMaxExtra, an upper bound
+    double GetFailureRate(unsigned extra) const;
+};
+
+
+//------------------------------------------------------------------------------
+// Planner
+
+/*
+    Get the failure table for the parameters, simulating it on first use.
+    Safe to call from any thread.
+
+    Returns Fecal_InvalidInput if the parameters are invalid.
+    Returns Fecal_OutOfMemory if the recovery matrix could not be allocated.
+*/
+FecalResult GetFailureTable(
+    unsigned inputCount,
+    unsigned lossCount,
+    FecalRowScheme rowScheme,
+    unsigned trials,
+    FailureTable& table);
+
+/*
+    Run trials simulated decodes of the recovery matrix for the parameters,
+    and count the extra rows each one needed.  This does not use the cache.
+*/
+FecalResult SimulateFailureTable(
+    unsigned inputCount,
+    unsigned lossCount,
+    FecalRowScheme rowScheme,
+    unsigned trials,
+    FailureTable& table);
+
+
+} // namespace fecal
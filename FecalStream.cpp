@@ -0,0 +1,860 @@
+/*
+    Copyright (c) 2017 Christopher A. Taylor.  All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice,
+      this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright notice,
+      this list of conditions and the following disclaimer in the documentation
+      and/or other materials provided with the distribution.
+    * Neither the name of Fecal nor the names of its contributors may be
+      used to endorse or promote products derived from this software without
+      specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+    ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+    LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+    CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+    SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+    CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+    ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+    POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "FecalStream.h"
+
+namespace fecal {
+
+
+//------------------------------------------------------------------------------
+// StreamWindow
+
+bool StreamWindow::SetParameters(unsigned symbolBytes, unsigned windowMax)
+{
+    if (symbolBytes <= 0 || symbolBytes > kMaxSymbolBytes || windowMax <= 0 || windowMax > kStreamWindowLimit)
+    {
+        FECAL_DEBUG_BREAK; // Invalid input
+        return false;
+    }
+
+    SymbolBytes = symbolBytes;
+    WindowMax = windowMax;
+    Start = 0;
+    Count = 0;
+
+    unsigned slots = 1;
+    while (slots < windowMax)
+        slots <<= 1;
+
+    OriginalData.assign(slots, nullptr);
+    RingMask = slots - 1;
+
+    return true;
+}
+
+
+//------------------------------------------------------------------------------
+// StreamLaneSums
+
+bool StreamLaneSums::Initialize(unsigned symbolBytes)
+{
+    if (!Slab.Allocate(symbolBytes))
+        return false;
+    Slab.Clear();
+
+    return true;
+}
+
+void StreamLaneSums::Toggle(unsigned sequence, const uint8_t* data, unsigned symbolBytes)
+{
+    const unsigned laneIndex = sequence % kColumnLaneCount;
+    const uint8_t CX = GetColumnValue(sequence);
+
+    // Sum[0] += Data
+    Slab.MulAdd(laneIndex, 0, 1, data, symbolBytes);
+
+    // Sum[1] += CX * Data
+    Slab.MulAdd(laneIndex, 1, CX, data, symbolBytes);
+
+    // Sum[2] += CX^2 * Data
+    Slab.MulAdd(laneIndex, 2, gf256_sqr(CX), data, symbolBytes);
+
+    static_assert(kColumnSumCount == 3, "Update this");
+}
+
+void StreamLaneSums::Schedule(unsigned row, SumSchedule& sum, SumSchedule& prod) const
+{
+    // For each lane:
+    for (unsigned laneIndex = 0; laneIndex < kColumnLaneCount; ++laneIndex)
+    {
+        // Compute the operations to run for this lane and row
+        const unsigned opcode = GetRowOpcode(laneIndex, row);
+
+        // Sum += Random Lanes
+        unsigned mask = 1;
+        for (unsigned sumIndex = 0; sumIndex < kColumnSumCount; ++sumIndex, mask <<= 1)
+            if (opcode & mask)
+                sum.AddLaneSum(Slab, laneIndex, sumIndex);
+
+        // Product += Random Lanes
+        for (unsigned sumIndex = 0; sumIndex < kColumnSumCount; ++sumIndex, mask <<= 1)
+            if (opcode & mask)
+                prod.AddLaneSum(Slab, laneIndex, sumIndex);
+    }
+}
+
+uint8_t GetLaneCoefficient(unsigned row, uint8_t RX, unsigned column)
+{
+    const uint8_t CX = GetColumnValue(column);
+    const uint8_t CX2 = gf256_sqr(CX);
+    const unsigned opcode = GetRowOpcode(column % kColumnLaneCount, row);
+
+    unsigned value = opcode & 1;
+    if (opcode & 2)
+        value ^= CX;
+    if (opcode & 4)
+        value ^= CX2;
+    if (opcode & 8)
+        value ^= RX;
+    if (opcode & 16)
+        value ^= gf256_mul(CX, RX);
+    if (opcode & 32)
+        value ^= gf256_mul(CX2, RX);
+
+    return (uint8_t)value;
+}
+
+
+//------------------------------------------------------------------------------
+// StreamEncoder
+
+FecalResult StreamEncoder::Initialize(unsigned symbolBytes, unsigned windowMax)
+{
+    if (!Window.SetParameters(symbolBytes, windowMax))
+    {
+        FECAL_DEBUG_BREAK; // Invalid input
+        return Fecal_InvalidInput;
+    }
+
+    if (!LaneSums.Initialize(symbolBytes))
+        return Fecal_OutOfMemory;
+
+    NextRow = 0;
+
+    return Fecal_Success;
+}
+
+FecalResult StreamEncoder::AddOriginal(FecalSymbol& symbol)
+{
+    if (symbol.Data == nullptr ||
+        symbol.Bytes != Window.SymbolBytes)
+    {
+        FECAL_DEBUG_BREAK; // Invalid input
+        return Fecal_InvalidInput;
+    }
+
+    if (Window.Count >= Window.WindowMax)
+        RemoveOldest();
+
+    const unsigned sequence = Window.Start + Window.Count;
+    const uint8_t* data = reinterpret_cast<const uint8_t*>( symbol.Data );
+
+    Window.Original(sequence) = data;
+    ++Window.Count;
+
+    LaneSums.Toggle(sequence, data, Window.SymbolBytes);
+
+    symbol.Index = sequence;
+
+    return Fecal_Success;
+}
+
+void StreamEncoder::RemoveOldest()
+{
+    FECAL_DEBUG_ASSERT(Window.Count > 0);
+
+    const unsigned sequence = Window.Start;
+    LaneSums.Toggle(sequence, Window.Original(sequence), Window.SymbolBytes);
+    Window.Original(sequence) = nullptr;
+
+    ++Window.Start;
+    --Window.Count;
+}
+
+FecalResult StreamEncoder::RemoveBefore(unsigned sequence)
+{
+    // If encoder is not initialized:
+    if (!LaneSums.Slab.Buffer.Data)
+        return Fecal_InvalidInput;
+
+    // If these originals were already removed:
+    if (IsSequenceBefore(sequence, Window.Start))
+        return Fecal_Success;
+
+    const unsigned removeCount = sequence - Window.Start;
+
+    // If the whole window is removed, clearing the sums is cheaper
+    if (removeCount >= Window.Count)
+    {
+        for (unsigned i = 0; i < Window.Count; ++i)
+            Window.Original(Window.Start + i) = nullptr;
+
+        Window.Start = sequence;
+        Window.Count = 0;
+
+        if (!LaneSums.Initialize(Window.SymbolBytes))
+            return Fecal_OutOfMemory;
+
+        return Fecal_Success;
+    }
+
+    for (unsigned i = 0; i < removeCount; ++i)
+        RemoveOldest();
+
+    return Fecal_Success;
+}
+
+FecalResult StreamEncoder::Encode(FecalStreamRecovery& symbol)
+{
+    // If encoder is not initialized:
+    if (!LaneSums.Slab.Buffer.Data)
+        return Fecal_InvalidInput;
+
+    const unsigned symbolBytes = Window.SymbolBytes;
+    if (symbol.Data == nullptr || symbol.Bytes != symbolBytes)
+        return Fecal_InvalidInput;
+
+    const unsigned count = Window.Count;
+    if (count <= 0)
+        return Fecal_NeedMoreData;
+
+    const unsigned start = Window.Start;
+    const unsigned row = NextRow++;
+    uint8_t* outputSum = reinterpret_cast<uint8_t*>( symbol.Data );
+
+    // Record the sources of the two sums, to replay for each stripe
+    SumSchedule& sum = EncodeSumSchedule;
+    SumSchedule& prod = EncodeProductSchedule;
+    sum.Clear();
+    prod.Clear();
+
+    // Initialize LDPC
+    PCGRandom prng;
+    prng.Seed(row, count);
+
+    // Accumulate original data into the two sums
+    const unsigned pairCount = (count + kPairAddRate - 1) / kPairAddRate;
+    for (unsigned i = 0; i < pairCount; ++i)
+    {
+        // Sum += Original[element1]
+        const unsigned element1 = start + prng.Next() % count;
+        sum.Add(Window.Original(element1));
+
+        // Product += Original[elementRX]
+        const unsigned elementRX = start + prng.Next() % count;
+        prod.Add(Window.Original(elementRX));
+    }
+
+    LaneSums.Schedule(row, sum, prod);
+
+    const uint8_t RX = GetRowValue(row);
+
+    // Output = Sum + RX * Product
+    sum.StoreWithProduct(outputSum, RX, prod, 0, symbolBytes);
+
+    symbol.Row = row;
+    symbol.WindowStart = start;
+    symbol.WindowCount = count;
+
+    return Fecal_Success;
+}
+
+
+//------------------------------------------------------------------------------
+// StreamDecoder
+
+FecalResult StreamDecoder::Initialize(unsigned symbolBytes, unsigned windowMax)
+{
+    if (!Window.SetParameters(symbolBytes, windowMax))
+    {
+        FECAL_DEBUG_BREAK; // Invalid input
+        return Fecal_InvalidInput;
+    }
+
+    // The window can straddle one more subwindow than it fills
+    const unsigned minSubwindows = (windowMax + kSubwindowSize - 1) / kSubwindowSize + 1;
+    unsigned subwindows = 1;
+    while (subwindows < minSubwindows)
+        subwindows <<= 1;
+
+    Subwindows.clear();
+    Subwindows.resize(subwindows);
+    SubwindowMask = subwindows - 1;
+
+    if (!LaneSums.Initialize(symbolBytes))
+        return Fecal_OutOfMemory;
+
+    for (StreamRecoveryInfo& recovery : Recovery)
+        recovery.Active = false;
+    RecoveryAttempted = false;
+
+    return Fecal_Success;
+}
+
+unsigned StreamDecoder::FindNextLost(unsigned sequence, unsigned end) const
+{
+    while (sequence != end)
+    {
+        const Subwindow& subwindow = Subwindows[(sequence / kSubwindowSize) & SubwindowMask];
+        const unsigned bitIndex = sequence % kSubwindowSize;
+
+        // If there may be any lost packets in this subwindow:
+        if (subwindow.GotCount < kSubwindowSize)
+        {
+            const unsigned lostBit = subwindow.Got.FindFirstClear(bitIndex);
+            if (lostBit < kSubwindowSize)
+            {
+                const unsigned lost = sequence + (lostBit - bitIndex);
+                return (lost - sequence < end - sequence) ? lost : end;
+            }
+        }
+
+        // Check next subwindow
+        const unsigned step = kSubwindowSize - bitIndex;
+        if (step >= end - sequence)
+            break;
+        sequence += step;
+    }
+
+    return end;
+}
+
+void StreamDecoder::SlideWindowTo(unsigned sequence)
+{
+    FECAL_DEBUG_ASSERT(!IsSequenceBefore(sequence, Window.Start));
+
+    const unsigned offset = sequence - Window.Start;
+    if (offset < Window.Count)
+        return;
+
+    // Remove the oldest originals to make room
+    if (offset >= Window.WindowMax)
+        SlideStartTo(sequence - Window.WindowMax + 1);
+
+    Window.Count = sequence - Window.Start + 1;
+}
+
+void StreamDecoder::SlideStartTo(unsigned sequence)
+{
+    const unsigned start = Window.Start;
+    const unsigned end = start + Window.Count;
+    unsigned removeCount = sequence - start;
+    if (removeCount > Window.Count)
+        removeCount = Window.Count;
+    const unsigned removeEnd = start + removeCount;
+
+    // For each recovery symbol that covers originals being removed:
+    for (StreamRecoveryInfo& recovery : Recovery)
+    {
+        if (!recovery.Active || !IsSequenceBefore(recovery.WindowStart, sequence))
+            continue;
+
+        // If it covers originals that were lost, they cannot be recovered
+        const unsigned windowEnd = recovery.WindowStart + recovery.WindowCount;
+        const unsigned lostEnd = IsSequenceBefore(windowEnd, removeEnd) ? windowEnd : removeEnd;
+        if (recovery.WindowStart != lostEnd &&
+            FindNextLost(recovery.WindowStart, lostEnd) != lostEnd)
+        {
+            recovery.Active = false;
+            continue;
+        }
+
+        // Otherwise trim the removed part, which was already eliminated
+        const unsigned trimCount = sequence - recovery.WindowStart;
+        FECAL_DEBUG_ASSERT(trimCount < recovery.WindowCount);
+        recovery.Coefficients.erase(
+            recovery.Coefficients.begin(),
+            recovery.Coefficients.begin() + trimCount);
+        recovery.WindowStart = sequence;
+        recovery.WindowCount -= trimCount;
+    }
+
+    // Remove originals from the lane sums and the ring
+    for (unsigned i = start; i != removeEnd; ++i)
+    {
+        Subwindow& subwindow = Subwindows[(i / kSubwindowSize) & SubwindowMask];
+        const unsigned bitIndex = i % kSubwindowSize;
+        if (!subwindow.Got.Check(bitIndex))
+            continue;
+
+        LaneSums.Toggle(i, Window.Original(i), Window.SymbolBytes);
+        Window.Original(i) = nullptr;
+
+        subwindow.Got.Clear(bitIndex);
+        subwindow.GotCount--;
+    }
+
+    Window.Start = sequence;
+    Window.Count = (removeEnd == end) ? 0 : end - sequence;
+}
+
+FecalResult StreamDecoder::AddOriginal(const FecalSymbol& symbol)
+{
+    if (symbol.Data == nullptr ||
+        symbol.Bytes != Window.SymbolBytes)
+    {
+        FECAL_DEBUG_BREAK; // Invalid input
+        return Fecal_InvalidInput;
+    }
+
+    const unsigned sequence = symbol.Index;
+
+    // Ignore originals from before the window
+    if (IsSequenceBefore(sequence, Window.Start))
+        return Fecal_Success;
+
+    SlideWindowTo(sequence);
+
+    if (!IsReceived(sequence))
+    {
+        StoreOriginal(sequence, reinterpret_cast<const uint8_t*>( symbol.Data ));
+        RecoveryAttempted = false;
+    }
+
+    return Fecal_Success;
+}
+
+void StreamDecoder::StoreOriginal(unsigned sequence, const uint8_t* data)
+{
+    FECAL_DEBUG_ASSERT(Window.Contains(sequence) && !IsReceived(sequence));
+
+    Window.Original(sequence) = data;
+
+    Subwindow& subwindow = Subwindows[(sequence / kSubwindowSize) & SubwindowMask];
+    subwindow.Got.Set(sequence % kSubwindowSize);
+    subwindow.GotCount++;
+
+    const unsigned symbolBytes = Window.SymbolBytes;
+    LaneSums.Toggle(sequence, data, symbolBytes);
+
+    // Eliminate it from each recovery symbol that is waiting for it
+    for (StreamRecoveryInfo& recovery : Recovery)
+    {
+        if (!recovery.Active || !recovery.Covers(sequence))
+            continue;
+
+        const uint8_t y = recovery.Coefficients[sequence - recovery.WindowStart];
+        if (y != 0)
+            gf256_muladd_mem(recovery.Data, y, data, symbolBytes);
+
+        // If nothing is left to recover, the recovery symbol is useless
+        if (--recovery.LostCount <= 0)
+            recovery.Active = false;
+    }
+}
+
+FecalResult StreamDecoder::AddRecovery(const FecalStreamRecovery& symbol)
+{
+    if (symbol.Data == nullptr ||
+        symbol.Bytes != Window.SymbolBytes ||
+        symbol.WindowCount <= 0 ||
+        symbol.WindowCount > Window.WindowMax)
+    {
+        FECAL_DEBUG_BREAK; // Invalid input
+        return Fecal_InvalidInput;
+    }
+
+    const unsigned windowStart = symbol.WindowStart;
+    const unsigned windowCount = symbol.WindowCount;
+
+    // Ignore recovery symbols that cover originals from before the window,
+    // since some of them may have been lost
+    if (IsSequenceBefore(windowStart, Window.Start))
+        return Fecal_Success;
+
+    SlideWindowTo(windowStart + windowCount - 1);
+    FECAL_DEBUG_ASSERT(Window.Contains(windowStart));
+
+    // Find an unused slot, checking for duplicates
+    unsigned slot = static_cast<unsigned>(Recovery.size());
+    for (unsigned i = 0, count = slot; i < count; ++i)
+    {
+        if (!Recovery[i].Active)
+            slot = i;
+        else if (Recovery[i].Row == symbol.Row)
+            return Fecal_Success;
+    }
+    if (slot >= Recovery.size())
+        Recovery.resize(slot + 1);
+
+    StreamRecoveryInfo& recovery = Recovery[slot];
+    recovery.Data = reinterpret_cast<uint8_t*>( symbol.Data );
+    recovery.Row = symbol.Row;
+    recovery.WindowStart = windowStart;
+    recovery.WindowCount = windowCount;
+
+    const unsigned row = symbol.Row;
+    const uint8_t RX = GetRowValue(row);
+
+    // Fill in the coefficients from the lane sums
+    recovery.Coefficients.resize(windowCount);
+    uint8_t* coefficients = &recovery.Coefficients[0];
+    unsigned lostCount = 0;
+    for (unsigned i = 0; i < windowCount; ++i)
+    {
+        coefficients[i] = GetLaneCoefficient(row, RX, windowStart + i);
+        if (!IsReceived(windowStart + i))
+            ++lostCount;
+    }
+
+    // If nothing was lost, the recovery symbol is useless
+    if (lostCount <= 0)
+        return Fecal_Success;
+
+    // Add the light pairs
+    PCGRandom prng;
+    prng.Seed(row, windowCount);
+
+    const unsigned pairCount = (windowCount + kPairAddRate - 1) / kPairAddRate;
+    for (unsigned i = 0; i < pairCount; ++i)
+    {
+        coefficients[prng.Next() % windowCount] ^= 1;
+        coefficients[prng.Next() % windowCount] ^= RX;
+    }
+
+    recovery.LostCount = lostCount;
+
+    EliminateReceived(recovery);
+
+    recovery.Active = true;
+    RecoveryAttempted = false;
+
+    return Fecal_Success;
+}
+
+void StreamDecoder::EliminateReceived(StreamRecoveryInfo& recovery)
+{
+    const unsigned symbolBytes = Window.SymbolBytes;
+    const unsigned windowStart = recovery.WindowStart;
+    const unsigned windowCount = recovery.WindowCount;
+    const unsigned windowEnd = windowStart + windowCount;
+    const unsigned receivedCount = windowCount - recovery.LostCount;
+    const unsigned pairCount = (windowCount + kPairAddRate - 1) / kPairAddRate;
+
+    // Count the received originals outside of the recovery window, which the
+    // lane sums would include and so would need to be removed again
+    unsigned outsideCount = 0;
+    for (unsigned i = Window.Start; i != windowStart; ++i)
+        if (IsReceived(i))
+            ++outsideCount;
+    for (unsigned i = windowEnd, end = Window.Start + Window.Count; i != end; ++i)
+        if (IsReceived(i))
+            ++outsideCount;
+
+    // If it is cheaper to eliminate the received originals one at a time:
+    if (receivedCount <= outsideCount + kColumnLaneCount * kColumnSumCount + pairCount * 2)
+    {
+        for (unsigned i = 0; i < windowCount; ++i)
+        {
+            const unsigned sequence = windowStart + i;
+            const uint8_t y = recovery.Coefficients[i];
+            if (y != 0 && IsReceived(sequence))
+                gf256_muladd_mem(recovery.Data, y, Window.Original(sequence), symbolBytes);
+        }
+        return;
+    }
+
+    const unsigned row = recovery.Row;
+    const uint8_t RX = GetRowValue(row);
+
+    SumSchedule& sum = EliminateSum;
+    SumSchedule& prod = EliminateProduct;
+    sum.Clear();
+    prod.Clear();
+
+    // Sum += Received originals in the light pairs
+    PCGRandom prng;
+    prng.Seed(row, windowCount);
+
+    for (unsigned i = 0; i < pairCount; ++i)
+    {
+        const unsigned element1 = windowStart + prng.Next() % windowCount;
+        if (IsReceived(element1))
+            sum.Add(Window.Original(element1));
+
+        const unsigned elementRX = windowStart + prng.Next() % windowCount;
+        if (IsReceived(elementRX))
+            prod.Add(Window.Original(elementRX));
+    }
+
+    LaneSums.Schedule(row, sum, prod);
+
+    // Recovery += Sum + RX * Product
+    sum.AccumulateWithProduct(recovery.Data, RX, prod, 0, symbolBytes);
+
+    // Remove the originals outside of the recovery window again
+    for (unsigned i = Window.Start; i != windowStart; ++i)
+        if (IsReceived(i))
+            gf256_muladd_mem(recovery.Data, GetLaneCoefficient(row, RX, i), Window.Original(i), symbolBytes);
+    for (unsigned i = windowEnd, end = Window.Start + Window.Count; i != end; ++i)
+        if (IsReceived(i))
+            gf256_muladd_mem(recovery.Data, GetLaneCoefficient(row, RX, i), Window.Original(i), symbolBytes);
+}
+
+FecalResult StreamDecoder::RemoveBefore(unsigned sequence)
+{
+    // If decoder is not initialized:
+    if (!LaneSums.Slab.Buffer.Data)
+        return Fecal_InvalidInput;
+
+    if (!IsSequenceBefore(sequence, Window.Start))
+    {
+        SlideStartTo(sequence);
+        RecoveryAttempted = false;
+    }
+
+    return Fecal_Success;
+}
+
+FecalResult StreamDecoder::GetOriginal(unsigned sequence, FecalSymbol& symbol)
+{
+    symbol.Index = sequence;
+    symbol.Data = nullptr;
+    symbol.Bytes = 0;
+
+    if (!Window.Contains(sequence) || !IsReceived(sequence))
+        return Fecal_NeedMoreData;
+
+    symbol.Data = const_cast<uint8_t*>( Window.Original(sequence) );
+    symbol.Bytes = Window.SymbolBytes;
+    return Fecal_Success;
+}
+
+FecalResult StreamDecoder::Decode(RecoveredSymbols& symbols)
+{
+    // Default return values
+    symbols.Symbols = nullptr;
+    symbols.Count = 0;
+
+    // If recovery was already attempted:
+    if (RecoveryAttempted)
+        return Fecal_NeedMoreData;
+    RecoveryAttempted = true;
+
+    RecoveredData.clear();
+
+    // Find the range of lost originals for each recovery symbol
+    MatrixRows.clear();
+    for (unsigned i = 0, count = static_cast<unsigned>(Recovery.size()); i < count; ++i)
+    {
+        StreamRecoveryInfo& recovery = Recovery[i];
+        if (!recovery.Active)
+            continue;
+
+        const unsigned windowEnd = recovery.WindowStart + recovery.WindowCount;
+        unsigned lost = FindNextLost(recovery.WindowStart, windowEnd);
+        FECAL_DEBUG_ASSERT(lost != windowEnd);
+        recovery.FirstLost = lost;
+        for (; lost != windowEnd; lost = FindNextLost(lost + 1, windowEnd))
+            recovery.LastLost = lost;
+
+        MatrixRows.push_back(i);
+    }
+
+    // Sort the recovery symbols by their first lost original
+    const unsigned start = Window.Start;
+    std::sort(MatrixRows.begin(), MatrixRows.end(), [this, start](unsigned a, unsigned b) {
+        return Recovery[a].FirstLost - start < Recovery[b].FirstLost - start;
+    });
+
+    // Recovery symbols that do not share any lost originals with the others
+    // can be solved separately, so a burst of loss that cannot be recovered
+    // yet does not hold up recovery of earlier losses
+    const unsigned rows = static_cast<unsigned>(MatrixRows.size());
+    for (unsigned first = 0; first < rows;)
+    {
+        unsigned lastLost = Recovery[MatrixRows[first]].LastLost;
+        unsigned end = first + 1;
+        for (; end < rows; ++end)
+        {
+            const StreamRecoveryInfo& recovery = Recovery[MatrixRows[end]];
+            if (recovery.FirstLost - start > lastLost - start)
+                break;
+            if (recovery.LastLost - start > lastLost - start)
+                lastLost = recovery.LastLost;
+        }
+
+        RecoverCluster(first, end);
+        first = end;
+    }
+
+    if (RecoveredData.empty())
+        return Fecal_NeedMoreData;
+
+    symbols.Symbols = &RecoveredData[0];
+    symbols.Count = static_cast<unsigned>(RecoveredData.size());
+
+    return Fecal_Success;
+}
+
+void StreamDecoder::RecoverCluster(unsigned first, unsigned end)
+{
+    const unsigned firstLost = Recovery[MatrixRows[first]].FirstLost;
+    unsigned lastLost = firstLost;
+    for (unsigned i = first; i < end; ++i)
+        if (Recovery[MatrixRows[i]].LastLost - firstLost > lastLost - firstLost)
+            lastLost = Recovery[MatrixRows[i]].LastLost;
+
+    // List the lost originals
+    MatrixColumns.clear();
+    for (unsigned lost = firstLost; lost != lastLost + 1; lost = FindNextLost(lost + 1, lastLost + 1))
+        MatrixColumns.push_back(lost);
+
+    const unsigned rows = end - first;
+    const unsigned columns = static_cast<unsigned>(MatrixColumns.size());
+
+    // If we have not received enough data to try to decode:
+    if (rows < columns)
+        return;
+
+    if (!Matrix.Initialize(rows, columns))
+        return;
+
+    // Fill in the coefficients of the lost originals for each row
+    Pivots.resize(rows);
+    for (unsigned i = 0; i < rows; ++i)
+    {
+        const unsigned recoveryIndex = MatrixRows[first + i];
+        const StreamRecoveryInfo& recovery = Recovery[recoveryIndex];
+        uint8_t* rowData = Matrix.GetRow(i);
+
+        for (unsigned j = 0; j < columns; ++j)
+        {
+            const unsigned column = MatrixColumns[j];
+            rowData[j] = recovery.Covers(column) ? recovery.Coefficients[column - recovery.WindowStart] : 0;
+        }
+
+        Pivots[i] = i;
+    }
+
+    if (!SolveMatrix())
+        return;
+
+    RecoverData(first);
+}
+
+bool StreamDecoder::SolveMatrix()
+{
+    const unsigned columns = Matrix.Columns;
+    const unsigned rows = Matrix.Rows;
+
+    // For each pivot to determine:
+    for (unsigned pivot_i = 0; pivot_i < columns; ++pivot_i)
+    {
+        // Find a row with a non-zero element in the pivot column
+        unsigned pivot_j = pivot_i;
+        for (; pivot_j < rows; ++pivot_j)
+            if (Matrix.Get(Pivots[pivot_j], pivot_i) != 0)
+                break;
+
+        if (pivot_j >= rows)
+            return false;
+
+        // Swap out the pivot index for this one
+        std::swap(Pivots[pivot_i], Pivots[pivot_j]);
+
+        const uint8_t* ge_row = Matrix.GetRow(Pivots[pivot_i]);
+        const uint8_t val_i = ge_row[pivot_i];
+
+        // For each remaining row:
+        for (unsigned pivot_k = pivot_i + 1; pivot_k < rows; ++pivot_k)
+        {
+            uint8_t* rem_row = Matrix.GetRow(Pivots[pivot_k]);
+
+            // Skip if the element k,i is already zero
+            const uint8_t val_k = rem_row[pivot_i];
+            if (val_k == 0)
+                continue;
+
+            // Remember what value was used to zero element k,i
+            const uint8_t y = gf256_div(val_k, val_i);
+            rem_row[pivot_i] = y;
+
+            gf256_muladd_mem(rem_row + pivot_i + 1, y, ge_row + pivot_i + 1, columns - pivot_i - 1);
+        }
+    }
+
+    return true;
+}
+
+void StreamDecoder::RecoverData(unsigned first)
+{
+    const unsigned columns = Matrix.Columns;
+    const unsigned symbolBytes = Window.SymbolBytes;
+    const unsigned* clusterRows = &MatrixRows[first];
+
+    // Multiply lower triangle following solution order from left to right:
+    for (unsigned col_i = 0; col_i < columns - 1; ++col_i)
+    {
+        const uint8_t* srcData = Recovery[clusterRows[Pivots[col_i]]].Data;
+
+        for (unsigned col_j = col_i + 1; col_j < columns; ++col_j)
+        {
+            const unsigned matrixRowIndex_j = Pivots[col_j];
+            const uint8_t y = Matrix.Get(matrixRowIndex_j, col_i);
+
+            if (y != 0)
+                gf256_muladd_mem(Recovery[clusterRows[matrixRowIndex_j]].Data, y, srcData, symbolBytes);
+        }
+    }
+
+    // For each column starting with the right-most column:
+    for (int col_i = columns - 1; col_i >= 0; --col_i)
+    {
+        const unsigned matrixRowIndex = Pivots[col_i];
+        uint8_t* recovery = Recovery[clusterRows[matrixRowIndex]].Data;
+        const uint8_t y = Matrix.Get(matrixRowIndex, col_i);
+        FECAL_DEBUG_ASSERT(y != 0);
+
+        gf256_div_mem(recovery, recovery, y, symbolBytes);
+
+        // Eliminate from all other pivot rows above it:
+        for (unsigned col_j = 0; col_j < (unsigned)col_i; ++col_j)
+        {
+            const unsigned matrixRowIndex_j = Pivots[col_j];
+            const uint8_t x = Matrix.Get(matrixRowIndex_j, col_i);
+
+            if (x != 0)
+                gf256_muladd_mem(Recovery[clusterRows[matrixRowIndex_j]].Data, x, recovery, symbolBytes);
+        }
+    }
+
+    // The pivot rows now hold the originals, so they are no longer recovery data
+    for (unsigned col_i = 0; col_i < columns; ++col_i)
+        Recovery[clusterRows[Pivots[col_i]]].Active = false;
+
+    // Treat recovered originals as received, which also eliminates them from
+    // the other recovery symbols
+    for (unsigned col_i = 0; col_i < columns; ++col_i)
+    {
+        uint8_t* recovery = Recovery[clusterRows[Pivots[col_i]]].Data;
+        const unsigned sequence = MatrixColumns[col_i];
+
+        StoreOriginal(sequence, recovery);
+
+        // Write recovered packet data
+        FecalSymbol symbol;
+        symbol.Data = recovery;
+        symbol.Bytes = symbolBytes;
+        symbol.Index = sequence;
+        RecoveredData.push_back(symbol);
+    }
+}
+
+
+} // namespace fecal
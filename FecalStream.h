@@ -0,0 +1,311 @@
+/*
+    Copyright (c) 2017 Christopher A. Taylor.  All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice,
+      this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright notice,
+      this list of conditions and the following disclaimer in the documentation
+      and/or other materials provided with the distribution.
+    * Neither the name of Fecal nor the names of its contributors may be
+      used to endorse or promote products derived from this software without
+      specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+    ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+    LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+    CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+    SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+    CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+    ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+    POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#pragma once
+
+/*
+    Streaming Codec
+
+    The streaming codec applies the same code to a sliding window of original
+    data rather than a fixed block.  Originals are numbered with a sequence
+    number that counts up from 0 and wraps around at 2^32, and the column of
+    an original is its sequence number.  Each recovery symbol covers the range
+    of sequence numbers that was in the encoder window when it was generated:
+
+        Recovery = Sum(Lane sums selected by the row opcode)
+                 + RX * Sum(Lane product sums selected by the row opcode)
+                 + Light sums of random pairs drawn from the window
+
+    Each lane sum covers the originals in the window, so when an original
+    enters or leaves the window it is added into or removed from the three
+    sums of its lane, which is the same operation in GF(2^^8).  The cost of
+    each packet is then bounded by the window size rather than growing with
+    the length of the stream.
+
+    The decoder keeps the same lane sums for the originals it received in its
+    own window.  As each recovery symbol arrives the received originals are
+    eliminated from it, using the lane sums with a few corrections for the
+    ends of its range that differ from the decoder window, or directly if
+    that is cheaper.  Originals that arrive later are eliminated from the
+    stored recovery symbols as they arrive, so what remains in each recovery
+    symbol is a combination of the lost originals in its range.
+
+    Decoding builds a matrix from the lost originals covered by the stored
+    recovery symbols and solves it as in the block decoder.  The recovered
+    originals are then treated as if they had been received.
+*/
+
+#include "FecalCommon.h"
+#include "FecalDecoder.h"
+
+namespace fecal {
+
+
+//------------------------------------------------------------------------------
+// StreamWindow
+
+// Largest supported window, which keeps sequence number comparisons simple
+static const unsigned kStreamWindowLimit = 65536;
+
+// Is sequence number a before sequence number b, allowing for wrap-around?
+GF256_FORCE_INLINE bool IsSequenceBefore(unsigned a, unsigned b)
+{
+    return (int32_t)(a - b) < 0;
+}
+
+// Window of original data for sequence numbers Start..(Start + Count - 1)
+struct StreamWindow
+{
+    // Number of bytes in each symbol
+    unsigned SymbolBytes = 0;
+
+    // Maximum number of sequence numbers in the window
+    unsigned WindowMax = 0;
+
+    // First sequence number in the window
+    unsigned Start = 0;
+
+    // Number of sequence numbers in the window
+    unsigned Count = 0;
+
+    // Ring of original data indexed by sequence number & RingMask,
+    // where the number of slots is a power of two
+    std::vector<const uint8_t*> OriginalData;
+    unsigned RingMask = 0;
+
+
+    // Set parameters for the window (should be done first)
+    // Returns false if input is invalid
+    bool SetParameters(unsigned symbolBytes, unsigned windowMax);
+
+    // Is the sequence number within the window?
+    GF256_FORCE_INLINE bool Contains(unsigned sequence) const
+    {
+        return sequence - Start < Count;
+    }
+
+    // Original data slot for a sequence number within the window
+    GF256_FORCE_INLINE const uint8_t*& Original(unsigned sequence)
+    {
+        return OriginalData[sequence & RingMask];
+    }
+};
+
+
+//------------------------------------------------------------------------------
+// StreamLaneSums
+
+// Lane sums over the originals in a stream window
+struct StreamLaneSums
+{
+    LaneSumSlab Slab;
+
+
+    // Allocate and clear the sums
+    bool Initialize(unsigned symbolBytes);
+
+    // Add or remove an original, which are the same operation
+    void Toggle(unsigned sequence, const uint8_t* data, unsigned symbolBytes);
+
+    // Add the lane sums selected by the row opcodes to a schedule
+    void Schedule(unsigned row, SumSchedule& sum, SumSchedule& prod) const;
+};
+
+// Coefficient of a column from the lane sums selected by the row opcode
+uint8_t GetLaneCoefficient(unsigned row, uint8_t RX, unsigned column);
+
+
+//------------------------------------------------------------------------------
+// StreamEncoder
+
+class StreamEncoder : public ICodec
+{
+public:
+    virtual ~StreamEncoder() {}
+
+    // Initialize the encoder
+    FecalResult Initialize(unsigned symbolBytes, unsigned windowMax);
+
+    // Add the next original to the window, setting symbol.Index
+    FecalResult AddOriginal(FecalSymbol& symbol);
+
+    // Remove originals before the given sequence number from the window
+    FecalResult RemoveBefore(unsigned sequence);
+
+    // Generate the next recovery symbol over the current window
+    FecalResult Encode(FecalStreamRecovery& symbol);
+
+protected:
+    // Window of original data
+    StreamWindow Window;
+
+    // Sums for each lane over the window
+    StreamLaneSums LaneSums;
+
+    // Row number for the next recovery symbol
+    unsigned NextRow = 0;
+
+    // Sources of the sum and product for Encode()
+    SumSchedule EncodeSumSchedule;
+    SumSchedule EncodeProductSchedule;
+
+
+    // Remove the oldest original from the window
+    void RemoveOldest();
+};
+
+
+//------------------------------------------------------------------------------
+// StreamDecoder
+
+// Recovery symbol stored by the decoder
+struct StreamRecoveryInfo
+{
+    // Received recovery data, which becomes a sum of the lost originals
+    uint8_t* Data = nullptr;
+
+    // Recovery row number
+    unsigned Row = 0;
+
+    // Window that the recovery symbol covers
+    unsigned WindowStart = 0;
+    unsigned WindowCount = 0;
+
+    // Number of originals in the window that are still lost
+    unsigned LostCount = 0;
+
+    // Is this slot in use?
+    bool Active = false;
+
+    // First and last lost originals in the window, updated by Decode()
+    unsigned FirstLost = 0;
+    unsigned LastLost = 0;
+
+    // Coefficient of each original in the window
+    std::vector<uint8_t> Coefficients;
+
+
+    // Is the sequence number within the window of the recovery symbol?
+    GF256_FORCE_INLINE bool Covers(unsigned sequence) const
+    {
+        return sequence - WindowStart < WindowCount;
+    }
+};
+
+class StreamDecoder : public ICodec
+{
+public:
+    virtual ~StreamDecoder() {}
+
+    // Initialize the decoder
+    FecalResult Initialize(unsigned symbolBytes, unsigned windowMax);
+
+    // Add original data
+    FecalResult AddOriginal(const FecalSymbol& symbol);
+
+    // Add recovery data
+    FecalResult AddRecovery(const FecalStreamRecovery& symbol);
+
+    // Remove originals before the given sequence number from the window
+    FecalResult RemoveBefore(unsigned sequence);
+
+    // Try to recover lost originals
+    FecalResult Decode(RecoveredSymbols& symbols);
+
+    // Get original data
+    FecalResult GetOriginal(unsigned sequence, FecalSymbol& symbol);
+
+protected:
+    // Window of original data
+    StreamWindow Window;
+
+    // Track which originals in the window were received, in a ring
+    std::vector<Subwindow> Subwindows;
+    unsigned SubwindowMask = 0;
+
+    // Sums for each lane over the received originals in the window
+    StreamLaneSums LaneSums;
+
+    // Slots for recovery symbols, which keep their memory when reused
+    std::vector<StreamRecoveryInfo> Recovery;
+
+    // Has recovery been attempted with the latest inputs?
+    bool RecoveryAttempted = false;
+
+    // Recovery matrix: One row for each recovery symbol in a cluster,
+    // and one column for each lost original they cover
+    GrowingAlignedByteMatrix Matrix;
+    std::vector<unsigned> MatrixRows;
+    std::vector<unsigned> MatrixColumns;
+    std::vector<unsigned> Pivots;
+
+    // Sources of the sum and product eliminated from a new recovery symbol
+    SumSchedule EliminateSum;
+    SumSchedule EliminateProduct;
+
+    // Recovered data array returned to application
+    std::vector<FecalSymbol> RecoveredData;
+
+
+    // Was the original received?
+    GF256_FORCE_INLINE bool IsReceived(unsigned sequence) const
+    {
+        const Subwindow& subwindow = Subwindows[(sequence / kSubwindowSize) & SubwindowMask];
+        return subwindow.Got.Check(sequence % kSubwindowSize);
+    }
+
+    // Returns end if no originals were lost in the range [sequence, end)
+    // Otherwise returns the first sequence number in the range that was lost
+    unsigned FindNextLost(unsigned sequence, unsigned end) const;
+
+    // Slide the window forward so it contains the given sequence number
+    void SlideWindowTo(unsigned sequence);
+
+    // Slide the start of the window forward to the given sequence number
+    void SlideStartTo(unsigned sequence);
+
+    // Record an original as received and eliminate it from recovery symbols
+    void StoreOriginal(unsigned sequence, const uint8_t* data);
+
+    // Eliminate received originals from a new recovery symbol
+    void EliminateReceived(StreamRecoveryInfo& recovery);
+
+    // Attempt to recover the lost originals covered by a cluster of rows
+    // first, end: Range of MatrixRows that share lost originals
+    void RecoverCluster(unsigned first, unsigned end);
+
+    // Attempt to solve the matrix, returning false if more data is needed
+    bool SolveMatrix();
+
+    // Apply the solved matrix to the recovery data to reveal the originals
+    // first: Offset of the cluster in MatrixRows
+    void RecoverData(unsigned first);
+};
+
+
+} // namespace fecal
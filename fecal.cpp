@@ -30,6 +30,10 @@
 #include "gf256.h"
 #include "FecalEncoder.h"
 #include "FecalDecoder.h"
+#include "FecalInterleaved.h"
+#include "FecalStream.h"
+#include "FecalFile.h"
+#include "FecalPlanner.h"
 
 extern "C" {
 
@@ -52,12 +56,46 @@ FECAL_EXPORT int fecal_init_(int version)
 }
 
 
+//------------------------------------------------------------------------------
+// Row Schedule Cache API
+
+FECAL_EXPORT FecalRowCache fecal_row_cache_create(unsigned input_count, unsigned row_count, FecalRowScheme row_scheme)
+{
+    if (input_count <= 0 || row_count <= 0 ||
+        static_cast<unsigned>(row_scheme) >= Fecal_RowScheme_Count)
+    {
+        FECAL_DEBUG_BREAK; // Invalid input
+        return nullptr;
+    }
+
+    fecal::RowScheduleCache* cache = new(std::nothrow) fecal::RowScheduleCache;
+    if (!cache)
+    {
+        FECAL_DEBUG_BREAK; // Out of memory
+        return nullptr;
+    }
+
+    if (Fecal_Success != cache->Initialize(input_count, row_count, row_scheme))
+    {
+        delete cache;
+        return nullptr;
+    }
+
+    return reinterpret_cast<FecalRowCache>( cache );
+}
+
+
 //------------------------------------------------------------------------------
 // Encoder API
 
 FECAL_EXPORT FecalEncoder fecal_encoder_create(unsigned input_count, void* const * const input_data, uint64_t total_bytes)
 {
-    if (input_count <= 0 || !input_data || total_bytes < input_count)
+    return fecal_encoder_create_ex(input_count, input_data, total_bytes, nullptr);
+}
+
+FECAL_EXPORT FecalEncoder fecal_encoder_create_ex(unsigned input_count, void* const * const input_data, uint64_t total_bytes, const FecalEncoderOptions* options)
+{
+    if (input_count <= 0 || total_bytes < input_count)
     {
         FECAL_DEBUG_BREAK; // Invalid input
         return nullptr;
@@ -74,7 +112,7 @@ FECAL_EXPORT FecalEncoder fecal_encoder_create(unsigned input_count, void* const
         return nullptr;
     }
 
-    if (Fecal_Success != encoder->Initialize(input_count, input_data, total_bytes))
+    if (Fecal_Success != encoder->Initialize(input_count, input_data, total_bytes, options))
     {
         delete encoder;
         return nullptr;
@@ -83,6 +121,27 @@ FECAL_EXPORT FecalEncoder fecal_encoder_create(unsigned input_count, void* const
     return reinterpret_cast<FecalEncoder>( encoder );
 }
 
+FECAL_EXPORT int fecal_encoder_reset(FecalEncoder encoder_v, unsigned input_count, void* const * const input_data, uint64_t total_bytes)
+{
+    fecal::Encoder* encoder = reinterpret_cast<fecal::Encoder*>( encoder_v );
+    if (!encoder || input_count <= 0 || total_bytes < input_count)
+    {
+        FECAL_DEBUG_BREAK; // Invalid input
+        return Fecal_InvalidInput;
+    }
+
+    return encoder->Initialize(input_count, input_data, total_bytes);
+}
+
+FECAL_EXPORT int fecal_encoder_add_original(FecalEncoder encoder_v, const FecalSymbol* symbol)
+{
+    fecal::Encoder* encoder = reinterpret_cast<fecal::Encoder*>( encoder_v );
+    if (!encoder || !symbol)
+        return Fecal_InvalidInput;
+
+    return encoder->AddOriginal(*symbol);
+}
+
 FECAL_EXPORT int fecal_encode(FecalEncoder encoder_v, FecalSymbol* symbol)
 {
     fecal::Encoder* encoder = reinterpret_cast<fecal::Encoder*>( encoder_v );
@@ -92,6 +151,15 @@ FECAL_EXPORT int fecal_encode(FecalEncoder encoder_v, FecalSymbol* symbol)
     return encoder->Encode(*symbol);
 }
 
+FECAL_EXPORT int fecal_encode_batch(FecalEncoder encoder_v, unsigned first_row, unsigned count, FecalSymbol* symbols)
+{
+    fecal::Encoder* encoder = reinterpret_cast<fecal::Encoder*>( encoder_v );
+    if (!encoder || !symbols)
+        return Fecal_InvalidInput;
+
+    return encoder->EncodeBatch(first_row, count, symbols);
+}
+
 FECAL_EXPORT void fecal_free(void* codec_v)
 {
     if (codec_v)
@@ -106,6 +174,11 @@ FECAL_EXPORT void fecal_free(void* codec_v)
 // Decoder API
 
 FECAL_EXPORT FecalDecoder fecal_decoder_create(unsigned input_count, uint64_t total_bytes)
+{
+    return fecal_decoder_create_ex(input_count, total_bytes, nullptr);
+}
+
+FECAL_EXPORT FecalDecoder fecal_decoder_create_ex(unsigned input_count, uint64_t total_bytes, const FecalDecoderOptions* options)
 {
     if (input_count <= 0 || total_bytes < input_count)
     {
@@ -124,7 +197,7 @@ FECAL_EXPORT FecalDecoder fecal_decoder_create(unsigned input_count, uint64_t to
         return nullptr;
     }
 
-    if (Fecal_Success != decoder->Initialize(input_count, total_bytes))
+    if (Fecal_Success != decoder->Initialize(input_count, total_bytes, options))
     {
         delete decoder;
         return nullptr;
@@ -133,6 +206,18 @@ FECAL_EXPORT FecalDecoder fecal_decoder_create(unsigned input_count, uint64_t to
     return reinterpret_cast<FecalDecoder>( decoder );
 }
 
+FECAL_EXPORT int fecal_decoder_reset(FecalDecoder decoder_v, unsigned input_count, uint64_t total_bytes)
+{
+    fecal::Decoder* decoder = reinterpret_cast<fecal::Decoder*>( decoder_v );
+    if (!decoder || input_count <= 0 || total_bytes < input_count)
+    {
+        FECAL_DEBUG_BREAK; // Invalid input
+        return Fecal_InvalidInput;
+    }
+
+    return decoder->Initialize(input_count, total_bytes);
+}
+
 FECAL_EXPORT int fecal_decoder_add_original(FecalDecoder decoder_v, const FecalSymbol* symbol)
 {
     fecal::Decoder* decoder = reinterpret_cast<fecal::Decoder*>( decoder_v );
@@ -169,5 +254,484 @@ FECAL_EXPORT int fecal_decoder_get(FecalDecoder decoder_v, unsigned input_index,
     return decoder->GetOriginal(input_index, *symbol);
 }
 
+//------------------------------------------------------------------------------
+// Variable-Length API
+
+FECAL_EXPORT FecalEncoder fecal_encoder_create_var(unsigned input_count, void* const * const input_data, const unsigned* input_bytes, const FecalEncoderOptions* options)
+{
+    if (input_count <= 0 || !input_bytes)
+    {
+        FECAL_DEBUG_BREAK; // Invalid input
+        return nullptr;
+    }
+
+    FECAL_DEBUG_ASSERT(m_Initialized); // Must call fecal_init() first
+    if (!m_Initialized)
+        return nullptr;
+
+    fecal::Encoder* encoder = new(std::nothrow) fecal::Encoder;
+    if (!encoder)
+    {
+        FECAL_DEBUG_BREAK; // Out of memory
+        return nullptr;
+    }
+
+    if (Fecal_Success != encoder->InitializeVariable(input_count, input_data, input_bytes, options))
+    {
+        delete encoder;
+        return nullptr;
+    }
+
+    return reinterpret_cast<FecalEncoder>( encoder );
+}
+
+FECAL_EXPORT FecalDecoder fecal_decoder_create_var(unsigned input_count, unsigned symbol_bytes, const FecalDecoderOptions* options)
+{
+    if (input_count <= 0 || symbol_bytes <= 0)
+    {
+        FECAL_DEBUG_BREAK; // Invalid input
+        return nullptr;
+    }
+
+    FECAL_DEBUG_ASSERT(m_Initialized); // Must call fecal_init() first
+    if (!m_Initialized)
+        return nullptr;
+
+    fecal::Decoder* decoder = new(std::nothrow) fecal::Decoder;
+    if (!decoder)
+    {
+        FECAL_DEBUG_BREAK; // Out of memory
+        return nullptr;
+    }
+
+    if (Fecal_Success != decoder->InitializeVariable(input_count, symbol_bytes, options))
+    {
+        delete decoder;
+        return nullptr;
+    }
+
+    return reinterpret_cast<FecalDecoder>( decoder );
+}
+
+
+//------------------------------------------------------------------------------
+// Statistics API
+
+FECAL_EXPORT int fecal_decoder_get_stats(FecalDecoder decoder_v, FecalDecoderStats* stats)
+{
+    fecal::Decoder* decoder = reinterpret_cast<fecal::Decoder*>( decoder_v );
+    if (!decoder || !stats)
+        return Fecal_InvalidInput;
+
+#ifdef FECAL_ENABLE_STATS
+    decoder->GetStats(*stats);
+    return Fecal_Success;
+#else
+    return Fecal_Unsupported;
+#endif // FECAL_ENABLE_STATS
+}
+
+//------------------------------------------------------------------------------
+// Planning API
+
+static_assert(FECAL_PLAN_MAX_EXTRA == fecal::kPlanMaxExtra, "Update this");
+
+FECAL_EXPORT int fecal_plan_failure_rate(unsigned input_count, unsigned loss_count, unsigned extra_count, FecalRowScheme row_scheme, unsigned trials, double* failure_rate)
+{
+    if (!failure_rate)
+        return Fecal_InvalidInput;
+    *failure_rate = 1.;
+
+    fecal::FailureTable table;
+    const FecalResult result = fecal::GetFailureTable(input_count, loss_count, row_scheme, trials, table);
+    if (result != Fecal_Success)
+        return result;
+
+    *failure_rate = table.GetFailureRate(extra_count);
+    return Fecal_Success;
+}
+
+FECAL_EXPORT int fecal_plan_recovery_count(unsigned input_count, unsigned loss_count, double target_failure_rate, FecalRowScheme row_scheme, unsigned trials, unsigned* recovery_count)
+{
+    if (!recovery_count || !(target_failure_rate >= 0.) || target_failure_rate > 1.)
+        return Fecal_InvalidInput;
+    *recovery_count = 0;
+
+    fecal::FailureTable table;
+    const FecalResult result = fecal::GetFailureTable(input_count, loss_count, row_scheme, trials, table);
+    if (result != Fecal_Success)
+        return result;
+
+    for (unsigned extra = 0; extra <= fecal::kPlanMaxExtra; ++extra)
+    {
+        if (table.GetFailureRate(extra) <= target_failure_rate)
+        {
+            *recovery_count = loss_count + extra;
+            return Fecal_Success;
+        }
+    }
+
+    *recovery_count = loss_count + fecal::kPlanMaxExtra;
+    return Fecal_NeedMoreData;
+}
+
+
+//------------------------------------------------------------------------------
+// Interleaved API
+
+FECAL_EXPORT unsigned fecal_interleaved_block_count(unsigned input_count, uint64_t total_bytes)
+{
+    return fecal::GetInterleavedBlockCount(input_count, total_bytes);
+}
+
+FECAL_EXPORT FecalInterleavedEncoder fecal_interleaved_encoder_create(unsigned input_count, void* const * const input_data, uint64_t total_bytes, unsigned block_count, const FecalEncoderOptions* options)
+{
+    if (input_count <= 0 || !input_data || total_bytes < input_count ||
+        block_count <= 0 || block_count > input_count)
+    {
+        FECAL_DEBUG_BREAK; // Invalid input
+        return nullptr;
+    }
+
+    FECAL_DEBUG_ASSERT(m_Initialized); // Must call fecal_init() first
+    if (!m_Initialized)
+        return nullptr;
+
+    fecal::InterleavedEncoder* encoder = new(std::nothrow) fecal::InterleavedEncoder;
+    if (!encoder)
+    {
+        FECAL_DEBUG_BREAK; // Out of memory
+        return nullptr;
+    }
+
+    if (Fecal_Success != encoder->Initialize(input_count, input_data, total_bytes, block_count, options))
+    {
+        delete encoder;
+        return nullptr;
+    }
+
+    return reinterpret_cast<FecalInterleavedEncoder>( encoder );
+}
+
+FECAL_EXPORT int fecal_interleaved_encode(FecalInterleavedEncoder encoder_v, FecalSymbol* symbol)
+{
+    fecal::InterleavedEncoder* encoder = reinterpret_cast<fecal::InterleavedEncoder*>( encoder_v );
+    if (!encoder || !symbol)
+        return Fecal_InvalidInput;
+
+    return encoder->Encode(*symbol);
+}
+
+FECAL_EXPORT int fecal_interleaved_encode_batch(FecalInterleavedEncoder encoder_v, unsigned first_row, unsigned count, FecalSymbol* symbols)
+{
+    fecal::InterleavedEncoder* encoder = reinterpret_cast<fecal::InterleavedEncoder*>( encoder_v );
+    if (!encoder || !symbols)
+        return Fecal_InvalidInput;
+
+    return encoder->EncodeBatch(first_row, count, symbols);
+}
+
+FECAL_EXPORT FecalInterleavedDecoder fecal_interleaved_decoder_create(unsigned input_count, uint64_t total_bytes, unsigned block_count, const FecalDecoderOptions* options)
+{
+    if (input_count <= 0 || total_bytes < input_count ||
+        block_count <= 0 || block_count > input_count)
+    {
+        FECAL_DEBUG_BREAK; // Invalid input
+        return nullptr;
+    }
+
+    FECAL_DEBUG_ASSERT(m_Initialized); // Must call fecal_init() first
+    if (!m_Initialized)
+        return nullptr;
+
+    fecal::InterleavedDecoder* decoder = new(std::nothrow) fecal::InterleavedDecoder;
+    if (!decoder)
+    {
+        FECAL_DEBUG_BREAK; // Out of memory
+        return nullptr;
+    }
+
+    if (Fecal_Success != decoder->Initialize(input_count, total_bytes, block_count, options))
+    {
+        delete decoder;
+        return nullptr;
+    }
+
+    return reinterpret_cast<FecalInterleavedDecoder>( decoder );
+}
+
+FECAL_EXPORT int fecal_interleaved_decoder_add_original(FecalInterleavedDecoder decoder_v, const FecalSymbol* symbol)
+{
+    fecal::InterleavedDecoder* decoder = reinterpret_cast<fecal::InterleavedDecoder*>( decoder_v );
+    if (!decoder || !symbol)
+        return Fecal_InvalidInput;
+
+    return decoder->AddOriginal(*symbol);
+}
+
+FECAL_EXPORT int fecal_interleaved_decoder_add_recovery(FecalInterleavedDecoder decoder_v, const FecalSymbol* symbol)
+{
+    fecal::InterleavedDecoder* decoder = reinterpret_cast<fecal::InterleavedDecoder*>( decoder_v );
+    if (!decoder || !symbol)
+        return Fecal_InvalidInput;
+
+    return decoder->AddRecovery(*symbol);
+}
+
+FECAL_EXPORT int fecal_interleaved_decode(FecalInterleavedDecoder decoder_v, RecoveredSymbols* symbols)
+{
+    fecal::InterleavedDecoder* decoder = reinterpret_cast<fecal::InterleavedDecoder*>( decoder_v );
+    if (!decoder || !symbols)
+        return Fecal_InvalidInput;
+
+    return decoder->Decode(*symbols);
+}
+
+FECAL_EXPORT int fecal_interleaved_decoder_get(FecalInterleavedDecoder decoder_v, unsigned input_index, FecalSymbol* symbol)
+{
+    fecal::InterleavedDecoder* decoder = reinterpret_cast<fecal::InterleavedDecoder*>( decoder_v );
+    if (!decoder || !symbol)
+        return Fecal_InvalidInput;
+
+    return decoder->GetOriginal(input_index, *symbol);
+}
+
+
+//------------------------------------------------------------------------------
+// Streaming API
+
+FECAL_EXPORT FecalStreamEncoder fecal_stream_encoder_create(unsigned symbol_bytes, unsigned window_max)
+{
+    if (symbol_bytes <= 0 || window_max <= 0)
+    {
+        FECAL_DEBUG_BREAK; // Invalid input
+        return nullptr;
+    }
+
+    FECAL_DEBUG_ASSERT(m_Initialized); // Must call fecal_init() first
+    if (!m_Initialized)
+        return nullptr;
+
+    fecal::StreamEncoder* encoder = new(std::nothrow) fecal::StreamEncoder;
+    if (!encoder)
+    {
+        FECAL_DEBUG_BREAK; // Out of memory
+        return nullptr;
+    }
+
+    if (Fecal_Success != encoder->Initialize(symbol_bytes, window_max))
+    {
+        delete encoder;
+        return nullptr;
+    }
+
+    return reinterpret_cast<FecalStreamEncoder>( encoder );
+}
+
+FECAL_EXPORT int fecal_stream_encoder_add(FecalStreamEncoder encoder_v, FecalSymbol* symbol)
+{
+    fecal::StreamEncoder* encoder = reinterpret_cast<fecal::StreamEncoder*>( encoder_v );
+    if (!encoder || !symbol)
+        return Fecal_InvalidInput;
+
+    return encoder->AddOriginal(*symbol);
+}
+
+FECAL_EXPORT int fecal_stream_encoder_remove_before(FecalStreamEncoder encoder_v, unsigned sequence)
+{
+    fecal::StreamEncoder* encoder = reinterpret_cast<fecal::StreamEncoder*>( encoder_v );
+    if (!encoder)
+        return Fecal_InvalidInput;
+
+    return encoder->RemoveBefore(sequence);
+}
+
+FECAL_EXPORT int fecal_stream_encode(FecalStreamEncoder encoder_v, FecalStreamRecovery* symbol)
+{
+    fecal::StreamEncoder* encoder = reinterpret_cast<fecal::StreamEncoder*>( encoder_v );
+    if (!encoder || !symbol)
+        return Fecal_InvalidInput;
+
+    return encoder->Encode(*symbol);
+}
+
+FECAL_EXPORT FecalStreamDecoder fecal_stream_decoder_create(unsigned symbol_bytes, unsigned window_max)
+{
+    if (symbol_bytes <= 0 || window_max <= 0)
+    {
+        FECAL_DEBUG_BREAK; // Invalid input
+        return nullptr;
+    }
+
+    FECAL_DEBUG_ASSERT(m_Initialized); // Must call fecal_init() first
+    if (!m_Initialized)
+        return nullptr;
+
+    fecal::StreamDecoder* decoder = new(std::nothrow) fecal::StreamDecoder;
+    if (!decoder)
+    {
+        FECAL_DEBUG_BREAK; // Out of memory
+        return nullptr;
+    }
+
+    if (Fecal_Success != decoder->Initialize(symbol_bytes, window_max))
+    {
+        delete decoder;
+        return nullptr;
+    }
+
+    return reinterpret_cast<FecalStreamDecoder>( decoder );
+}
+
+FECAL_EXPORT int fecal_stream_decoder_add_original(FecalStreamDecoder decoder_v, const FecalSymbol* symbol)
+{
+    fecal::StreamDecoder* decoder = reinterpret_cast<fecal::StreamDecoder*>( decoder_v );
+    if (!decoder || !symbol)
+        return Fecal_InvalidInput;
+
+    return decoder->AddOriginal(*symbol);
+}
+
+FECAL_EXPORT int fecal_stream_decoder_add_recovery(FecalStreamDecoder decoder_v, const FecalStreamRecovery* symbol)
+{
+    fecal::StreamDecoder* decoder = reinterpret_cast<fecal::StreamDecoder*>( decoder_v );
+    if (!decoder || !symbol)
+        return Fecal_InvalidInput;
+
+    return decoder->AddRecovery(*symbol);
+}
+
+FECAL_EXPORT int fecal_stream_decoder_remove_before(FecalStreamDecoder decoder_v, unsigned sequence)
+{
+    fecal::StreamDecoder* decoder = reinterpret_cast<fecal::StreamDecoder*>( decoder_v );
+    if (!decoder)
+        return Fecal_InvalidInput;
+
+    return decoder->RemoveBefore(sequence);
+}
+
+FECAL_EXPORT int fecal_stream_decode(FecalStreamDecoder decoder_v, RecoveredSymbols* symbols)
+{
+    fecal::StreamDecoder* decoder = reinterpret_cast<fecal::StreamDecoder*>( decoder_v );
+    if (!decoder || !symbols)
+        return Fecal_InvalidInput;
+
+    return decoder->Decode(*symbols);
+}
+
+FECAL_EXPORT int fecal_stream_decoder_get(FecalStreamDecoder decoder_v, unsigned sequence, FecalSymbol* symbol)
+{
+    fecal::StreamDecoder* decoder = reinterpret_cast<fecal::StreamDecoder*>( decoder_v );
+    if (!decoder || !symbol)
+        return Fecal_InvalidInput;
+
+    return decoder->GetOriginal(sequence, *symbol);
+}
+
+
+//------------------------------------------------------------------------------
+// File API
+
+FECAL_EXPORT FecalFileEncoder fecal_file_encoder_create(const char* path, unsigned input_count, const FecalEncoderOptions* options)
+{
+    if (!path || input_count <= 0)
+    {
+        FECAL_DEBUG_BREAK; // Invalid input
+        return nullptr;
+    }
+
+    FECAL_DEBUG_ASSERT(m_Initialized); // Must call fecal_init() first
+    if (!m_Initialized)
+        return nullptr;
+
+    fecal::FileEncoder* encoder = new(std::nothrow) fecal::FileEncoder;
+    if (!encoder)
+    {
+        FECAL_DEBUG_BREAK; // Out of memory
+        return nullptr;
+    }
+
+    if (Fecal_Success != encoder->Initialize(path, input_count, options))
+    {
+        delete encoder;
+        return nullptr;
+    }
+
+    return reinterpret_cast<FecalFileEncoder>( encoder );
+}
+
+FECAL_EXPORT int fecal_file_encode(FecalFileEncoder encoder_v, unsigned first_row, unsigned count, const char* output_path)
+{
+    fecal::FileEncoder* encoder = reinterpret_cast<fecal::FileEncoder*>( encoder_v );
+    if (!encoder || !output_path)
+        return Fecal_InvalidInput;
+
+    return encoder->EncodeToFile(first_row, count, output_path);
+}
+
+FECAL_EXPORT FecalFileDecoder fecal_file_decoder_create(const char* path, unsigned input_count, uint64_t total_bytes, const FecalDecoderOptions* options)
+{
+    if (!path || input_count <= 0 || total_bytes < input_count)
+    {
+        FECAL_DEBUG_BREAK; // Invalid input
+        return nullptr;
+    }
+
+    FECAL_DEBUG_ASSERT(m_Initialized); // Must call fecal_init() first
+    if (!m_Initialized)
+        return nullptr;
+
+    fecal::FileDecoder* decoder = new(std::nothrow) fecal::FileDecoder;
+    if (!decoder)
+    {
+        FECAL_DEBUG_BREAK; // Out of memory
+        return nullptr;
+    }
+
+    if (Fecal_Success != decoder->Initialize(path, input_count, total_bytes, options))
+    {
+        delete decoder;
+        return nullptr;
+    }
+
+    return reinterpret_cast<FecalFileDecoder>( decoder );
+}
+
+FECAL_EXPORT int fecal_file_decoder_add_original(FecalFileDecoder decoder_v, unsigned input_index)
+{
+    fecal::FileDecoder* decoder = reinterpret_cast<fecal::FileDecoder*>( decoder_v );
+    if (!decoder)
+        return Fecal_InvalidInput;
+
+    return decoder->AddOriginal(input_index);
+}
+
+FECAL_EXPORT int fecal_file_decoder_add_recovery_file(FecalFileDecoder decoder_v, const char* path, unsigned first_row)
+{
+    fecal::FileDecoder* decoder = reinterpret_cast<fecal::FileDecoder*>( decoder_v );
+    if (!decoder || !path)
+        return Fecal_InvalidInput;
+
+    return decoder->AddRecoveryFile(path, first_row);
+}
+
+FECAL_EXPORT int fecal_file_decoder_add_recovery(FecalFileDecoder decoder_v, const FecalSymbol* symbol)
+{
+    fecal::FileDecoder* decoder = reinterpret_cast<fecal::FileDecoder*>( decoder_v );
+    if (!decoder || !symbol)
+        return Fecal_InvalidInput;
+
+    return decoder->AddRecovery(*symbol);
+}
+
+FECAL_EXPORT int fecal_file_decode(FecalFileDecoder decoder_v)
+{
+    fecal::FileDecoder* decoder = reinterpret_cast<fecal::FileDecoder*>( decoder_v );
+    if (!decoder)
+        return Fecal_InvalidInput;
+
+    return decoder->Decode();
+}
+
 
 } // extern "C"
@@ -35,7 +35,8 @@
 */
 
 // Library version
-#define FECAL_VERSION 2
+// Version 3: Adds Fecal_RowScheme_MultiStream, which changes the recovery data
+#define FECAL_VERSION 3
 
 // Tweak if the functions are exported or statically linked
 //#define FECAL_DLL /* Defined when building/linking as DLL */
@@ -89,6 +90,8 @@ typedef enum FecalResultT
     Fecal_Platform          = -2, // Platform is unsupported
     Fecal_OutOfMemory       = -3, // Out of memory error occurred
     Fecal_Unexpected        = -4, // Unexpected error - Software bug?
+    Fecal_FileError         = -5, // A file could not be opened, mapped or written
+    Fecal_Unsupported       = -6, // Feature was disabled when the library was built
 } FecalResult;
 
 // Encoder and Decoder object types
@@ -120,6 +123,214 @@ typedef struct RecoveredSymbolsT
 } RecoveredSymbols;
 
 
+//------------------------------------------------------------------------------
+// Parallel Execution
+//
+// The library never creates threads.  Instead an application can provide an
+// executor that runs a set of independent tasks, for example on an existing
+// thread pool, and the codec splits its work into tasks for the executor.
+
+/*
+    FecalTaskFunction
+
+    Function that performs one task.  task_index is in 0..(task_count-1).
+*/
+typedef void (*FecalTaskFunction)(void* task_context, unsigned task_index);
+
+/*
+    FecalParallelFor
+
+    Application-provided executor: It must call task_function(task_context, i)
+    exactly once for each i in 0..(task_count-1), in any order and on any
+    threads, and return only after all of the calls have completed.
+*/
+typedef void (*FecalParallelFor)(void* executor_context, unsigned task_count,
+                                 FecalTaskFunction task_function, void* task_context);
+
+typedef struct FecalExecutorT
+{
+    // Executor callback, or NULL to run all work on the calling thread
+    FecalParallelFor ParallelFor;
+
+    // Application context passed to ParallelFor()
+    void* Context;
+
+    // Number of threads the executor can run tasks on, used to size the work
+    unsigned WorkerCount;
+} FecalExecutor;
+
+
+//------------------------------------------------------------------------------
+// Encoder Backend
+//
+// The bulk byte work of the encoder can be moved onto other hardware, such as
+// a GPU, by providing a backend.  Like the executor, the library never talks
+// to devices itself: it describes the sums to compute, and the backend can
+// compute them however it likes, for example keeping the originals and the
+// lane sums resident in device memory between calls.  The recovery symbols
+// are identical with and without a backend.
+
+// Number of lane sums computed from the originals
+#define FECAL_LANE_SUM_COUNT 24
+
+/*
+    FecalBackendSources
+
+    The data that the encoder sums.  Sources 0..(InputCount-1) are the
+    originals, and source InputCount + L * 3 + k is lane sum k of lane L:
+
+        LaneSum(L, k) = Sum over columns c with c % 8 == L of CX(c)^k * Original(c)
+
+    where multiplication is in GF(256) with the generator polynomial used by
+    gf256_mul(), and CX(c) = ColumnValues[c].  The lane sum pointers stay
+    the same until the encoder is initialized again, so a backend can use
+    them to find copies it keeps in device memory.
+*/
+typedef struct FecalBackendSourcesT
+{
+    // Number of originals
+    unsigned InputCount;
+
+    // Number of bytes in each recovery symbol and lane sum
+    unsigned SymbolBytes;
+
+    // Number of sources: InputCount + FECAL_LANE_SUM_COUNT
+    unsigned SourceCount;
+
+    // Data for each source in host memory.  The lane sums are valid for
+    // EncodeRows(), and are the outputs of LaneSums()
+    const uint8_t* const* Data;
+
+    // Number of bytes in each source, from 1 to SymbolBytes.
+    // A source is treated as zeroes past its end
+    const unsigned* Bytes;
+
+    // Column value CX for each original
+    const uint8_t* ColumnValues;
+} FecalBackendSources;
+
+/*
+    FecalBackendRow
+
+    One recovery symbol to produce:
+
+        Output = Sum of SumSources + RX * Sum of ProductSources
+
+    Each entry is a source number.  A source can appear more than once, in
+    which case the copies cancel out.
+*/
+typedef struct FecalBackendRowT
+{
+    // SymbolBytes of host memory to write.  The encoder appends the
+    // FECAL_LENGTH_BYTES of any variable-length recovery symbol itself
+    void* Output;
+
+    // Row multiplier for the product sum
+    uint8_t RX;
+
+    const unsigned* SumSources;
+    unsigned SumCount;
+
+    const unsigned* ProductSources;
+    unsigned ProductCount;
+} FecalBackendRow;
+
+/*
+    FecalBackendLaneSums
+
+    Compute the FECAL_LANE_SUM_COUNT lane sums of the originals into
+    lane_sums[0..FECAL_LANE_SUM_COUNT-1], each SymbolBytes of host memory.
+    This is only called when the encoder is created or reset with its input
+    data.  When the originals are added with fecal_encoder_add_original(),
+    the sums are built up on the CPU as they arrive.
+
+    Return 0 on success, or nonzero to have the encoder compute them itself.
+*/
+typedef int (*FecalBackendLaneSums)(void* backend_context,
+                                    const FecalBackendSources* sources, uint8_t* const* lane_sums);
+
+/*
+    FecalBackendEncodeRows
+
+    Produce each of the row_count recovery symbols in rows[].
+
+    Return 0 on success, or nonzero to have the encoder produce them itself.
+*/
+typedef int (*FecalBackendEncodeRows)(void* backend_context,
+                                      const FecalBackendSources* sources,
+                                      const FecalBackendRow* rows, unsigned row_count);
+
+typedef struct FecalEncoderBackendT
+{
+    // Lane sum callback, or NULL to compute the lane sums on the CPU
+    FecalBackendLaneSums LaneSums;
+
+    // Encoding callback, or NULL to encode on the CPU
+    FecalBackendEncodeRows EncodeRows;
+
+    // Application context passed to the callbacks
+    void* Context;
+} FecalEncoderBackend;
+
+
+//------------------------------------------------------------------------------
+// Row Schedule API
+//
+// Each recovery symbol index selects a pseudo-random set of original symbols
+// that depends only on the index and input_count.  The encoder and decoder
+// regenerate this set every time they handle a recovery symbol.  When many
+// blocks with the same input_count are encoded or decoded, for example all
+// but the final block of a file, the sets can be generated once and shared.
+
+/*
+    Row generation schemes
+
+    The scheme selects how the pseudo-random set is generated.  The encoder
+    and decoder must use the same scheme, so the application should signal
+    it along with the other code parameters.  Recovery data generated with
+    one scheme cannot be decoded with another.
+*/
+typedef enum FecalRowSchemeT
+{
+    // Original scheme: One PCG stream, with each value reduced by modulus.
+    // Compatible with FECAL_VERSION 2 and earlier
+    Fecal_RowScheme_Modulo = 0,
+
+    // Four interleaved PCG streams, with each value reduced by a multiply
+    // and shift instead of a division.  The streams do not depend on each
+    // other so several values are generated at once.  Faster for symbols
+    // that are small enough for the per-row overhead to matter
+    Fecal_RowScheme_MultiStream = 1,
+
+    Fecal_RowScheme_Count
+} FecalRowScheme;
+
+// Row schedule cache object type
+typedef struct FecalRowCacheImpl { int impl; }*FecalRowCache;
+
+/*
+    fecal_row_cache_create()
+
+    Precompute the sets of original symbols for recovery symbol indices
+    0..row_count-1 of blocks with the given input_count.
+
+    input_count: Number of input symbols in each block.
+    row_count:   Number of recovery symbol indices to precompute.
+    row_scheme:  Row generation scheme used by the codecs.
+
+    The cache uses about row_count * (input_count / 2 + 8) bytes.
+
+    The cache is not modified after it is created, so it can be provided to
+    any number of encoders and decoders on any threads through the RowCache
+    option.  It must not be freed with fecal_free() until all of them have
+    been freed.  Codecs with a different input_count or row scheme, or
+    recovery symbol indices beyond row_count, generate the sets as usual.
+
+    Returns NULL on failure.
+*/
+FECAL_EXPORT FecalRowCache fecal_row_cache_create(unsigned input_count, unsigned row_count, FecalRowScheme row_scheme);
+
+
 //------------------------------------------------------------------------------
 // Encoder API
 
@@ -129,7 +340,8 @@ typedef struct RecoveredSymbolsT
     Create an encoder and set the input data.
 
     input_count: Number of input_data[] buffers provided.
-    input_data:  Array of pointers to input data.
+    input_data:  Array of pointers to input data, or NULL to add each input
+                 later with fecal_encoder_add_original().
     total_bytes: Sum of the total bytes in all buffers.
 
     Buffer data must be available until the decoder is freed with fecal_free().
@@ -137,7 +349,8 @@ typedef struct RecoveredSymbolsT
     Buffer data will not be modified, only read.
 
     Each buffer should have the same number of bytes except for the last one,
-    which can be shorter.
+    which can be shorter.  See fecal_encoder_create_var() for inputs that
+    have different lengths.
 
     Let symbol_bytes = The number of bytes in each input_data buffer:
 
@@ -159,6 +372,93 @@ typedef struct RecoveredSymbolsT
 */
 FECAL_EXPORT FecalEncoder fecal_encoder_create(unsigned input_count, void* const * const input_data, uint64_t total_bytes);
 
+// Encoder options
+typedef struct FecalEncoderOptionsT
+{
+    // Optional executor used to build the encoder lane sums in parallel
+    FecalExecutor Executor;
+
+    // Optional shared row schedules from fecal_row_cache_create()
+    FecalRowCache RowCache;
+
+    // Row generation scheme, which the decoder must also use
+    FecalRowScheme RowScheme;
+
+    // Nonzero: Only one or two recovery symbols are expected, so each lane
+    // sum is computed the first time a row selects it, instead of all of
+    // them up front.  This is slower for more rows, and it is ignored when
+    // there is an executor or a backend that computes the lane sums
+    int LazyLaneSums;
+
+    // Optional backend that computes the lane sums and recovery symbols
+    FecalEncoderBackend Backend;
+} FecalEncoderOptions;
+
+/*
+    fecal_encoder_create_ex()
+
+    Create an encoder with extra options.
+
+    options: Encoder options, or NULL for the defaults used by fecal_encoder_create().
+
+    The options structure should be zero-initialized before setting any fields,
+    so that fields added in later versions take on their default values when
+    the application is recompiled.  Adding fields changes the size of the
+    structure, so the application must be compiled against the fecal.h of
+    the library it runs with.
+
+    See fecal_encoder_create() for the other parameters.
+
+    Returns NULL on failure.
+*/
+FECAL_EXPORT FecalEncoder fecal_encoder_create_ex(unsigned input_count, void* const * const input_data, uint64_t total_bytes, const FecalEncoderOptions* options);
+
+/*
+    fecal_encoder_reset()
+
+    Reuse an encoder for new input data.
+
+    encoder: Encoder from fecal_encoder_create().
+
+    The options provided to fecal_encoder_create_ex() are kept.
+    See fecal_encoder_create() for the other parameters.
+
+    Memory allocated for the previous input is reused when it is large enough,
+    so an application that encodes many blocks can create one encoder and
+    reset it for each block.  Once it has seen the largest block, and the
+    largest fecal_encode_batch() count, no more memory is allocated.
+
+    Returns Fecal_Success on success.
+    Returns Fecal_InvalidInput if the parameters were invalid.
+    Returns Fecal_OutOfMemory if memory could not be allocated, in which
+        case the encoder should be freed or reset again before use.
+*/
+FECAL_EXPORT int fecal_encoder_reset(FecalEncoder encoder, unsigned input_count, void* const * const input_data, uint64_t total_bytes);
+
+/*
+    fecal_encoder_add_original()
+
+    Add an input to an encoder that was created or reset with NULL input_data.
+
+    encoder:       Encoder from fecal_encoder_create().
+    symbol->Index: Index of the input from 0..input_count-1.
+    symbol->Data:  Application provided buffer to read the input from.
+    symbol->Bytes: Number of bytes in the input, which is symbol_bytes except
+                   for the final input which is final_bytes.
+
+    Each input is added into the encoder sums as soon as it arrives, so that
+    a recovery symbol can be encoded right after the last input is added.
+    The inputs can be added in any order, and adding one again is ignored.
+
+    Buffer data must be available until the encoder is freed or reset.
+    Buffer data does not need to be aligned.
+    Buffer data will not be modified, only read.
+
+    Returns Fecal_Success on success.
+    Returns Fecal_InvalidInput if the symbol parameter was invalid.
+*/
+FECAL_EXPORT int fecal_encoder_add_original(FecalEncoder encoder, const FecalSymbol* symbol);
+
 /*
     fecal_encode()
 
@@ -175,17 +475,46 @@ FECAL_EXPORT FecalEncoder fecal_encoder_create(unsigned input_count, void* const
             (total_bytes + input_count - 1) / input_count);
 
     Returns Fecal_Success on success.
+    Returns Fecal_NeedMoreData if inputs are still to be added with
+        fecal_encoder_add_original().
     Returns Fecal_InvalidInput if the symbol parameter was invalid, or the
         codec is not initialized yet.
 */
 FECAL_EXPORT int fecal_encode(FecalEncoder encoder, FecalSymbol* symbol);
 
+/*
+    fecal_encode_batch()
+
+    Generate a batch of recovery symbols with consecutive indices.
+
+    encoder:          Encoder from fecal_encoder_create().
+    first_row:        Recovery symbol index for symbols[0].
+    count:            Number of symbols in the array.
+    symbols[i].Data:  Application provided buffer to write the symbol to.
+    symbols[i].Bytes: Application provided number of bytes in the symbol buffer.
+
+    On return symbols[i].Index is set to first_row + i.
+
+    The output is identical to calling fecal_encode() for each index, but the
+    original data is read once for the whole batch instead of once per symbol,
+    so this is much faster when more than a few symbols are needed at a time.
+
+    Returns Fecal_Success on success.
+    Returns Fecal_NeedMoreData if inputs are still to be added with
+        fecal_encoder_add_original().
+    Returns Fecal_InvalidInput if the symbol parameters were invalid, or the
+        codec is not initialized yet.
+*/
+FECAL_EXPORT int fecal_encode_batch(FecalEncoder encoder, unsigned first_row, unsigned count, FecalSymbol* symbols);
+
 /*
     fecal_free()
 
     Free memory associated with the created encoder or decoder.
 
-    codec: Pointer returned by fecal_encoder_create() or fecal_decoder_create()
+    codec: Pointer returned by fecal_encoder_create(), fecal_decoder_create(),
+           fecal_row_cache_create(), or one of the fecal_interleaved_*_create()
+           or fecal_stream_*_create() functions
 */
 FECAL_EXPORT void fecal_free(void* codec);
 
@@ -207,6 +536,86 @@ FECAL_EXPORT void fecal_free(void* codec);
 */
 FECAL_EXPORT FecalDecoder fecal_decoder_create(unsigned input_count, uint64_t total_bytes);
 
+// Decoder options
+typedef struct FecalDecoderOptionsT
+{
+    // Optional executor used to recover the lost symbols in parallel
+    FecalExecutor Executor;
+
+    // Nonzero: Recovery symbol buffers are only read and never modified.
+    // The recovery symbols used in a solution are copied into memory owned
+    // by the decoder, and the recovered data is returned from that memory
+    int ConstRecoveryData;
+
+    // Nonzero: Eliminate each symbol from the decoder state as it arrives,
+    // so that fecal_decode() has less work to do when the last one arrives
+    int OnlineDecode;
+
+    // Optional shared row schedules from fecal_row_cache_create()
+    FecalRowCache RowCache;
+
+    // Row generation scheme used by the encoder
+    FecalRowScheme RowScheme;
+} FecalDecoderOptions;
+
+/*
+    fecal_decoder_create_ex()
+
+    Create a decoder with extra options.
+
+    options: Decoder options, or NULL for the defaults used by fecal_decoder_create().
+
+    The options structure should be zero-initialized before setting any fields,
+    so that fields added in later versions take on their default values when
+    the application is recompiled.  Adding fields changes the size of the
+    structure, so the application must be compiled against the fecal.h of
+    the library it runs with.
+
+    When an executor is provided, fecal_decode() splits the symbols into byte
+    ranges and recovers each range as a separate task.
+
+    When ConstRecoveryData is set, recovery symbols can be added straight
+    from buffers the application cannot modify, such as receive rings.
+    Only the few recovery symbols needed to solve for the lost data are
+    copied, one stripe at a time as they are processed.
+
+    When OnlineDecode is set, original symbols are eliminated from recovery
+    symbols as each one arrives, rather than all at once in fecal_decode().
+    The recovery matrix is also extended and solved as far as possible as
+    each recovery symbol arrives, so the matrix is ready to use as soon as
+    enough symbols have arrived to recover the data.
+    This lowers the latency of the fecal_decode() call that recovers data,
+    at the cost of doing this work for symbols that end up not being needed.
+    With ConstRecoveryData, recovery symbols cannot be modified as they
+    arrive, so less of the work can be done ahead of time.
+
+    See fecal_decoder_create() for the other parameters.
+
+    Returns NULL on failure.
+*/
+FECAL_EXPORT FecalDecoder fecal_decoder_create_ex(unsigned input_count, uint64_t total_bytes, const FecalDecoderOptions* options);
+
+/*
+    fecal_decoder_reset()
+
+    Reuse a decoder for new input data.
+
+    decoder: Decoder from fecal_decoder_create().
+
+    All symbols added for the previous input are forgotten, and pointers
+    returned by fecal_decode() and fecal_decoder_get() are no longer valid.
+    The options provided to fecal_decoder_create_ex() are kept.
+    See fecal_decoder_create() for the other parameters.
+
+    Memory allocated for the previous input is reused when it is large enough,
+    so an application that decodes many blocks can create one decoder and
+    reset it for each block.
+
+    Returns Fecal_Success on success.
+    Returns Fecal_InvalidInput if the parameters were invalid.
+*/
+FECAL_EXPORT int fecal_decoder_reset(FecalDecoder decoder, unsigned input_count, uint64_t total_bytes);
+
 /*
     fecal_decoder_add_original()
 
@@ -251,7 +660,9 @@ FECAL_EXPORT int fecal_decoder_add_original(FecalDecoder decoder, const FecalSym
 
     Buffer data must be available until the decoder is freed with fecal_free().
     Buffer data does not need to be aligned.
-    Buffer data WILL BE MODIFIED.
+    Buffer data WILL BE MODIFIED, unless the decoder was created with
+    the ConstRecoveryData option.  With the OnlineDecode option, it may be
+    modified by this call and by later calls to fecal_decoder_add_original().
 
     Given total_bytes and input_count from fecal_encoder_create():
 
@@ -261,6 +672,8 @@ FECAL_EXPORT int fecal_decoder_add_original(FecalDecoder decoder, const FecalSym
     Returns Fecal_Success on success.
     Returns Fecal_InvalidInput if the symbol parameter was invalid, or the
     codec is not initialized yet.
+    Returns Fecal_OutOfMemory if the OnlineDecode option is set and the
+    recovery matrix could not be allocated.
 */
 FECAL_EXPORT int fecal_decoder_add_recovery(FecalDecoder decoder, const FecalSymbol* symbol);
 
@@ -274,7 +687,8 @@ FECAL_EXPORT int fecal_decoder_add_recovery(FecalDecoder decoder, const FecalSym
 
     The returned data pointers are valid until fecal_free() is called.
     Note that the final symbol size can be different from the rest.
-    The returned data pointers are taken from recovery symbols previously submitted.
+    The returned data pointers are taken from recovery symbols previously submitted,
+    or from memory owned by the decoder with the ConstRecoveryData option.
 
     After decoding completes, the decoder object should be passed to fecal_free().
 
@@ -307,6 +721,665 @@ FECAL_EXPORT int fecal_decode(FecalDecoder decoder, RecoveredSymbols* symbols);
 FECAL_EXPORT int fecal_decoder_get(FecalDecoder decoder, unsigned input_index, FecalSymbol* symbol);
 
 
+//------------------------------------------------------------------------------
+// Variable-Length API
+//
+// Normally every input except the final one has the same length, so inputs
+// of different lengths, such as the packets of a media stream, have to be
+// padded to the longest one, which costs bandwidth and encoding time.  In
+// variable-length mode each input has its own length and only its real bytes
+// are read, as if it was padded with zeroes.  Each recovery symbol is as long
+// as the longest input plus FECAL_LENGTH_BYTES that hold the coded lengths of
+// the inputs, so the decoder recovers the lengths of lost inputs with them.
+
+// Number of bytes added to each recovery symbol in variable-length mode
+#define FECAL_LENGTH_BYTES 4
+
+/*
+    fecal_encoder_create_var()
+
+    Create an encoder for inputs that have different lengths.
+
+    input_count: Number of input_data[] buffers provided.
+    input_data:  Array of pointers to input data, or NULL to add each input
+                 later with fecal_encoder_add_original().
+    input_bytes: Array of the number of bytes in each input, at least 1.
+    options:     Encoder options, or NULL for the defaults.
+
+    Let symbol_bytes = The largest value in input_bytes[].  Recovery symbols
+    have symbol->Bytes = symbol_bytes + FECAL_LENGTH_BYTES, and the decoder
+    must be created with the same input_count and symbol_bytes.
+
+    fecal_encode() and fecal_encode_batch() are used as usual, and inputs
+    added with fecal_encoder_add_original() must have the length given in
+    input_bytes[].  fecal_encoder_reset() switches back to equal lengths.
+
+    Returns NULL on failure.
+*/
+FECAL_EXPORT FecalEncoder fecal_encoder_create_var(unsigned input_count, void* const * const input_data, const unsigned* input_bytes, const FecalEncoderOptions* options);
+
+/*
+    fecal_decoder_create_var()
+
+    Create a decoder for inputs that have different lengths.
+
+    input_count:  Number of inputs provided to fecal_encoder_create_var().
+    symbol_bytes: Number of bytes in the longest input.
+    options:      Decoder options, or NULL for the defaults.
+
+    Original symbols can have any symbol->Bytes from 1 to symbol_bytes, and
+    recovery symbols have symbol->Bytes = symbol_bytes + FECAL_LENGTH_BYTES.
+    The symbols returned by fecal_decode() have the lengths of the lost inputs.
+
+    The decoder is otherwise used as usual.
+    fecal_decoder_reset() switches back to equal lengths.
+
+    Returns NULL on failure.
+*/
+FECAL_EXPORT FecalDecoder fecal_decoder_create_var(unsigned input_count, unsigned symbol_bytes, const FecalDecoderOptions* options);
+
+
+//------------------------------------------------------------------------------
+// Statistics API
+//
+// The decoder can count the work done by fecal_decode() and time each of its
+// stages, to help choose how much recovery data to send and to find loss
+// patterns that are slow to decode.  The counters and timers are only built
+// into the library when it is compiled with FECAL_ENABLE_STATS defined.
+
+// Decoder statistics since the decoder was created or reset
+typedef struct FecalDecoderStatsT
+{
+    // Recovery matrix rows and columns in the latest solution attempt
+    unsigned MatrixRows;
+    unsigned MatrixColumns;
+
+    // Number of attempts to solve the recovery matrix,
+    // and the number of those that needed more recovery data
+    unsigned SolveAttempts;
+    unsigned SolveFailures;
+
+    // Number of times elimination resumed with new rows after a failure
+    unsigned ResumeGECount;
+
+    // Number of times a zero pivot switched elimination to searching for
+    // pivots, and the number of rows examined in those searches
+    unsigned PivotedGECount;
+    uint64_t PivotRowsSearched;
+
+    // Bytes read into the recovery data by each recovery step:
+    uint64_t CopyBytes;      // Read-only recovery data copied into the decoder
+    uint64_t LaneSumBytes;   // Received original data, once for each lane sum computed
+    uint64_t EliminateBytes; // Originals and lane sums eliminated from the recovery data
+    uint64_t SolveBytes;     // Recovery data multiplied in, at most columns * columns symbols
+
+    // Nanoseconds spent in each stage:
+    uint64_t GenerateMatrixNsec;      // Filling in the recovery matrix
+    uint64_t GaussianEliminationNsec; // Solving the recovery matrix
+    uint64_t ScheduleNsec;            // Workspace, elimination schedules and inverses
+    uint64_t RecoveryNsec;            // Recovering the lost data from the symbols
+    uint64_t DecodeNsec;              // All fecal_decode() calls that attempted recovery
+
+    // Nanoseconds spent in the two parts of the recovery stage, summed over
+    // the executor tasks, so with several threads they add up to CPU time:
+    uint64_t EliminateNsec;           // Copying, lane sums and elimination of received data
+    uint64_t SolveNsec;               // Solving for the lost data from the eliminated rows
+} FecalDecoderStats;
+
+/*
+    fecal_decoder_get_stats()
+
+    Get the statistics collected by a decoder.
+
+    decoder: Decoder from fecal_decoder_create() or fecal_decoder_create_var().
+    stats:   Returned statistics.
+
+    With OnlineDecode, the matrix is solved as recovery symbols arrive, so the
+    matrix stages are counted during fecal_decoder_add_recovery(), and the
+    work done as symbols arrive is not included in the byte counts.
+
+    Returns Fecal_Success on success.
+    Returns Fecal_Unsupported if the library was built without FECAL_ENABLE_STATS.
+    Returns Fecal_InvalidInput if the parameters are invalid.
+*/
+FECAL_EXPORT int fecal_decoder_get_stats(FecalDecoder decoder, FecalDecoderStats* stats);
+
+
+//------------------------------------------------------------------------------
+// Planning API
+//
+// With exactly as many recovery symbols as lost inputs, decoding fails about
+// 1% of the time, and each extra recovery symbol makes failure much rarer.
+// These functions estimate the failure rate by simulating the decoder's
+// recovery matrix for random loss patterns, without any symbol data, so that
+// a sender can choose the fewest recovery symbols for a target reliability.
+// The first call for each input_count, loss_count, row_scheme and trials runs
+// the simulation, which costs about trials decodes of the recovery matrix;
+// the results are cached, and both functions are safe to call from any thread.
+
+// Largest extra_count that is simulated
+#define FECAL_PLAN_MAX_EXTRA 32
+
+/*
+    fecal_plan_failure_rate()
+
+    Estimate the probability that decoding fails.
+
+    input_count:  Number of inputs in the block.
+    loss_count:   Number of inputs lost, from 1 to input_count.
+    extra_count:  Number of recovery symbols received beyond loss_count.
+    row_scheme:   Row generation scheme used by the encoder.
+    trials:       Number of simulated decodes, or 0 for the default of 1000.
+    failure_rate: Returned fraction of the simulated decodes that failed.
+
+    A failure rate much lower than 1 / trials shows up as 0, so use at least
+    10 / target trials when planning for a target failure rate.
+    Past FECAL_PLAN_MAX_EXTRA the rate for FECAL_PLAN_MAX_EXTRA is returned.
+
+    Returns Fecal_Success on success.
+    Returns Fecal_InvalidInput if the parameters are invalid.
+    Returns Fecal_OutOfMemory if the simulation ran out of memory.
+*/
+FECAL_EXPORT int fecal_plan_failure_rate(unsigned input_count, unsigned loss_count, unsigned extra_count, FecalRowScheme row_scheme, unsigned trials, double* failure_rate);
+
+/*
+    fecal_plan_recovery_count()
+
+    Find the fewest recovery symbols that decode with at most the target
+    failure rate, as estimated by fecal_plan_failure_rate().
+
+    input_count:    Number of inputs in the block.
+    loss_count:     Number of inputs lost, from 1 to input_count.
+    target_failure_rate: Highest acceptable failure rate, from 0 to 1.
+    row_scheme:     Row generation scheme used by the encoder.
+    trials:         Number of simulated decodes, or 0 for the default of 1000.
+    recovery_count: Returned number of recovery symbols to receive,
+                    at least loss_count.
+
+    Returns Fecal_Success on success.
+    Returns Fecal_NeedMoreData if no count up to loss_count + FECAL_PLAN_MAX_EXTRA
+    reached the target, in which case recovery_count is set to that maximum.
+    Returns Fecal_InvalidInput if the parameters are invalid.
+    Returns Fecal_OutOfMemory if the simulation ran out of memory.
+*/
+FECAL_EXPORT int fecal_plan_recovery_count(unsigned input_count, unsigned loss_count, double target_failure_rate, FecalRowScheme row_scheme, unsigned trials, unsigned* recovery_count);
+
+
+//------------------------------------------------------------------------------
+// Interleaved API
+//
+// The cost of the block code grows with the square of the number of symbols,
+// so very large inputs are better split into several smaller blocks that each
+// fit in cache.  The interleaved encoder and decoder do this internally:
+// Input symbol i is placed in block (i % block_count), and recovery symbol r
+// is generated from block (r % block_count), so a burst of loss is spread
+// evenly over the blocks just like it is spread over one large block.
+// The application uses the same symbol indices it would use for one block.
+
+// Interleaved encoder and decoder object types
+typedef struct FecalInterleavedEncoderImpl { int impl; }*FecalInterleavedEncoder;
+typedef struct FecalInterleavedDecoderImpl { int impl; }*FecalInterleavedDecoder;
+
+/*
+    fecal_interleaved_block_count()
+
+    Suggest a number of blocks to split the input into.
+
+    input_count: Number of input data buffers.
+    total_bytes: Sum of the total bytes in all buffers.
+
+    Returns the number of blocks, which is at least 1.
+*/
+FECAL_EXPORT unsigned fecal_interleaved_block_count(unsigned input_count, uint64_t total_bytes);
+
+/*
+    fecal_interleaved_encoder_create()
+
+    Create an interleaved encoder and set the input data.
+
+    block_count: Number of blocks, from 1..input_count.
+    options:     Encoder options, or NULL for the defaults.
+
+    When an executor is provided, the blocks are set up in parallel and
+    fecal_interleaved_encode_batch() encodes the blocks in parallel.
+
+    Each block has input_count / block_count inputs, rounded up for the first
+    (input_count % block_count) blocks.  A RowCache is used by the blocks
+    with the same number of inputs as the cache.
+
+    See fecal_encoder_create() for the other parameters.
+
+    Returns NULL on failure.
+*/
+FECAL_EXPORT FecalInterleavedEncoder fecal_interleaved_encoder_create(unsigned input_count, void* const * const input_data, uint64_t total_bytes, unsigned block_count, const FecalEncoderOptions* options);
+
+/*
+    fecal_interleaved_encode()
+
+    Generate a recovery symbol.
+
+    encoder: Encoder from fecal_interleaved_encoder_create().
+
+    See fecal_encode() for the other parameters.
+*/
+FECAL_EXPORT int fecal_interleaved_encode(FecalInterleavedEncoder encoder, FecalSymbol* symbol);
+
+/*
+    fecal_interleaved_encode_batch()
+
+    Generate a batch of recovery symbols with consecutive indices.
+
+    encoder: Encoder from fecal_interleaved_encoder_create().
+
+    See fecal_encode_batch() for the other parameters.
+*/
+FECAL_EXPORT int fecal_interleaved_encode_batch(FecalInterleavedEncoder encoder, unsigned first_row, unsigned count, FecalSymbol* symbols);
+
+/*
+    fecal_interleaved_decoder_create()
+
+    Create an interleaved decoder.
+
+    block_count: Number of blocks, which must match the encoder.
+    options:     Decoder options, or NULL for the defaults.
+
+    When an executor is provided, fecal_interleaved_decode() recovers the
+    blocks in parallel.
+
+    See fecal_decoder_create() for the other parameters.
+
+    Returns NULL on failure.
+*/
+FECAL_EXPORT FecalInterleavedDecoder fecal_interleaved_decoder_create(unsigned input_count, uint64_t total_bytes, unsigned block_count, const FecalDecoderOptions* options);
+
+/*
+    fecal_interleaved_decoder_add_original()
+
+    Adds an original symbol to the decoder.
+
+    decoder: Decoder from fecal_interleaved_decoder_create().
+
+    See fecal_decoder_add_original() for the other parameters.
+*/
+FECAL_EXPORT int fecal_interleaved_decoder_add_original(FecalInterleavedDecoder decoder, const FecalSymbol* symbol);
+
+/*
+    fecal_interleaved_decoder_add_recovery()
+
+    Adds a recovery symbol to the decoder.
+
+    decoder: Decoder from fecal_interleaved_decoder_create().
+
+    See fecal_decoder_add_recovery() for the other parameters.
+*/
+FECAL_EXPORT int fecal_interleaved_decoder_add_recovery(FecalInterleavedDecoder decoder, const FecalSymbol* symbol);
+
+/*
+    fecal_interleaved_decode()
+
+    Attempt to decode with what has been added so far.
+
+    decoder: Decoder from fecal_interleaved_decoder_create().
+    symbols: Returned recovered symbols from all of the blocks.
+
+    Blocks that have enough symbols are recovered even if other blocks need
+    more data, and the symbols recovered from every block are returned once
+    all of the blocks are complete.
+
+    Returns Fecal_Success if all original data has been recovered.
+    Returns Fecal_NeedMoreData if more data is required.
+    Returns Fecal_InvalidInput if the parameters are invalid.
+*/
+FECAL_EXPORT int fecal_interleaved_decode(FecalInterleavedDecoder decoder, RecoveredSymbols* symbols);
+
+/*
+    fecal_interleaved_decoder_get()
+
+    Get original data.
+
+    decoder: Decoder from fecal_interleaved_decoder_create().
+
+    See fecal_decoder_get() for the other parameters.
+*/
+FECAL_EXPORT int fecal_interleaved_decoder_get(FecalInterleavedDecoder decoder, unsigned input_index, FecalSymbol* symbol);
+
+//------------------------------------------------------------------------------
+// Streaming API
+//
+// The streaming encoder and decoder protect a sliding window of original data
+// rather than a fixed block.  Each original symbol is numbered with a sequence
+// number that counts up from 0 and wraps around at 2^32.  Each recovery symbol
+// covers the window of originals that the encoder held when it was generated,
+// so the cost of each symbol depends on the window size and not on the length
+// of the stream.  All symbols in a stream have the same number of bytes.
+
+// Streaming encoder and decoder object types
+typedef struct FecalStreamEncoderImpl { int impl; }*FecalStreamEncoder;
+typedef struct FecalStreamDecoderImpl { int impl; }*FecalStreamDecoder;
+
+// Streaming recovery symbol
+typedef struct FecalStreamRecoveryT
+{
+    // User-provided data pointer allocated by application.
+    void* Data;
+
+    // User-provided number of bytes in the data buffer, for validation.
+    unsigned Bytes;
+
+    // Recovery row number chosen by the encoder.
+    unsigned Row;
+
+    // Sequence number of the first original symbol covered.
+    unsigned WindowStart;
+
+    // Number of original symbols covered, starting from WindowStart.
+    unsigned WindowCount;
+} FecalStreamRecovery;
+
+/*
+    fecal_stream_encoder_create()
+
+    Create a streaming encoder.
+
+    symbol_bytes: Number of bytes in each symbol.
+    window_max:   Maximum number of original symbols in the window, up to 65536.
+
+    Returns NULL on failure.
+*/
+FECAL_EXPORT FecalStreamEncoder fecal_stream_encoder_create(unsigned symbol_bytes, unsigned window_max);
+
+/*
+    fecal_stream_encoder_add()
+
+    Add the next original symbol to the encoder window.
+
+    encoder:       Encoder from fecal_stream_encoder_create().
+    symbol->Data:  Application provided buffer to read the symbol from.
+    symbol->Bytes: Application provided number of bytes in the symbol buffer.
+
+    On return symbol->Index is set to the sequence number of the symbol.
+
+    If the window already holds window_max symbols, the oldest one is removed.
+
+    Buffer data must be available until it is removed from the window.
+    Buffer data does not need to be aligned.
+    Buffer data will not be modified, only read.
+
+    Returns Fecal_Success on success.
+    Returns Fecal_InvalidInput if the symbol parameter was invalid.
+*/
+FECAL_EXPORT int fecal_stream_encoder_add(FecalStreamEncoder encoder, FecalSymbol* symbol);
+
+/*
+    fecal_stream_encoder_remove_before()
+
+    Remove original symbols from the window, for example after the receiver
+    acknowledged them.
+
+    encoder:  Encoder from fecal_stream_encoder_create().
+    sequence: Symbols with sequence numbers before this one are removed.
+
+    If the sequence number is past the end of the window, the window is
+    emptied and the next original symbol added will use this sequence number.
+
+    Returns Fecal_Success on success.
+    Returns Fecal_InvalidInput if the parameters were invalid.
+*/
+FECAL_EXPORT int fecal_stream_encoder_remove_before(FecalStreamEncoder encoder, unsigned sequence);
+
+/*
+    fecal_stream_encode()
+
+    Generate a recovery symbol for the current window.
+
+    encoder:       Encoder from fecal_stream_encoder_create().
+    symbol->Data:  Application provided buffer to write the symbol to.
+    symbol->Bytes: Application provided number of bytes in the symbol buffer.
+
+    On return the Row, WindowStart and WindowCount fields are set, and they
+    must be delivered to the decoder along with the symbol data.
+
+    Returns Fecal_Success on success.
+    Returns Fecal_NeedMoreData if the window is empty.
+    Returns Fecal_InvalidInput if the symbol parameter was invalid.
+*/
+FECAL_EXPORT int fecal_stream_encode(FecalStreamEncoder encoder, FecalStreamRecovery* symbol);
+
+/*
+    fecal_stream_decoder_create()
+
+    Create a streaming decoder.
+
+    symbol_bytes: Number of bytes in each symbol.
+    window_max:   Maximum number of original symbols in the window, up to 65536.
+
+    The decoder window should be at least as large as the encoder window.
+    When a symbol arrives with a sequence number past the end of the window,
+    the window slides forward and the oldest symbols are removed.
+
+    Returns NULL on failure.
+*/
+FECAL_EXPORT FecalStreamDecoder fecal_stream_decoder_create(unsigned symbol_bytes, unsigned window_max);
+
+/*
+    fecal_stream_decoder_add_original()
+
+    Adds an original symbol to the decoder.
+
+    decoder:       Decoder from fecal_stream_decoder_create().
+    symbol->Index: Sequence number from fecal_stream_encoder_add().
+    symbol->Data:  Application provided buffer to read the symbol from.
+    symbol->Bytes: Application provided number of bytes in the symbol buffer.
+
+    Symbols from before the decoder window are ignored.
+
+    Buffer data must be available until it is removed from the window.
+    Buffer data does not need to be aligned.
+    Buffer data will not be modified, only read.
+
+    Returns Fecal_Success on success.
+    Returns Fecal_InvalidInput if the symbol parameter was invalid.
+*/
+FECAL_EXPORT int fecal_stream_decoder_add_original(FecalStreamDecoder decoder, const FecalSymbol* symbol);
+
+/*
+    fecal_stream_decoder_add_recovery()
+
+    Adds a recovery symbol to the decoder.
+
+    decoder: Decoder from fecal_stream_decoder_create().
+    symbol:  Recovery symbol from fecal_stream_encode().
+
+    Recovery symbols that cover originals from before the decoder window
+    which were lost are ignored, since they can no longer be used.
+
+    Buffer data must be available until the symbols it covers are removed from
+    the window.
+    Buffer data does not need to be aligned.
+    Buffer data WILL BE MODIFIED.
+
+    Returns Fecal_Success on success.
+    Returns Fecal_InvalidInput if the symbol parameter was invalid.
+*/
+FECAL_EXPORT int fecal_stream_decoder_add_recovery(FecalStreamDecoder decoder, const FecalStreamRecovery* symbol);
+
+/*
+    fecal_stream_decoder_remove_before()
+
+    Remove original symbols from the decoder window.
+
+    decoder:  Decoder from fecal_stream_decoder_create().
+    sequence: Symbols with sequence numbers before this one are removed.
+
+    Recovery symbols that cover lost originals before this sequence number
+    are also removed, since they can no longer be used.
+
+    Returns Fecal_Success on success.
+    Returns Fecal_InvalidInput if the parameters were invalid.
+*/
+FECAL_EXPORT int fecal_stream_decoder_remove_before(FecalStreamDecoder decoder, unsigned sequence);
+
+/*
+    fecal_stream_decode()
+
+    Attempt to recover lost original symbols in the window.
+
+    decoder: Decoder from fecal_stream_decoder_create().
+    symbols: Returned recovered symbols, with Index set to the sequence number.
+
+    The recovered data pointers point into recovery symbol buffers, and they
+    are valid until the symbols are removed from the window.
+
+    Returns Fecal_Success if any lost symbols were recovered.
+    Returns Fecal_NeedMoreData if nothing could be recovered yet.
+    Returns Fecal_InvalidInput if the parameters are invalid.
+*/
+FECAL_EXPORT int fecal_stream_decode(FecalStreamDecoder decoder, RecoveredSymbols* symbols);
+
+/*
+    fecal_stream_decoder_get()
+
+    Get original data from the decoder window.
+
+    decoder:  Decoder from fecal_stream_decoder_create().
+    sequence: Sequence number of the symbol.
+    symbol:   Returned original symbol data.
+
+    Returns Fecal_Success on success.
+    Returns Fecal_NeedMoreData if the data is unavailable.
+    Returns Fecal_InvalidInput if the parameters are invalid.
+*/
+FECAL_EXPORT int fecal_stream_decoder_get(FecalStreamDecoder decoder, unsigned sequence, FecalSymbol* symbol);
+
+//------------------------------------------------------------------------------
+// File API
+//
+// The file encoder and decoder protect an object stored in a file, which is
+// memory-mapped rather than read into application buffers.  The file is split
+// in order into input_count symbols of ceil(file_bytes / input_count) bytes,
+// with the final symbol holding the rest, and the final symbol must not be
+// empty.  Recovery symbols are written one after another to an output file,
+// so symbol r of a file written from first_row has index first_row + r.
+// The whole file must fit in the address space.
+
+// File encoder and decoder object types
+typedef struct FecalFileEncoderImpl { int impl; }*FecalFileEncoder;
+typedef struct FecalFileDecoderImpl { int impl; }*FecalFileDecoder;
+
+/*
+    fecal_file_encoder_create()
+
+    Create a file encoder for the object in the given file.
+
+    path:        Path of the file to protect, which must not change until the
+                 encoder is freed.
+    input_count: Number of symbols to split the file into.
+    options:     Encoder options, or NULL for the defaults.
+
+    Returns NULL on failure.
+*/
+FECAL_EXPORT FecalFileEncoder fecal_file_encoder_create(const char* path, unsigned input_count, const FecalEncoderOptions* options);
+
+/*
+    fecal_file_encode()
+
+    Write recovery symbols to a file.
+
+    encoder:     Encoder from fecal_file_encoder_create().
+    first_row:   Index of the first recovery symbol.
+    count:       Number of recovery symbols to write.
+    output_path: Path of the file to write, which is created or replaced.
+
+    The output file holds count symbols of ceil(file_bytes / input_count)
+    bytes each.  The symbols are encoded straight into a mapping of a
+    temporary file next to it, named output_path with ".fecaltmp" appended,
+    which is flushed to storage and then renamed to output_path.  On failure
+    the temporary file is deleted and any existing output file is unchanged.
+
+    Returns Fecal_Success on success.
+    Returns Fecal_FileError if the output file could not be written.
+    Returns other values for errors.
+*/
+FECAL_EXPORT int fecal_file_encode(FecalFileEncoder encoder, unsigned first_row, unsigned count, const char* output_path);
+
+/*
+    fecal_file_decoder_create()
+
+    Create a file decoder that recovers an object into the given file.
+
+    path:        Path of the file to recover, which is created if it does not
+                 exist and resized to total_bytes.
+    input_count: Number of symbols the file was split into by the encoder.
+    total_bytes: Number of bytes in the original file.
+    options:     Decoder options, or NULL for the defaults.
+                 ConstRecoveryData is always set.
+
+    Returns NULL on failure.
+*/
+FECAL_EXPORT FecalFileDecoder fecal_file_decoder_create(const char* path, unsigned input_count, uint64_t total_bytes, const FecalDecoderOptions* options);
+
+/*
+    fecal_file_decoder_add_original()
+
+    Mark an original symbol in the file as intact.
+
+    decoder:     Decoder from fecal_file_decoder_create().
+    input_index: Index of the symbol within the file.
+
+    Returns Fecal_Success on success.
+    Returns Fecal_InvalidInput if the parameters were invalid.
+*/
+FECAL_EXPORT int fecal_file_decoder_add_original(FecalFileDecoder decoder, unsigned input_index);
+
+/*
+    fecal_file_decoder_add_recovery_file()
+
+    Adds every recovery symbol in a file written by fecal_file_encode().
+
+    decoder:   Decoder from fecal_file_decoder_create().
+    path:      Path of the recovery file, which is kept mapped until the
+               decoder is freed.
+    first_row: The first_row the file was written with.
+
+    Returns Fecal_Success on success.
+    Returns Fecal_FileError if the file could not be mapped.
+    Returns Fecal_InvalidInput if the file does not hold whole symbols.
+*/
+FECAL_EXPORT int fecal_file_decoder_add_recovery_file(FecalFileDecoder decoder, const char* path, unsigned first_row);
+
+/*
+    fecal_file_decoder_add_recovery()
+
+    Adds one recovery symbol to the decoder, for example when only some of
+    the symbols in a recovery file are intact.
+
+    decoder: Decoder from fecal_file_decoder_create().
+
+    Buffer data must be available until the decoder is freed.
+    Buffer data will not be modified, only read.
+
+    See fecal_decoder_add_recovery() for the other parameters.
+*/
+FECAL_EXPORT int fecal_file_decoder_add_recovery(FecalFileDecoder decoder, const FecalSymbol* symbol);
+
+/*
+    fecal_file_decode()
+
+    Attempt to decode with what has been added so far.
+
+    decoder: Decoder from fecal_file_decoder_create().
+
+    The recovered symbols are written into their places in the file, which
+    is flushed to storage before returning.
+
+    Returns Fecal_Success if all original data has been recovered.
+    Returns Fecal_NeedMoreData if more data is required.
+    Returns Fecal_FileError if the file could not be written.
+    Returns other values for errors.
+*/
+FECAL_EXPORT int fecal_file_decode(FecalFileDecoder decoder);
+
+
 #ifdef __cplusplus
 }
 #endif
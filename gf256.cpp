@@ -71,8 +71,8 @@ static GF256_FORCE_INLINE uint8x16_t vqtbl1q_u8(uint8x16_t a, uint8x16_t b)
 //
 // This is executed during initialization to make sure the library is working
 
-static const unsigned kTestBufferBytes = 32 + 16 + 8 + 4 + 2 + 1;
-static const unsigned kTestBufferAllocated = 64;
+static const unsigned kTestBufferBytes = 128 + 64 + 32 + 16 + 8 + 4 + 2 + 1;
+static const unsigned kTestBufferAllocated = 256;
 struct SelfTestBuffersT
 {
     GF256_ALIGNED uint8_t A[kTestBufferAllocated];
@@ -154,6 +154,51 @@ static bool gf256_self_test()
         if (m_SelfTestBuffers.A[i] != (0xaa ^ 0x6c))
             return false;
 
+    // Test gf256_addn_mem()
+    for (unsigned i = 0; i < kTestBufferBytes; ++i)
+    {
+        m_SelfTestBuffers.A[i] = 0x1f;
+        m_SelfTestBuffers.B[i] = 0xf7;
+        m_SelfTestBuffers.C[i] = 0x71;
+    }
+    const void* addnSources[3] = {
+        m_SelfTestBuffers.B, m_SelfTestBuffers.C, m_SelfTestBuffers.C
+    };
+    gf256_addn_mem(m_SelfTestBuffers.A, addnSources, 3, kTestBufferBytes);
+    for (unsigned i = 0; i < kTestBufferBytes; ++i)
+        if (m_SelfTestBuffers.A[i] != (0x1f ^ 0xf7 ^ 0x71 ^ 0x71))
+            return false;
+
+    // Test gf256_addn_muladdn_mem()
+    for (unsigned i = 0; i < kTestBufferBytes; ++i)
+    {
+        m_SelfTestBuffers.A[i] = 0x1f;
+        m_SelfTestBuffers.B[i] = 0xf7;
+        m_SelfTestBuffers.C[i] = 0x71;
+    }
+    const void* sumSources[1] = { m_SelfTestBuffers.B };
+    const void* productSources[2] = { m_SelfTestBuffers.B, m_SelfTestBuffers.C };
+    const uint8_t expectedSumProduct = 0x1f ^ 0xf7 ^ gf256_mul(0xf7 ^ 0x71, 0x6c);
+    gf256_addn_muladdn_mem(m_SelfTestBuffers.A, sumSources, 1, 0x6c, productSources, 2, kTestBufferBytes);
+    for (unsigned i = 0; i < kTestBufferBytes; ++i)
+        if (m_SelfTestBuffers.A[i] != expectedSumProduct)
+            return false;
+
+    // Test gf256_muladdn_mem()
+    for (unsigned i = 0; i < kTestBufferBytes; ++i)
+    {
+        m_SelfTestBuffers.A[i] = 0x1f;
+        m_SelfTestBuffers.B[i] = 0xf7;
+        m_SelfTestBuffers.C[i] = 0x71;
+    }
+    const void* mulAddSources[2] = { m_SelfTestBuffers.B, m_SelfTestBuffers.C };
+    const uint8_t mulAddFactors[2] = { 0x6c, 0xa2 };
+    const uint8_t expectedMulAddN = 0x1f ^ gf256_mul(0xf7, 0x6c) ^ gf256_mul(0x71, 0xa2);
+    gf256_muladdn_mem(m_SelfTestBuffers.A, mulAddFactors, mulAddSources, 2, kTestBufferBytes);
+    for (unsigned i = 0; i < kTestBufferBytes; ++i)
+        if (m_SelfTestBuffers.A[i] != expectedMulAddN)
+            return false;
+
     // Test gf256_muladd_mem()
     for (unsigned i = 0; i < kTestBufferBytes; ++i)
     {
@@ -225,10 +270,23 @@ static bool CpuHasNeon64 = false;   // And we don't have ASIMD
 #ifdef GF256_TRY_AVX2
 static bool CpuHasAVX2 = false;
 #endif
+#ifdef GF256_TRY_AVX512
+static bool CpuHasAVX512 = false;
+#endif
+#ifdef GF256_TRY_GFNI
+static bool CpuHasGFNI = false;
+#endif
 static bool CpuHasSSSE3 = false;
 
-#define CPUID_EBX_AVX2    0x00000020
-#define CPUID_ECX_SSSE3   0x00000200
+#define CPUID_EBX_AVX2     0x00000020
+#define CPUID_EBX_AVX512F  0x00010000
+#define CPUID_EBX_AVX512BW 0x40000000
+#define CPUID_ECX_GFNI     0x00000100
+#define CPUID_ECX_SSSE3    0x00000200
+#define CPUID_ECX_OSXSAVE  0x08000000
+
+// XCR0 bits for SSE, AVX, and the AVX-512 opmask/ZMM register state
+#define XCR0_AVX512_STATE  0x000000e6
 
 static void _cpuid(unsigned int cpu_info[4U], const unsigned int cpu_info_type)
 {
@@ -267,6 +325,20 @@ static void _cpuid(unsigned int cpu_info[4U], const unsigned int cpu_info_type)
 #endif
 }
 
+#ifdef GF256_TRY_AVX512
+// Returns the OS-enabled register state from XCR0
+static uint64_t _xgetbv0()
+{
+#if defined(_MSC_VER)
+    return _xgetbv(0);
+#else
+    uint32_t eax, edx;
+    __asm__ __volatile__ ("xgetbv" : "=a" (eax), "=d" (edx) : "c" (0));
+    return ((uint64_t)edx << 32) | eax;
+#endif
+}
+#endif // GF256_TRY_AVX512
+
 #else
 #if defined(LINUX_ARM)
 static void checkLinuxARMNeonCapabilities( bool& cpuHasNeon )
@@ -327,11 +399,27 @@ static void gf256_architecture_init()
     _cpuid(cpu_info, 1);
     CpuHasSSSE3 = ((cpu_info[2] & CPUID_ECX_SSSE3) != 0);
 
+#if defined(GF256_TRY_AVX512)
+    // The OS must also save the AVX-512 registers on context switch
+    const bool osHasAVX512 = ((cpu_info[2] & CPUID_ECX_OSXSAVE) != 0) &&
+        ((_xgetbv0() & XCR0_AVX512_STATE) == XCR0_AVX512_STATE);
+#endif // GF256_TRY_AVX512
+
 #if defined(GF256_TRY_AVX2)
     _cpuid(cpu_info, 7);
     CpuHasAVX2 = ((cpu_info[1] & CPUID_EBX_AVX2) != 0);
 #endif // GF256_TRY_AVX2
 
+#if defined(GF256_TRY_AVX512)
+    const unsigned avx512Mask = CPUID_EBX_AVX512F | CPUID_EBX_AVX512BW;
+    CpuHasAVX512 = osHasAVX512 && CpuHasAVX2 && ((cpu_info[1] & avx512Mask) == avx512Mask);
+#endif // GF256_TRY_AVX512
+
+#if defined(GF256_TRY_GFNI)
+    // GFNI is only used with 512-bit registers
+    CpuHasGFNI = CpuHasAVX512 && ((cpu_info[2] & CPUID_ECX_GFNI) != 0);
+#endif // GF256_TRY_GFNI
+
     // When AVX2 and SSSE3 are unavailable, Siamese takes 4x longer to decode
     // and 2.6x longer to encode.  Encoding requires a lot more simple XOR ops
     // so it is still pretty fast.  Decoding is usually really quick because
@@ -349,6 +437,9 @@ static void gf256_architecture_init()
 GF256_ALIGNED gf256_ctx GF256Ctx;
 static bool Initialized = false;
 
+// Select the kernels for the host processor
+static void gf256_kernels_init();
+
 
 //------------------------------------------------------------------------------
 // Generator Polynomial
@@ -578,19 +669,39 @@ static void gf256_mul_mem_init()
             GF256Ctx.MM128.TABLE_HI_Y[y] = vld1q_u8(hi);
         }
 #elif !defined(GF256_TARGET_MOBILE)
-        const GF256_M128 table_lo = _mm_loadu_si128((GF256_M128*)lo);
-        const GF256_M128 table_hi = _mm_loadu_si128((GF256_M128*)hi);
-        _mm_storeu_si128(GF256Ctx.MM128.TABLE_LO_Y + y, table_lo);
-        _mm_storeu_si128(GF256Ctx.MM128.TABLE_HI_Y + y, table_hi);
+        // Copy the tables without intrinsics, since this code is not built
+        // with the target attributes of the kernels that use them
+        memcpy(GF256Ctx.MM128.TABLE_LO_Y + y, lo, 16);
+        memcpy(GF256Ctx.MM128.TABLE_HI_Y + y, hi, 16);
 # ifdef GF256_TRY_AVX2
         if (CpuHasAVX2)
         {
-            const GF256_M256 table_lo2 = _mm256_broadcastsi128_si256(table_lo);
-            const GF256_M256 table_hi2 = _mm256_broadcastsi128_si256(table_hi);
-            _mm256_storeu_si256(GF256Ctx.MM256.TABLE_LO_Y + y, table_lo2);
-            _mm256_storeu_si256(GF256Ctx.MM256.TABLE_HI_Y + y, table_hi2);
+            // Both 128-bit lanes hold the same table
+            uint8_t* lo2 = reinterpret_cast<uint8_t*>(GF256Ctx.MM256.TABLE_LO_Y + y);
+            uint8_t* hi2 = reinterpret_cast<uint8_t*>(GF256Ctx.MM256.TABLE_HI_Y + y);
+            memcpy(lo2, lo, 16);
+            memcpy(lo2 + 16, lo, 16);
+            memcpy(hi2, hi, 16);
+            memcpy(hi2 + 16, hi, 16);
         }
 # endif // GF256_TRY_AVX2
+# ifdef GF256_TRY_GFNI
+        if (CpuHasGFNI)
+        {
+            // Multiplying by y is a linear map over GF(2)^^8, so it can be
+            // written as an 8x8 bit matrix where column j is (2^^j * y).
+            // vgf2p8affineqb computes bit i of each byte from matrix byte 7-i
+            uint64_t matrix = 0;
+            for (unsigned j = 0; j < 8; ++j)
+            {
+                const uint8_t column = gf256_mul(static_cast<uint8_t>( 1 << j ), static_cast<uint8_t>( y ));
+                for (unsigned i = 0; i < 8; ++i)
+                    if (column & (1 << i))
+                        matrix |= (uint64_t)1 << ((7 - i) * 8 + j);
+            }
+            GF256Ctx.GFNI_AFFINE_Y[y] = matrix;
+        }
+# endif // GF256_TRY_GFNI
 #endif // GF256_TARGET_MOBILE
     }
 }
@@ -633,6 +744,7 @@ extern "C" int gf256_init_(int version)
         return -2; // Unexpected byte order.
 
     gf256_architecture_init();
+    gf256_kernels_init();
     gf256_poly_init(kDefaultPolynomialIndex);
     gf256_explog_init();
     gf256_muldiv_init();
@@ -650,172 +762,59 @@ extern "C" int gf256_init_(int version)
 //------------------------------------------------------------------------------
 // Operations
 
-extern "C" void gf256_add_mem(void * GF256_RESTRICT vx,
-                              const void * GF256_RESTRICT vy, int bytes)
-{
-    GF256_M128 * GF256_RESTRICT x16 = reinterpret_cast<GF256_M128 *>(vx);
-    const GF256_M128 * GF256_RESTRICT y16 = reinterpret_cast<const GF256_M128 *>(vy);
-
-#if defined(GF256_TARGET_MOBILE)
-# if defined(GF256_TRY_NEON)
-    // Handle multiples of 64 bytes
-    if (CpuHasNeon)
-    {
-        while (bytes >= 64)
-        {
-            GF256_M128 x0 = vld1q_u8((uint8_t*) x16);
-            GF256_M128 x1 = vld1q_u8((uint8_t*)(x16 + 1) );
-            GF256_M128 x2 = vld1q_u8((uint8_t*)(x16 + 2) );
-            GF256_M128 x3 = vld1q_u8((uint8_t*)(x16 + 3) );
-            GF256_M128 y0 = vld1q_u8((uint8_t*)y16);
-            GF256_M128 y1 = vld1q_u8((uint8_t*)(y16 + 1));
-            GF256_M128 y2 = vld1q_u8((uint8_t*)(y16 + 2));
-            GF256_M128 y3 = vld1q_u8((uint8_t*)(y16 + 3));
-
-            vst1q_u8((uint8_t*)x16,     veorq_u8(x0, y0));
-            vst1q_u8((uint8_t*)(x16 + 1), veorq_u8(x1, y1));
-            vst1q_u8((uint8_t*)(x16 + 2), veorq_u8(x2, y2));
-            vst1q_u8((uint8_t*)(x16 + 3), veorq_u8(x3, y3));
-
-            bytes -= 64, x16 += 4, y16 += 4;
-        }
-
-        // Handle multiples of 16 bytes
-        while (bytes >= 16)
-        {
-            GF256_M128 x0 = vld1q_u8((uint8_t*)x16);
-            GF256_M128 y0 = vld1q_u8((uint8_t*)y16);
-
-            vst1q_u8((uint8_t*)x16, veorq_u8(x0, y0));
-
-            bytes -= 16, ++x16, ++y16;
-        }
-    }
-    else
-# endif // GF256_TRY_NEON
-    {
-        uint64_t * GF256_RESTRICT x8 = reinterpret_cast<uint64_t *>(x16);
-        const uint64_t * GF256_RESTRICT y8 = reinterpret_cast<const uint64_t *>(y16);
-
-        const unsigned count = (unsigned)bytes / 8;
-        for (unsigned ii = 0; ii < count; ++ii)
-            x8[ii] ^= y8[ii];
-
-        x16 = reinterpret_cast<GF256_M128 *>(x8 + count);
-        y16 = reinterpret_cast<const GF256_M128 *>(y8 + count);
-
-        bytes -= (count * 8);
-    }
-#else // GF256_TARGET_MOBILE
-# if defined(GF256_TRY_AVX2)
-    if (CpuHasAVX2)
-    {
-        GF256_M256 * GF256_RESTRICT x32 = reinterpret_cast<GF256_M256 *>(x16);
-        const GF256_M256 * GF256_RESTRICT y32 = reinterpret_cast<const GF256_M256 *>(y16);
-
-        while (bytes >= 128)
-        {
-            GF256_M256 x0 = _mm256_loadu_si256(x32);
-            GF256_M256 y0 = _mm256_loadu_si256(y32);
-            x0 = _mm256_xor_si256(x0, y0);
-            GF256_M256 x1 = _mm256_loadu_si256(x32 + 1);
-            GF256_M256 y1 = _mm256_loadu_si256(y32 + 1);
-            x1 = _mm256_xor_si256(x1, y1);
-            GF256_M256 x2 = _mm256_loadu_si256(x32 + 2);
-            GF256_M256 y2 = _mm256_loadu_si256(y32 + 2);
-            x2 = _mm256_xor_si256(x2, y2);
-            GF256_M256 x3 = _mm256_loadu_si256(x32 + 3);
-            GF256_M256 y3 = _mm256_loadu_si256(y32 + 3);
-            x3 = _mm256_xor_si256(x3, y3);
-
-            _mm256_storeu_si256(x32, x0);
-            _mm256_storeu_si256(x32 + 1, x1);
-            _mm256_storeu_si256(x32 + 2, x2);
-            _mm256_storeu_si256(x32 + 3, x3);
-
-            bytes -= 128, x32 += 4, y32 += 4;
-        }
-
-        // Handle multiples of 32 bytes
-        while (bytes >= 32)
-        {
-            // x[i] = x[i] xor y[i]
-            _mm256_storeu_si256(x32,
-                _mm256_xor_si256(
-                    _mm256_loadu_si256(x32),
-                    _mm256_loadu_si256(y32)));
-
-            bytes -= 32, ++x32, ++y32;
-        }
-
-        x16 = reinterpret_cast<GF256_M128 *>(x32);
-        y16 = reinterpret_cast<const GF256_M128 *>(y32);
-    }
-    else
-# endif // GF256_TRY_AVX2
-    {
-        while (bytes >= 64)
-        {
-            GF256_M128 x0 = _mm_loadu_si128(x16);
-            GF256_M128 y0 = _mm_loadu_si128(y16);
-            x0 = _mm_xor_si128(x0, y0);
-            GF256_M128 x1 = _mm_loadu_si128(x16 + 1);
-            GF256_M128 y1 = _mm_loadu_si128(y16 + 1);
-            x1 = _mm_xor_si128(x1, y1);
-            GF256_M128 x2 = _mm_loadu_si128(x16 + 2);
-            GF256_M128 y2 = _mm_loadu_si128(y16 + 2);
-            x2 = _mm_xor_si128(x2, y2);
-            GF256_M128 x3 = _mm_loadu_si128(x16 + 3);
-            GF256_M128 y3 = _mm_loadu_si128(y16 + 3);
-            x3 = _mm_xor_si128(x3, y3);
-
-            _mm_storeu_si128(x16, x0);
-            _mm_storeu_si128(x16 + 1, x1);
-            _mm_storeu_si128(x16 + 2, x2);
-            _mm_storeu_si128(x16 + 3, x3);
-
-            bytes -= 64, x16 += 4, y16 += 4;
-        }
-    }
-#endif // GF256_TARGET_MOBILE
+/*
+    Each bulk operation has one kernel per instruction set.  The kernels for
+    wider registers handle as much as they can and then fall through to the
+    narrower block loops and finally the byte-wise tail, so every kernel can
+    process any number of bytes.  gf256_kernels_init() selects the fastest
+    kernel supported by the host, and the exported functions dispatch to it.
+
+    On GCC and Clang the kernels are compiled with target attributes so that
+    the rest of the library does not need any special compiler flags.
+*/
 
-#if !defined(GF256_TARGET_MOBILE)
-    // Handle multiples of 16 bytes
-    while (bytes >= 16)
-    {
-        // x[i] = x[i] xor y[i]
-        _mm_storeu_si128(x16,
-            _mm_xor_si128(
-                _mm_loadu_si128(x16),
-                _mm_loadu_si128(y16)));
+#if defined(_MSC_VER) || defined(GF256_TARGET_MOBILE)
+    #define GF256_TARGET_SSSE3
+    #define GF256_TARGET_AVX2
+    #define GF256_TARGET_AVX512
+    #define GF256_TARGET_GFNI
+#else // _MSC_VER
+    #define GF256_TARGET_SSSE3  __attribute__((target("ssse3")))
+    #define GF256_TARGET_AVX2   __attribute__((target("avx2")))
+    #define GF256_TARGET_AVX512 __attribute__((target("avx512f,avx512bw")))
+    #define GF256_TARGET_GFNI   __attribute__((target("avx512f,avx512bw,gfni")))
+#endif // _MSC_VER
 
-        bytes -= 16, ++x16, ++y16;
-    }
-#endif
 
-    uint8_t * GF256_RESTRICT x1 = reinterpret_cast<uint8_t *>(x16);
-    const uint8_t * GF256_RESTRICT y1 = reinterpret_cast<const uint8_t *>(y16);
+//------------------------------------------------------------------------------
+// Byte-wise Tails
+//
+// Portable code for the bytes left over after the SIMD loops
 
-    // Handle a block of 8 bytes
-    const int eight = bytes & 8;
-    if (eight)
+static GF256_FORCE_INLINE void gf256_add_mem_tail(
+    uint8_t * GF256_RESTRICT x1, const uint8_t * GF256_RESTRICT y1, int bytes)
+{
+    // Handle blocks of 8 bytes
+    while (bytes >= 8)
     {
         uint64_t * GF256_RESTRICT x8 = reinterpret_cast<uint64_t *>(x1);
         const uint64_t * GF256_RESTRICT y8 = reinterpret_cast<const uint64_t *>(y1);
         *x8 ^= *y8;
+
+        bytes -= 8, x1 += 8, y1 += 8;
     }
 
     // Handle a block of 4 bytes
     const int four = bytes & 4;
     if (four)
     {
-        uint32_t * GF256_RESTRICT x4 = reinterpret_cast<uint32_t *>(x1 + eight);
-        const uint32_t * GF256_RESTRICT y4 = reinterpret_cast<const uint32_t *>(y1 + eight);
+        uint32_t * GF256_RESTRICT x4 = reinterpret_cast<uint32_t *>(x1);
+        const uint32_t * GF256_RESTRICT y4 = reinterpret_cast<const uint32_t *>(y1);
         *x4 ^= *y4;
     }
 
     // Handle final bytes
-    const int offset = eight + four;
+    const int offset = four;
     switch (bytes & 3)
     {
     case 3: x1[offset + 2] ^= y1[offset + 2];
@@ -826,116 +825,33 @@ extern "C" void gf256_add_mem(void * GF256_RESTRICT vx,
     }
 }
 
-extern "C" void gf256_add2_mem(void * GF256_RESTRICT vz, const void * GF256_RESTRICT vx,
-                               const void * GF256_RESTRICT vy, int bytes)
+static GF256_FORCE_INLINE void gf256_add2_mem_tail(
+    uint8_t * GF256_RESTRICT z1, const uint8_t * GF256_RESTRICT x1,
+    const uint8_t * GF256_RESTRICT y1, int bytes)
 {
-    GF256_M128 * GF256_RESTRICT z16 = reinterpret_cast<GF256_M128*>(vz);
-    const GF256_M128 * GF256_RESTRICT x16 = reinterpret_cast<const GF256_M128*>(vx);
-    const GF256_M128 * GF256_RESTRICT y16 = reinterpret_cast<const GF256_M128*>(vy);
-
-#if defined(GF256_TARGET_MOBILE)
-# if defined(GF256_TRY_NEON)
-    // Handle multiples of 64 bytes
-    if (CpuHasNeon)
-    {
-        // Handle multiples of 16 bytes
-        while (bytes >= 16)
-        {
-            // z[i] = z[i] xor x[i] xor y[i]
-            vst1q_u8((uint8_t*)z16,
-                veorq_u8(
-                    vld1q_u8((uint8_t*)z16),
-                    veorq_u8(
-                        vld1q_u8((uint8_t*)x16),
-                        vld1q_u8((uint8_t*)y16))));
-
-            bytes -= 16, ++x16, ++y16, ++z16;
-        }
-    }
-    else
-# endif // GF256_TRY_NEON
-    {
-        uint64_t * GF256_RESTRICT z8 = reinterpret_cast<uint64_t *>(z16);
-        const uint64_t * GF256_RESTRICT x8 = reinterpret_cast<const uint64_t *>(x16);
-        const uint64_t * GF256_RESTRICT y8 = reinterpret_cast<const uint64_t *>(y16);
-
-        const unsigned count = (unsigned)bytes / 8;
-        for (unsigned ii = 0; ii < count; ++ii)
-            z8[ii] ^= x8[ii] ^ y8[ii];
-
-        z16 = reinterpret_cast<GF256_M128 *>(z8 + count);
-        x16 = reinterpret_cast<const GF256_M128 *>(x8 + count);
-        y16 = reinterpret_cast<const GF256_M128 *>(y8 + count);
-
-        bytes -= (count * 8);
-    }
-#else // GF256_TARGET_MOBILE
-# if defined(GF256_TRY_AVX2)
-    if (CpuHasAVX2)
-    {
-        GF256_M256 * GF256_RESTRICT z32 = reinterpret_cast<GF256_M256 *>(z16);
-        const GF256_M256 * GF256_RESTRICT x32 = reinterpret_cast<const GF256_M256 *>(x16);
-        const GF256_M256 * GF256_RESTRICT y32 = reinterpret_cast<const GF256_M256 *>(y16);
-
-        const unsigned count = bytes / 32;
-        for (unsigned i = 0; i < count; ++i)
-        {
-            _mm256_storeu_si256(z32 + i,
-                _mm256_xor_si256(
-                    _mm256_loadu_si256(z32 + i),
-                    _mm256_xor_si256(
-                        _mm256_loadu_si256(x32 + i),
-                        _mm256_loadu_si256(y32 + i))));
-        }
-
-        bytes -= count * 32;
-        z16 = reinterpret_cast<GF256_M128 *>(z32 + count);
-        x16 = reinterpret_cast<const GF256_M128 *>(x32 + count);
-        y16 = reinterpret_cast<const GF256_M128 *>(y32 + count);
-    }
-# endif // GF256_TRY_AVX2
-
-    // Handle multiples of 16 bytes
-    while (bytes >= 16)
-    {
-        // z[i] = z[i] xor x[i] xor y[i]
-        _mm_storeu_si128(z16,
-            _mm_xor_si128(
-                _mm_loadu_si128(z16),
-                _mm_xor_si128(
-                    _mm_loadu_si128(x16),
-                    _mm_loadu_si128(y16))));
-
-        bytes -= 16, ++x16, ++y16, ++z16;
-    }
-#endif // GF256_TARGET_MOBILE
-
-    uint8_t * GF256_RESTRICT z1 = reinterpret_cast<uint8_t *>(z16);
-    const uint8_t * GF256_RESTRICT x1 = reinterpret_cast<const uint8_t *>(x16);
-    const uint8_t * GF256_RESTRICT y1 = reinterpret_cast<const uint8_t *>(y16);
-
-    // Handle a block of 8 bytes
-    const int eight = bytes & 8;
-    if (eight)
+    // Handle blocks of 8 bytes
+    while (bytes >= 8)
     {
         uint64_t * GF256_RESTRICT z8 = reinterpret_cast<uint64_t *>(z1);
         const uint64_t * GF256_RESTRICT x8 = reinterpret_cast<const uint64_t *>(x1);
         const uint64_t * GF256_RESTRICT y8 = reinterpret_cast<const uint64_t *>(y1);
         *z8 ^= *x8 ^ *y8;
+
+        bytes -= 8, z1 += 8, x1 += 8, y1 += 8;
     }
 
     // Handle a block of 4 bytes
     const int four = bytes & 4;
     if (four)
     {
-        uint32_t * GF256_RESTRICT z4 = reinterpret_cast<uint32_t *>(z1 + eight);
-        const uint32_t * GF256_RESTRICT x4 = reinterpret_cast<const uint32_t *>(x1 + eight);
-        const uint32_t * GF256_RESTRICT y4 = reinterpret_cast<const uint32_t *>(y1 + eight);
+        uint32_t * GF256_RESTRICT z4 = reinterpret_cast<uint32_t *>(z1);
+        const uint32_t * GF256_RESTRICT x4 = reinterpret_cast<const uint32_t *>(x1);
+        const uint32_t * GF256_RESTRICT y4 = reinterpret_cast<const uint32_t *>(y1);
         *z4 ^= *x4 ^ *y4;
     }
 
     // Handle final bytes
-    const int offset = eight + four;
+    const int offset = four;
     switch (bytes & 3)
     {
     case 3: z1[offset + 2] ^= x1[offset + 2] ^ y1[offset + 2];
@@ -946,151 +862,33 @@ extern "C" void gf256_add2_mem(void * GF256_RESTRICT vz, const void * GF256_REST
     }
 }
 
-extern "C" void gf256_addset_mem(void * GF256_RESTRICT vz, const void * GF256_RESTRICT vx,
-                                 const void * GF256_RESTRICT vy, int bytes)
+static GF256_FORCE_INLINE void gf256_addset_mem_tail(
+    uint8_t * GF256_RESTRICT z1, const uint8_t * GF256_RESTRICT x1,
+    const uint8_t * GF256_RESTRICT y1, int bytes)
 {
-    GF256_M128 * GF256_RESTRICT z16 = reinterpret_cast<GF256_M128*>(vz);
-    const GF256_M128 * GF256_RESTRICT x16 = reinterpret_cast<const GF256_M128*>(vx);
-    const GF256_M128 * GF256_RESTRICT y16 = reinterpret_cast<const GF256_M128*>(vy);
-
-#if defined(GF256_TARGET_MOBILE)
-# if defined(GF256_TRY_NEON)
-    // Handle multiples of 64 bytes
-    if (CpuHasNeon)
-    {
-        while (bytes >= 64)
-        {
-            GF256_M128 x0 = vld1q_u8((uint8_t*)x16);
-            GF256_M128 x1 = vld1q_u8((uint8_t*)(x16 + 1));
-            GF256_M128 x2 = vld1q_u8((uint8_t*)(x16 + 2));
-            GF256_M128 x3 = vld1q_u8((uint8_t*)(x16 + 3));
-            GF256_M128 y0 = vld1q_u8((uint8_t*)(y16));
-            GF256_M128 y1 = vld1q_u8((uint8_t*)(y16 + 1));
-            GF256_M128 y2 = vld1q_u8((uint8_t*)(y16 + 2));
-            GF256_M128 y3 = vld1q_u8((uint8_t*)(y16 + 3));
-
-            vst1q_u8((uint8_t*)z16,     veorq_u8(x0, y0));
-            vst1q_u8((uint8_t*)(z16 + 1), veorq_u8(x1, y1));
-            vst1q_u8((uint8_t*)(z16 + 2), veorq_u8(x2, y2));
-            vst1q_u8((uint8_t*)(z16 + 3), veorq_u8(x3, y3));
-
-            bytes -= 64, x16 += 4, y16 += 4, z16 += 4;
-        }
-
-        // Handle multiples of 16 bytes
-        while (bytes >= 16)
-        {
-            // z[i] = x[i] xor y[i]
-            vst1q_u8((uint8_t*)z16,
-                     veorq_u8(
-                         vld1q_u8((uint8_t*)x16),
-                         vld1q_u8((uint8_t*)y16)));
-
-            bytes -= 16, ++x16, ++y16, ++z16;
-        }
-    }
-    else
-# endif // GF256_TRY_NEON
-    {
-        uint64_t * GF256_RESTRICT z8 = reinterpret_cast<uint64_t *>(z16);
-        const uint64_t * GF256_RESTRICT x8 = reinterpret_cast<const uint64_t *>(x16);
-        const uint64_t * GF256_RESTRICT y8 = reinterpret_cast<const uint64_t *>(y16);
-
-        const unsigned count = (unsigned)bytes / 8;
-        for (unsigned ii = 0; ii < count; ++ii)
-            z8[ii] = x8[ii] ^ y8[ii];
-
-        x16 = reinterpret_cast<const GF256_M128 *>(x8 + count);
-        y16 = reinterpret_cast<const GF256_M128 *>(y8 + count);
-        z16 = reinterpret_cast<GF256_M128 *>(z8 + count);
-
-        bytes -= (count * 8);
-    }
-#else // GF256_TARGET_MOBILE
-# if defined(GF256_TRY_AVX2)
-    if (CpuHasAVX2)
-    {
-        GF256_M256 * GF256_RESTRICT z32 = reinterpret_cast<GF256_M256 *>(z16);
-        const GF256_M256 * GF256_RESTRICT x32 = reinterpret_cast<const GF256_M256 *>(x16);
-        const GF256_M256 * GF256_RESTRICT y32 = reinterpret_cast<const GF256_M256 *>(y16);
-
-        const unsigned count = bytes / 32;
-        for (unsigned i = 0; i < count; ++i)
-        {
-            _mm256_storeu_si256(z32 + i,
-                _mm256_xor_si256(
-                    _mm256_loadu_si256(x32 + i),
-                    _mm256_loadu_si256(y32 + i)));
-        }
-
-        bytes -= count * 32;
-        z16 = reinterpret_cast<GF256_M128 *>(z32 + count);
-        x16 = reinterpret_cast<const GF256_M128 *>(x32 + count);
-        y16 = reinterpret_cast<const GF256_M128 *>(y32 + count);
-    }
-    else
-# endif // GF256_TRY_AVX2
-    {
-        // Handle multiples of 64 bytes
-        while (bytes >= 64)
-        {
-            GF256_M128 x0 = _mm_loadu_si128(x16);
-            GF256_M128 x1 = _mm_loadu_si128(x16 + 1);
-            GF256_M128 x2 = _mm_loadu_si128(x16 + 2);
-            GF256_M128 x3 = _mm_loadu_si128(x16 + 3);
-            GF256_M128 y0 = _mm_loadu_si128(y16);
-            GF256_M128 y1 = _mm_loadu_si128(y16 + 1);
-            GF256_M128 y2 = _mm_loadu_si128(y16 + 2);
-            GF256_M128 y3 = _mm_loadu_si128(y16 + 3);
-
-            _mm_storeu_si128(z16,     _mm_xor_si128(x0, y0));
-            _mm_storeu_si128(z16 + 1, _mm_xor_si128(x1, y1));
-            _mm_storeu_si128(z16 + 2, _mm_xor_si128(x2, y2));
-            _mm_storeu_si128(z16 + 3, _mm_xor_si128(x3, y3));
-
-            bytes -= 64, x16 += 4, y16 += 4, z16 += 4;
-        }
-    }
-
-    // Handle multiples of 16 bytes
-    while (bytes >= 16)
-    {
-        // z[i] = x[i] xor y[i]
-        _mm_storeu_si128(z16,
-            _mm_xor_si128(
-                _mm_loadu_si128(x16),
-                _mm_loadu_si128(y16)));
-
-        bytes -= 16, ++x16, ++y16, ++z16;
-    }
-#endif // GF256_TARGET_MOBILE
-
-    uint8_t * GF256_RESTRICT z1 = reinterpret_cast<uint8_t *>(z16);
-    const uint8_t * GF256_RESTRICT x1 = reinterpret_cast<const uint8_t *>(x16);
-    const uint8_t * GF256_RESTRICT y1 = reinterpret_cast<const uint8_t *>(y16);
-
-    // Handle a block of 8 bytes
-    const int eight = bytes & 8;
-    if (eight)
+    // Handle blocks of 8 bytes
+    while (bytes >= 8)
     {
         uint64_t * GF256_RESTRICT z8 = reinterpret_cast<uint64_t *>(z1);
         const uint64_t * GF256_RESTRICT x8 = reinterpret_cast<const uint64_t *>(x1);
         const uint64_t * GF256_RESTRICT y8 = reinterpret_cast<const uint64_t *>(y1);
         *z8 = *x8 ^ *y8;
+
+        bytes -= 8, z1 += 8, x1 += 8, y1 += 8;
     }
 
     // Handle a block of 4 bytes
     const int four = bytes & 4;
     if (four)
     {
-        uint32_t * GF256_RESTRICT z4 = reinterpret_cast<uint32_t *>(z1 + eight);
-        const uint32_t * GF256_RESTRICT x4 = reinterpret_cast<const uint32_t *>(x1 + eight);
-        const uint32_t * GF256_RESTRICT y4 = reinterpret_cast<const uint32_t *>(y1 + eight);
+        uint32_t * GF256_RESTRICT z4 = reinterpret_cast<uint32_t *>(z1);
+        const uint32_t * GF256_RESTRICT x4 = reinterpret_cast<const uint32_t *>(x1);
+        const uint32_t * GF256_RESTRICT y4 = reinterpret_cast<const uint32_t *>(y1);
         *z4 = *x4 ^ *y4;
     }
 
     // Handle final bytes
-    const int offset = eight + four;
+    const int offset = four;
     switch (bytes & 3)
     {
     case 3: z1[offset + 2] = x1[offset + 2] ^ y1[offset + 2];
@@ -1101,113 +899,13 @@ extern "C" void gf256_addset_mem(void * GF256_RESTRICT vz, const void * GF256_RE
     }
 }
 
-extern "C" void gf256_mul_mem(void * GF256_RESTRICT vz, const void * GF256_RESTRICT vx, uint8_t y, int bytes)
+static GF256_FORCE_INLINE void gf256_mul_mem_tail(
+    uint8_t * GF256_RESTRICT z1, const uint8_t * GF256_RESTRICT x1, uint8_t y, int bytes)
 {
-    // Use a single if-statement to handle special cases
-    if (y <= 1)
-    {
-        if (y == 0)
-            memset(vz, 0, bytes);
-        else if (vz != vx)
-            memcpy(vz, vx, bytes);
-        return;
-    }
-
-    GF256_M128 * GF256_RESTRICT z16 = reinterpret_cast<GF256_M128 *>(vz);
-    const GF256_M128 * GF256_RESTRICT x16 = reinterpret_cast<const GF256_M128 *>(vx);
+    const uint8_t * GF256_RESTRICT table = GF256Ctx.GF256_MUL_TABLE + ((unsigned)y << 8);
 
-#if defined(GF256_TARGET_MOBILE)
-#if defined(GF256_TRY_NEON)
-    if (bytes >= 16 && CpuHasNeon)
-    {
-        // Partial product tables; see above
-        const GF256_M128 table_lo_y = vld1q_u8((uint8_t*)(GF256Ctx.MM128.TABLE_LO_Y + y));
-        const GF256_M128 table_hi_y = vld1q_u8((uint8_t*)(GF256Ctx.MM128.TABLE_HI_Y + y));
-
-        // clr_mask = 0x0f0f0f0f0f0f0f0f0f0f0f0f0f0f0f0f
-        const GF256_M128 clr_mask = vdupq_n_u8(0x0f);
-
-        // Handle multiples of 16 bytes
-        do
-        {
-            // See above comments for details
-            GF256_M128 x0 = vld1q_u8((uint8_t*)x16);
-            GF256_M128 l0 = vandq_u8(x0, clr_mask);
-            x0 = vshrq_n_u8(x0, 4);
-            GF256_M128 h0 = vandq_u8(x0, clr_mask);
-            l0 = vqtbl1q_u8(table_lo_y, l0);
-            h0 = vqtbl1q_u8(table_hi_y, h0);
-            vst1q_u8((uint8_t*)z16, veorq_u8(l0, h0));
-
-            bytes -= 16, ++x16, ++z16;
-        } while (bytes >= 16);
-    }
-#endif
-#else
-# if defined(GF256_TRY_AVX2)
-    if (bytes >= 32 && CpuHasAVX2)
-    {
-        // Partial product tables; see above
-        const GF256_M256 table_lo_y = _mm256_loadu_si256(GF256Ctx.MM256.TABLE_LO_Y + y);
-        const GF256_M256 table_hi_y = _mm256_loadu_si256(GF256Ctx.MM256.TABLE_HI_Y + y);
-
-        // clr_mask = 0x0f0f0f0f0f0f0f0f0f0f0f0f0f0f0f0f
-        const GF256_M256 clr_mask = _mm256_set1_epi8(0x0f);
-
-        GF256_M256 * GF256_RESTRICT z32 = reinterpret_cast<GF256_M256 *>(vz);
-        const GF256_M256 * GF256_RESTRICT x32 = reinterpret_cast<const GF256_M256 *>(vx);
-
-        // Handle multiples of 32 bytes
-        do
-        {
-            // See above comments for details
-            GF256_M256 x0 = _mm256_loadu_si256(x32);
-            GF256_M256 l0 = _mm256_and_si256(x0, clr_mask);
-            x0 = _mm256_srli_epi64(x0, 4);
-            GF256_M256 h0 = _mm256_and_si256(x0, clr_mask);
-            l0 = _mm256_shuffle_epi8(table_lo_y, l0);
-            h0 = _mm256_shuffle_epi8(table_hi_y, h0);
-            _mm256_storeu_si256(z32, _mm256_xor_si256(l0, h0));
-
-            bytes -= 32, ++x32, ++z32;
-        } while (bytes >= 32);
-
-        z16 = reinterpret_cast<GF256_M128 *>(z32);
-        x16 = reinterpret_cast<const GF256_M128 *>(x32);
-    }
-# endif // GF256_TRY_AVX2
-    if (bytes >= 16 && CpuHasSSSE3)
-    {
-        // Partial product tables; see above
-        const GF256_M128 table_lo_y = _mm_loadu_si128(GF256Ctx.MM128.TABLE_LO_Y + y);
-        const GF256_M128 table_hi_y = _mm_loadu_si128(GF256Ctx.MM128.TABLE_HI_Y + y);
-
-        // clr_mask = 0x0f0f0f0f0f0f0f0f0f0f0f0f0f0f0f0f
-        const GF256_M128 clr_mask = _mm_set1_epi8(0x0f);
-
-        // Handle multiples of 16 bytes
-        do
-        {
-            // See above comments for details
-            GF256_M128 x0 = _mm_loadu_si128(x16);
-            GF256_M128 l0 = _mm_and_si128(x0, clr_mask);
-            x0 = _mm_srli_epi64(x0, 4);
-            GF256_M128 h0 = _mm_and_si128(x0, clr_mask);
-            l0 = _mm_shuffle_epi8(table_lo_y, l0);
-            h0 = _mm_shuffle_epi8(table_hi_y, h0);
-            _mm_storeu_si128(z16, _mm_xor_si128(l0, h0));
-
-            bytes -= 16, ++x16, ++z16;
-        } while (bytes >= 16);
-    }
-#endif
-
-    uint8_t * GF256_RESTRICT z1 = reinterpret_cast<uint8_t*>(z16);
-    const uint8_t * GF256_RESTRICT x1 = reinterpret_cast<const uint8_t*>(x16);
-    const uint8_t * GF256_RESTRICT table = GF256Ctx.GF256_MUL_TABLE + ((unsigned)y << 8);
-
-    // Handle blocks of 8 bytes
-    while (bytes >= 8)
+    // Handle blocks of 8 bytes
+    while (bytes >= 8)
     {
         uint64_t * GF256_RESTRICT z8 = reinterpret_cast<uint64_t *>(z1);
 #ifdef GF256_IS_BIG_ENDIAN
@@ -1265,174 +963,9 @@ extern "C" void gf256_mul_mem(void * GF256_RESTRICT vz, const void * GF256_RESTR
     }
 }
 
-extern "C" void gf256_muladd_mem(void * GF256_RESTRICT vz, uint8_t y,
-                                 const void * GF256_RESTRICT vx, int bytes)
+static GF256_FORCE_INLINE void gf256_muladd_mem_tail(
+    uint8_t * GF256_RESTRICT z1, uint8_t y, const uint8_t * GF256_RESTRICT x1, int bytes)
 {
-    // Use a single if-statement to handle special cases
-    if (y <= 1)
-    {
-        if (y == 1)
-            gf256_add_mem(vz, vx, bytes);
-        return;
-    }
-
-    GF256_M128 * GF256_RESTRICT z16 = reinterpret_cast<GF256_M128 *>(vz);
-    const GF256_M128 * GF256_RESTRICT x16 = reinterpret_cast<const GF256_M128 *>(vx);
-
-#if defined(GF256_TARGET_MOBILE)
-#if defined(GF256_TRY_NEON)
-    if (bytes >= 16 && CpuHasNeon)
-    {
-        // Partial product tables; see above
-        const GF256_M128 table_lo_y = vld1q_u8((uint8_t*)(GF256Ctx.MM128.TABLE_LO_Y + y));
-        const GF256_M128 table_hi_y = vld1q_u8((uint8_t*)(GF256Ctx.MM128.TABLE_HI_Y + y));
-
-        // clr_mask = 0x0f0f0f0f0f0f0f0f0f0f0f0f0f0f0f0f
-        const GF256_M128 clr_mask = vdupq_n_u8(0x0f);
-
-        // Handle multiples of 16 bytes
-        do
-        {
-            // See above comments for details
-            GF256_M128 x0 = vld1q_u8((uint8_t*)x16);
-            GF256_M128 l0 = vandq_u8(x0, clr_mask);
-
-            // x0 = vshrq_n_u8(x0, 4);
-            x0 = (GF256_M128)vshrq_n_u64( (uint64x2_t)x0, 4);
-            GF256_M128 h0 = vandq_u8(x0, clr_mask);
-            l0 = vqtbl1q_u8(table_lo_y, l0);
-            h0 = vqtbl1q_u8(table_hi_y, h0);
-            const GF256_M128 p0 = veorq_u8(l0, h0);
-            const GF256_M128 z0 = vld1q_u8((uint8_t*)z16);
-            vst1q_u8((uint8_t*)z16, veorq_u8(p0, z0));
-            bytes -= 16, ++x16, ++z16;
-        } while (bytes >= 16);
-    }
-#endif
-#else // GF256_TARGET_MOBILE
-# if defined(GF256_TRY_AVX2)
-    if (bytes >= 32 && CpuHasAVX2)
-    {
-        // Partial product tables; see above
-        const GF256_M256 table_lo_y = _mm256_loadu_si256(GF256Ctx.MM256.TABLE_LO_Y + y);
-        const GF256_M256 table_hi_y = _mm256_loadu_si256(GF256Ctx.MM256.TABLE_HI_Y + y);
-
-        // clr_mask = 0x0f0f0f0f0f0f0f0f0f0f0f0f0f0f0f0f
-        const GF256_M256 clr_mask = _mm256_set1_epi8(0x0f);
-
-        GF256_M256 * GF256_RESTRICT z32 = reinterpret_cast<GF256_M256 *>(z16);
-        const GF256_M256 * GF256_RESTRICT x32 = reinterpret_cast<const GF256_M256 *>(x16);
-
-        // On my Reed Solomon codec, the encoder unit test runs in 640 usec without and 550 usec with the optimization (86% of the original time)
-        const unsigned count = bytes / 64;
-        for (unsigned i = 0; i < count; ++i)
-        {
-            // See above comments for details
-            GF256_M256 x0 = _mm256_loadu_si256(x32 + i * 2);
-            GF256_M256 l0 = _mm256_and_si256(x0, clr_mask);
-            x0 = _mm256_srli_epi64(x0, 4);
-            const GF256_M256 z0 = _mm256_loadu_si256(z32 + i * 2);
-            GF256_M256 h0 = _mm256_and_si256(x0, clr_mask);
-            l0 = _mm256_shuffle_epi8(table_lo_y, l0);
-            h0 = _mm256_shuffle_epi8(table_hi_y, h0);
-            const GF256_M256 p0 = _mm256_xor_si256(l0, h0);
-            _mm256_storeu_si256(z32 + i * 2, _mm256_xor_si256(p0, z0));
-
-            GF256_M256 x1 = _mm256_loadu_si256(x32 + i * 2 + 1);
-            GF256_M256 l1 = _mm256_and_si256(x1, clr_mask);
-            x1 = _mm256_srli_epi64(x1, 4);
-            const GF256_M256 z1 = _mm256_loadu_si256(z32 + i * 2 + 1);
-            GF256_M256 h1 = _mm256_and_si256(x1, clr_mask);
-            l1 = _mm256_shuffle_epi8(table_lo_y, l1);
-            h1 = _mm256_shuffle_epi8(table_hi_y, h1);
-            const GF256_M256 p1 = _mm256_xor_si256(l1, h1);
-            _mm256_storeu_si256(z32 + i * 2 + 1, _mm256_xor_si256(p1, z1));
-        }
-        bytes -= count * 64;
-        z32 += count * 2;
-        x32 += count * 2;
-
-        if (bytes >= 32)
-        {
-            GF256_M256 x0 = _mm256_loadu_si256(x32);
-            GF256_M256 l0 = _mm256_and_si256(x0, clr_mask);
-            x0 = _mm256_srli_epi64(x0, 4);
-            GF256_M256 h0 = _mm256_and_si256(x0, clr_mask);
-            l0 = _mm256_shuffle_epi8(table_lo_y, l0);
-            h0 = _mm256_shuffle_epi8(table_hi_y, h0);
-            const GF256_M256 p0 = _mm256_xor_si256(l0, h0);
-            const GF256_M256 z0 = _mm256_loadu_si256(z32);
-            _mm256_storeu_si256(z32, _mm256_xor_si256(p0, z0));
-
-            bytes -= 32;
-            z32++;
-            x32++;
-        }
-
-        z16 = reinterpret_cast<GF256_M128 *>(z32);
-        x16 = reinterpret_cast<const GF256_M128 *>(x32);
-    }
-# endif // GF256_TRY_AVX2
-    if (bytes >= 16 && CpuHasSSSE3)
-    {
-        // Partial product tables; see above
-        const GF256_M128 table_lo_y = _mm_loadu_si128(GF256Ctx.MM128.TABLE_LO_Y + y);
-        const GF256_M128 table_hi_y = _mm_loadu_si128(GF256Ctx.MM128.TABLE_HI_Y + y);
-
-        // clr_mask = 0x0f0f0f0f0f0f0f0f0f0f0f0f0f0f0f0f
-        const GF256_M128 clr_mask = _mm_set1_epi8(0x0f);
-
-        // This unroll seems to provide about 7% speed boost when AVX2 is disabled
-        while (bytes >= 32)
-        {
-            bytes -= 32;
-
-            GF256_M128 x1 = _mm_loadu_si128(x16 + 1);
-            GF256_M128 l1 = _mm_and_si128(x1, clr_mask);
-            x1 = _mm_srli_epi64(x1, 4);
-            GF256_M128 h1 = _mm_and_si128(x1, clr_mask);
-            l1 = _mm_shuffle_epi8(table_lo_y, l1);
-            h1 = _mm_shuffle_epi8(table_hi_y, h1);
-            const GF256_M128 z1 = _mm_loadu_si128(z16 + 1);
-
-            GF256_M128 x0 = _mm_loadu_si128(x16);
-            GF256_M128 l0 = _mm_and_si128(x0, clr_mask);
-            x0 = _mm_srli_epi64(x0, 4);
-            GF256_M128 h0 = _mm_and_si128(x0, clr_mask);
-            l0 = _mm_shuffle_epi8(table_lo_y, l0);
-            h0 = _mm_shuffle_epi8(table_hi_y, h0);
-            const GF256_M128 z0 = _mm_loadu_si128(z16);
-
-            const GF256_M128 p1 = _mm_xor_si128(l1, h1);
-            _mm_storeu_si128(z16 + 1, _mm_xor_si128(p1, z1));
-
-            const GF256_M128 p0 = _mm_xor_si128(l0, h0);
-            _mm_storeu_si128(z16, _mm_xor_si128(p0, z0));
-
-            x16 += 2, z16 += 2;
-        }
-
-        // Handle multiples of 16 bytes
-        while (bytes >= 16)
-        {
-            // See above comments for details
-            GF256_M128 x0 = _mm_loadu_si128(x16);
-            GF256_M128 l0 = _mm_and_si128(x0, clr_mask);
-            x0 = _mm_srli_epi64(x0, 4);
-            GF256_M128 h0 = _mm_and_si128(x0, clr_mask);
-            l0 = _mm_shuffle_epi8(table_lo_y, l0);
-            h0 = _mm_shuffle_epi8(table_hi_y, h0);
-            const GF256_M128 p0 = _mm_xor_si128(l0, h0);
-            const GF256_M128 z0 = _mm_loadu_si128(z16);
-            _mm_storeu_si128(z16, _mm_xor_si128(p0, z0));
-
-            bytes -= 16, ++x16, ++z16;
-        }
-    }
-#endif // GF256_TARGET_MOBILE
-
-    uint8_t * GF256_RESTRICT z1 = reinterpret_cast<uint8_t*>(z16);
-    const uint8_t * GF256_RESTRICT x1 = reinterpret_cast<const uint8_t*>(x16);
     const uint8_t * GF256_RESTRICT table = GF256Ctx.GF256_MUL_TABLE + ((unsigned)y << 8);
 
     // Handle blocks of 8 bytes
@@ -1494,6 +1027,2143 @@ extern "C" void gf256_muladd_mem(void * GF256_RESTRICT vz, uint8_t y,
     }
 }
 
+
+static GF256_FORCE_INLINE void gf256_addn_mem_tail(
+    uint8_t * GF256_RESTRICT z1, const void * const * GF256_RESTRICT srcs,
+    unsigned count, int offset, int bytes)
+{
+    // Handle blocks of 8 bytes
+    for (; offset + 8 <= bytes; offset += 8)
+    {
+        uint64_t * GF256_RESTRICT z8 = reinterpret_cast<uint64_t *>(z1 + offset);
+        uint64_t word = *z8;
+        for (unsigned i = 0; i < count; ++i)
+            word ^= *reinterpret_cast<const uint64_t *>(static_cast<const uint8_t *>(srcs[i]) + offset);
+        *z8 = word;
+    }
+
+    // Handle final bytes
+    for (; offset < bytes; ++offset)
+    {
+        uint8_t value = z1[offset];
+        for (unsigned i = 0; i < count; ++i)
+            value ^= static_cast<const uint8_t *>(srcs[i])[offset];
+        z1[offset] = value;
+    }
+}
+
+
+static GF256_FORCE_INLINE void gf256_addn_muladdn_mem_tail(
+    uint8_t * GF256_RESTRICT z1,
+    const void * const * GF256_RESTRICT xs, unsigned xCount, uint8_t y,
+    const void * const * GF256_RESTRICT ws, unsigned wCount, int offset, int bytes)
+{
+    const uint8_t * GF256_RESTRICT table = GF256Ctx.GF256_MUL_TABLE + ((unsigned)y << 8);
+
+    for (; offset < bytes; ++offset)
+    {
+        uint8_t product = 0;
+        for (unsigned i = 0; i < wCount; ++i)
+            product ^= static_cast<const uint8_t *>(ws[i])[offset];
+
+        uint8_t value = z1[offset] ^ table[product];
+        for (unsigned i = 0; i < xCount; ++i)
+            value ^= static_cast<const uint8_t *>(xs[i])[offset];
+        z1[offset] = value;
+    }
+}
+
+static GF256_FORCE_INLINE void gf256_muladdn_mem_tail(
+    uint8_t * GF256_RESTRICT z1, const uint8_t * GF256_RESTRICT ys,
+    const void * const * GF256_RESTRICT xs, unsigned count, int offset, int bytes)
+{
+    for (; offset < bytes; ++offset)
+    {
+        uint8_t value = z1[offset];
+        for (unsigned i = 0; i < count; ++i)
+            value ^= GF256Ctx.GF256_MUL_TABLE[((unsigned)ys[i] << 8) + static_cast<const uint8_t *>(xs[i])[offset]];
+        z1[offset] = value;
+    }
+}
+
+
+//------------------------------------------------------------------------------
+// Portable Kernels
+
+static void gf256_add_mem_portable(void * GF256_RESTRICT vx,
+                                   const void * GF256_RESTRICT vy, int bytes)
+{
+    gf256_add_mem_tail(
+        reinterpret_cast<uint8_t *>(vx),
+        reinterpret_cast<const uint8_t *>(vy),
+        bytes);
+}
+
+static void gf256_add2_mem_portable(void * GF256_RESTRICT vz, const void * GF256_RESTRICT vx,
+                                    const void * GF256_RESTRICT vy, int bytes)
+{
+    gf256_add2_mem_tail(
+        reinterpret_cast<uint8_t *>(vz),
+        reinterpret_cast<const uint8_t *>(vx),
+        reinterpret_cast<const uint8_t *>(vy),
+        bytes);
+}
+
+static void gf256_addset_mem_portable(void * GF256_RESTRICT vz, const void * GF256_RESTRICT vx,
+                                      const void * GF256_RESTRICT vy, int bytes)
+{
+    gf256_addset_mem_tail(
+        reinterpret_cast<uint8_t *>(vz),
+        reinterpret_cast<const uint8_t *>(vx),
+        reinterpret_cast<const uint8_t *>(vy),
+        bytes);
+}
+
+static void gf256_addn_mem_portable(void * GF256_RESTRICT vz, const void * const * GF256_RESTRICT srcs,
+                                  unsigned count, int bytes)
+{
+    gf256_addn_mem_tail(reinterpret_cast<uint8_t *>(vz), srcs, count, 0, bytes);
+}
+
+static void gf256_addn_muladdn_mem_portable(void * GF256_RESTRICT vz,
+                                           const void * const * GF256_RESTRICT xs, unsigned xCount, uint8_t y,
+                                           const void * const * GF256_RESTRICT ws, unsigned wCount, int bytes)
+{
+    gf256_addn_muladdn_mem_tail(reinterpret_cast<uint8_t *>(vz), xs, xCount, y, ws, wCount, 0, bytes);
+}
+
+static void gf256_muladdn_mem_portable(void * GF256_RESTRICT vz, const uint8_t * GF256_RESTRICT ys,
+                                       const void * const * GF256_RESTRICT xs, unsigned count, int bytes)
+{
+    gf256_muladdn_mem_tail(reinterpret_cast<uint8_t *>(vz), ys, xs, count, 0, bytes);
+}
+
+static void gf256_mul_mem_portable(void * GF256_RESTRICT vz,
+                                   const void * GF256_RESTRICT vx, uint8_t y, int bytes)
+{
+    gf256_mul_mem_tail(
+        reinterpret_cast<uint8_t *>(vz),
+        reinterpret_cast<const uint8_t *>(vx),
+        y,
+        bytes);
+}
+
+static void gf256_muladd_mem_portable(void * GF256_RESTRICT vz, uint8_t y,
+                                      const void * GF256_RESTRICT vx, int bytes)
+{
+    gf256_muladd_mem_tail(
+        reinterpret_cast<uint8_t *>(vz),
+        y,
+        reinterpret_cast<const uint8_t *>(vx),
+        bytes);
+}
+
+
+#if defined(GF256_TRY_NEON)
+
+//------------------------------------------------------------------------------
+// NEON Kernels
+
+static void gf256_add_mem_neon(void * GF256_RESTRICT vx,
+                               const void * GF256_RESTRICT vy, int bytes)
+{
+    GF256_M128 * GF256_RESTRICT x16 = reinterpret_cast<GF256_M128 *>(vx);
+    const GF256_M128 * GF256_RESTRICT y16 = reinterpret_cast<const GF256_M128 *>(vy);
+
+    // Handle multiples of 64 bytes
+    while (bytes >= 64)
+    {
+        GF256_M128 x0 = vld1q_u8((uint8_t*) x16);
+        GF256_M128 x1 = vld1q_u8((uint8_t*)(x16 + 1) );
+        GF256_M128 x2 = vld1q_u8((uint8_t*)(x16 + 2) );
+        GF256_M128 x3 = vld1q_u8((uint8_t*)(x16 + 3) );
+        GF256_M128 y0 = vld1q_u8((uint8_t*)y16);
+        GF256_M128 y1 = vld1q_u8((uint8_t*)(y16 + 1));
+        GF256_M128 y2 = vld1q_u8((uint8_t*)(y16 + 2));
+        GF256_M128 y3 = vld1q_u8((uint8_t*)(y16 + 3));
+
+        vst1q_u8((uint8_t*)x16,     veorq_u8(x0, y0));
+        vst1q_u8((uint8_t*)(x16 + 1), veorq_u8(x1, y1));
+        vst1q_u8((uint8_t*)(x16 + 2), veorq_u8(x2, y2));
+        vst1q_u8((uint8_t*)(x16 + 3), veorq_u8(x3, y3));
+
+        bytes -= 64, x16 += 4, y16 += 4;
+    }
+
+    // Handle multiples of 16 bytes
+    while (bytes >= 16)
+    {
+        GF256_M128 x0 = vld1q_u8((uint8_t*)x16);
+        GF256_M128 y0 = vld1q_u8((uint8_t*)y16);
+
+        vst1q_u8((uint8_t*)x16, veorq_u8(x0, y0));
+
+        bytes -= 16, ++x16, ++y16;
+    }
+
+    gf256_add_mem_tail(
+        reinterpret_cast<uint8_t *>(x16),
+        reinterpret_cast<const uint8_t *>(y16),
+        bytes);
+}
+
+static void gf256_add2_mem_neon(void * GF256_RESTRICT vz, const void * GF256_RESTRICT vx,
+                                const void * GF256_RESTRICT vy, int bytes)
+{
+    GF256_M128 * GF256_RESTRICT z16 = reinterpret_cast<GF256_M128*>(vz);
+    const GF256_M128 * GF256_RESTRICT x16 = reinterpret_cast<const GF256_M128*>(vx);
+    const GF256_M128 * GF256_RESTRICT y16 = reinterpret_cast<const GF256_M128*>(vy);
+
+    // Handle multiples of 16 bytes
+    while (bytes >= 16)
+    {
+        // z[i] = z[i] xor x[i] xor y[i]
+        vst1q_u8((uint8_t*)z16,
+            veorq_u8(
+                vld1q_u8((uint8_t*)z16),
+                veorq_u8(
+                    vld1q_u8((uint8_t*)x16),
+                    vld1q_u8((uint8_t*)y16))));
+
+        bytes -= 16, ++x16, ++y16, ++z16;
+    }
+
+    gf256_add2_mem_tail(
+        reinterpret_cast<uint8_t *>(z16),
+        reinterpret_cast<const uint8_t *>(x16),
+        reinterpret_cast<const uint8_t *>(y16),
+        bytes);
+}
+
+static void gf256_addset_mem_neon(void * GF256_RESTRICT vz, const void * GF256_RESTRICT vx,
+                                  const void * GF256_RESTRICT vy, int bytes)
+{
+    GF256_M128 * GF256_RESTRICT z16 = reinterpret_cast<GF256_M128*>(vz);
+    const GF256_M128 * GF256_RESTRICT x16 = reinterpret_cast<const GF256_M128*>(vx);
+    const GF256_M128 * GF256_RESTRICT y16 = reinterpret_cast<const GF256_M128*>(vy);
+
+    // Handle multiples of 64 bytes
+    while (bytes >= 64)
+    {
+        GF256_M128 x0 = vld1q_u8((uint8_t*)x16);
+        GF256_M128 x1 = vld1q_u8((uint8_t*)(x16 + 1));
+        GF256_M128 x2 = vld1q_u8((uint8_t*)(x16 + 2));
+        GF256_M128 x3 = vld1q_u8((uint8_t*)(x16 + 3));
+        GF256_M128 y0 = vld1q_u8((uint8_t*)(y16));
+        GF256_M128 y1 = vld1q_u8((uint8_t*)(y16 + 1));
+        GF256_M128 y2 = vld1q_u8((uint8_t*)(y16 + 2));
+        GF256_M128 y3 = vld1q_u8((uint8_t*)(y16 + 3));
+
+        vst1q_u8((uint8_t*)z16,     veorq_u8(x0, y0));
+        vst1q_u8((uint8_t*)(z16 + 1), veorq_u8(x1, y1));
+        vst1q_u8((uint8_t*)(z16 + 2), veorq_u8(x2, y2));
+        vst1q_u8((uint8_t*)(z16 + 3), veorq_u8(x3, y3));
+
+        bytes -= 64, x16 += 4, y16 += 4, z16 += 4;
+    }
+
+    // Handle multiples of 16 bytes
+    while (bytes >= 16)
+    {
+        // z[i] = x[i] xor y[i]
+        vst1q_u8((uint8_t*)z16,
+                 veorq_u8(
+                     vld1q_u8((uint8_t*)x16),
+                     vld1q_u8((uint8_t*)y16)));
+
+        bytes -= 16, ++x16, ++y16, ++z16;
+    }
+
+    gf256_addset_mem_tail(
+        reinterpret_cast<uint8_t *>(z16),
+        reinterpret_cast<const uint8_t *>(x16),
+        reinterpret_cast<const uint8_t *>(y16),
+        bytes);
+}
+
+static void gf256_addn_mem_neon(void * GF256_RESTRICT vz, const void * const * GF256_RESTRICT srcs,
+                               unsigned count, int bytes)
+{
+    uint8_t * GF256_RESTRICT z1 = reinterpret_cast<uint8_t *>(vz);
+    int offset = 0;
+
+    // Handle multiples of 16 bytes
+    for (; offset + 16 <= bytes; offset += 16)
+    {
+        GF256_M128 z0 = vld1q_u8(z1 + offset);
+        for (unsigned i = 0; i < count; ++i)
+            z0 = veorq_u8(z0, vld1q_u8(static_cast<const uint8_t *>(srcs[i]) + offset));
+        vst1q_u8(z1 + offset, z0);
+    }
+
+    gf256_addn_mem_tail(z1, srcs, count, offset, bytes);
+}
+
+static void gf256_addn_muladdn_mem_neon(void * GF256_RESTRICT vz,
+                                       const void * const * GF256_RESTRICT xs, unsigned xCount, uint8_t y,
+                                       const void * const * GF256_RESTRICT ws, unsigned wCount, int bytes)
+{
+    uint8_t * GF256_RESTRICT z1 = reinterpret_cast<uint8_t *>(vz);
+    int offset = 0;
+
+    if (bytes >= 16)
+    {
+        // Partial product tables; see above
+        const GF256_M128 table_lo_y = vld1q_u8((uint8_t*)(GF256Ctx.MM128.TABLE_LO_Y + y));
+        const GF256_M128 table_hi_y = vld1q_u8((uint8_t*)(GF256Ctx.MM128.TABLE_HI_Y + y));
+
+        // clr_mask = 0x0f0f0f0f0f0f0f0f0f0f0f0f0f0f0f0f
+        const GF256_M128 clr_mask = vdupq_n_u8(0x0f);
+
+        // Handle multiples of 16 bytes
+        for (; offset + 16 <= bytes; offset += 16)
+        {
+            GF256_M128 p0 = vdupq_n_u8(0);
+            for (unsigned i = 0; i < wCount; ++i)
+                p0 = veorq_u8(p0, vld1q_u8(static_cast<const uint8_t *>(ws[i]) + offset));
+
+            GF256_M128 z0 = vld1q_u8(z1 + offset);
+            for (unsigned i = 0; i < xCount; ++i)
+                z0 = veorq_u8(z0, vld1q_u8(static_cast<const uint8_t *>(xs[i]) + offset));
+
+            // See above comments for details
+            GF256_M128 l0 = vandq_u8(p0, clr_mask);
+            p0 = vshrq_n_u8(p0, 4);
+            GF256_M128 h0 = vandq_u8(p0, clr_mask);
+            l0 = vqtbl1q_u8(table_lo_y, l0);
+            h0 = vqtbl1q_u8(table_hi_y, h0);
+            vst1q_u8(z1 + offset, veorq_u8(z0, veorq_u8(l0, h0)));
+        }
+    }
+
+    gf256_addn_muladdn_mem_tail(z1, xs, xCount, y, ws, wCount, offset, bytes);
+}
+
+static void gf256_muladdn_mem_neon(void * GF256_RESTRICT vz, const uint8_t * GF256_RESTRICT ys,
+                                   const void * const * GF256_RESTRICT xs, unsigned count, int bytes)
+{
+    uint8_t * GF256_RESTRICT z1 = reinterpret_cast<uint8_t *>(vz);
+    int offset = 0;
+
+    // clr_mask = 0x0f0f0f0f0f0f0f0f0f0f0f0f0f0f0f0f
+    const GF256_M128 clr_mask = vdupq_n_u8(0x0f);
+
+    // Handle multiples of 16 bytes
+    for (; offset + 16 <= bytes; offset += 16)
+    {
+        GF256_M128 z0 = vld1q_u8(z1 + offset);
+        for (unsigned i = 0; i < count; ++i)
+        {
+            // Partial product tables; see above
+            const GF256_M128 table_lo_y = vld1q_u8((uint8_t*)(GF256Ctx.MM128.TABLE_LO_Y + ys[i]));
+            const GF256_M128 table_hi_y = vld1q_u8((uint8_t*)(GF256Ctx.MM128.TABLE_HI_Y + ys[i]));
+
+            GF256_M128 x0 = vld1q_u8(static_cast<const uint8_t *>(xs[i]) + offset);
+            GF256_M128 l0 = vandq_u8(x0, clr_mask);
+            x0 = vshrq_n_u8(x0, 4);
+            GF256_M128 h0 = vandq_u8(x0, clr_mask);
+            l0 = vqtbl1q_u8(table_lo_y, l0);
+            h0 = vqtbl1q_u8(table_hi_y, h0);
+            z0 = veorq_u8(z0, veorq_u8(l0, h0));
+        }
+        vst1q_u8(z1 + offset, z0);
+    }
+
+    gf256_muladdn_mem_tail(z1, ys, xs, count, offset, bytes);
+}
+
+static void gf256_mul_mem_neon(void * GF256_RESTRICT vz,
+                               const void * GF256_RESTRICT vx, uint8_t y, int bytes)
+{
+    GF256_M128 * GF256_RESTRICT z16 = reinterpret_cast<GF256_M128 *>(vz);
+    const GF256_M128 * GF256_RESTRICT x16 = reinterpret_cast<const GF256_M128 *>(vx);
+
+    if (bytes >= 16)
+    {
+        // Partial product tables; see above
+        const GF256_M128 table_lo_y = vld1q_u8((uint8_t*)(GF256Ctx.MM128.TABLE_LO_Y + y));
+        const GF256_M128 table_hi_y = vld1q_u8((uint8_t*)(GF256Ctx.MM128.TABLE_HI_Y + y));
+
+        // clr_mask = 0x0f0f0f0f0f0f0f0f0f0f0f0f0f0f0f0f
+        const GF256_M128 clr_mask = vdupq_n_u8(0x0f);
+
+        // Handle multiples of 16 bytes
+        do
+        {
+            // See above comments for details
+            GF256_M128 x0 = vld1q_u8((uint8_t*)x16);
+            GF256_M128 l0 = vandq_u8(x0, clr_mask);
+            x0 = vshrq_n_u8(x0, 4);
+            GF256_M128 h0 = vandq_u8(x0, clr_mask);
+            l0 = vqtbl1q_u8(table_lo_y, l0);
+            h0 = vqtbl1q_u8(table_hi_y, h0);
+            vst1q_u8((uint8_t*)z16, veorq_u8(l0, h0));
+
+            bytes -= 16, ++x16, ++z16;
+        } while (bytes >= 16);
+    }
+
+    gf256_mul_mem_tail(
+        reinterpret_cast<uint8_t *>(z16),
+        reinterpret_cast<const uint8_t *>(x16),
+        y,
+        bytes);
+}
+
+static void gf256_muladd_mem_neon(void * GF256_RESTRICT vz, uint8_t y,
+                                  const void * GF256_RESTRICT vx, int bytes)
+{
+    GF256_M128 * GF256_RESTRICT z16 = reinterpret_cast<GF256_M128 *>(vz);
+    const GF256_M128 * GF256_RESTRICT x16 = reinterpret_cast<const GF256_M128 *>(vx);
+
+    if (bytes >= 16)
+    {
+        // Partial product tables; see above
+        const GF256_M128 table_lo_y = vld1q_u8((uint8_t*)(GF256Ctx.MM128.TABLE_LO_Y + y));
+        const GF256_M128 table_hi_y = vld1q_u8((uint8_t*)(GF256Ctx.MM128.TABLE_HI_Y + y));
+
+        // clr_mask = 0x0f0f0f0f0f0f0f0f0f0f0f0f0f0f0f0f
+        const GF256_M128 clr_mask = vdupq_n_u8(0x0f);
+
+        // Handle multiples of 16 bytes
+        do
+        {
+            // See above comments for details
+            GF256_M128 x0 = vld1q_u8((uint8_t*)x16);
+            GF256_M128 l0 = vandq_u8(x0, clr_mask);
+
+            // x0 = vshrq_n_u8(x0, 4);
+            x0 = (GF256_M128)vshrq_n_u64( (uint64x2_t)x0, 4);
+            GF256_M128 h0 = vandq_u8(x0, clr_mask);
+            l0 = vqtbl1q_u8(table_lo_y, l0);
+            h0 = vqtbl1q_u8(table_hi_y, h0);
+            const GF256_M128 p0 = veorq_u8(l0, h0);
+            const GF256_M128 z0 = vld1q_u8((uint8_t*)z16);
+            vst1q_u8((uint8_t*)z16, veorq_u8(p0, z0));
+            bytes -= 16, ++x16, ++z16;
+        } while (bytes >= 16);
+    }
+
+    gf256_muladd_mem_tail(
+        reinterpret_cast<uint8_t *>(z16),
+        y,
+        reinterpret_cast<const uint8_t *>(x16),
+        bytes);
+}
+
+#endif // GF256_TRY_NEON
+
+
+#if !defined(GF256_TARGET_MOBILE)
+
+//------------------------------------------------------------------------------
+// SSE2/SSSE3 Blocks and Kernels
+
+// x[] += y[] for multiples of 16 bytes
+static GF256_FORCE_INLINE void gf256_add_mem_sse2_blocks(
+    uint8_t *& vx, const uint8_t *& vy, int& bytes)
+{
+    GF256_M128 * GF256_RESTRICT x16 = reinterpret_cast<GF256_M128 *>(vx);
+    const GF256_M128 * GF256_RESTRICT y16 = reinterpret_cast<const GF256_M128 *>(vy);
+
+    while (bytes >= 64)
+    {
+        GF256_M128 x0 = _mm_loadu_si128(x16);
+        GF256_M128 y0 = _mm_loadu_si128(y16);
+        x0 = _mm_xor_si128(x0, y0);
+        GF256_M128 x1 = _mm_loadu_si128(x16 + 1);
+        GF256_M128 y1 = _mm_loadu_si128(y16 + 1);
+        x1 = _mm_xor_si128(x1, y1);
+        GF256_M128 x2 = _mm_loadu_si128(x16 + 2);
+        GF256_M128 y2 = _mm_loadu_si128(y16 + 2);
+        x2 = _mm_xor_si128(x2, y2);
+        GF256_M128 x3 = _mm_loadu_si128(x16 + 3);
+        GF256_M128 y3 = _mm_loadu_si128(y16 + 3);
+        x3 = _mm_xor_si128(x3, y3);
+
+        _mm_storeu_si128(x16, x0);
+        _mm_storeu_si128(x16 + 1, x1);
+        _mm_storeu_si128(x16 + 2, x2);
+        _mm_storeu_si128(x16 + 3, x3);
+
+        bytes -= 64, x16 += 4, y16 += 4;
+    }
+
+    // Handle multiples of 16 bytes
+    while (bytes >= 16)
+    {
+        // x[i] = x[i] xor y[i]
+        _mm_storeu_si128(x16,
+            _mm_xor_si128(
+                _mm_loadu_si128(x16),
+                _mm_loadu_si128(y16)));
+
+        bytes -= 16, ++x16, ++y16;
+    }
+
+    vx = reinterpret_cast<uint8_t *>(x16);
+    vy = reinterpret_cast<const uint8_t *>(y16);
+}
+
+// z[] += x[] + y[] for multiples of 16 bytes
+static GF256_FORCE_INLINE void gf256_add2_mem_sse2_blocks(
+    uint8_t *& vz, const uint8_t *& vx, const uint8_t *& vy, int& bytes)
+{
+    GF256_M128 * GF256_RESTRICT z16 = reinterpret_cast<GF256_M128*>(vz);
+    const GF256_M128 * GF256_RESTRICT x16 = reinterpret_cast<const GF256_M128*>(vx);
+    const GF256_M128 * GF256_RESTRICT y16 = reinterpret_cast<const GF256_M128*>(vy);
+
+    // Handle multiples of 16 bytes
+    while (bytes >= 16)
+    {
+        // z[i] = z[i] xor x[i] xor y[i]
+        _mm_storeu_si128(z16,
+            _mm_xor_si128(
+                _mm_loadu_si128(z16),
+                _mm_xor_si128(
+                    _mm_loadu_si128(x16),
+                    _mm_loadu_si128(y16))));
+
+        bytes -= 16, ++x16, ++y16, ++z16;
+    }
+
+    vz = reinterpret_cast<uint8_t *>(z16);
+    vx = reinterpret_cast<const uint8_t *>(x16);
+    vy = reinterpret_cast<const uint8_t *>(y16);
+}
+
+// z[] = x[] + y[] for multiples of 16 bytes
+static GF256_FORCE_INLINE void gf256_addset_mem_sse2_blocks(
+    uint8_t *& vz, const uint8_t *& vx, const uint8_t *& vy, int& bytes)
+{
+    GF256_M128 * GF256_RESTRICT z16 = reinterpret_cast<GF256_M128*>(vz);
+    const GF256_M128 * GF256_RESTRICT x16 = reinterpret_cast<const GF256_M128*>(vx);
+    const GF256_M128 * GF256_RESTRICT y16 = reinterpret_cast<const GF256_M128*>(vy);
+
+    // Handle multiples of 64 bytes
+    while (bytes >= 64)
+    {
+        GF256_M128 x0 = _mm_loadu_si128(x16);
+        GF256_M128 x1 = _mm_loadu_si128(x16 + 1);
+        GF256_M128 x2 = _mm_loadu_si128(x16 + 2);
+        GF256_M128 x3 = _mm_loadu_si128(x16 + 3);
+        GF256_M128 y0 = _mm_loadu_si128(y16);
+        GF256_M128 y1 = _mm_loadu_si128(y16 + 1);
+        GF256_M128 y2 = _mm_loadu_si128(y16 + 2);
+        GF256_M128 y3 = _mm_loadu_si128(y16 + 3);
+
+        _mm_storeu_si128(z16,     _mm_xor_si128(x0, y0));
+        _mm_storeu_si128(z16 + 1, _mm_xor_si128(x1, y1));
+        _mm_storeu_si128(z16 + 2, _mm_xor_si128(x2, y2));
+        _mm_storeu_si128(z16 + 3, _mm_xor_si128(x3, y3));
+
+        bytes -= 64, x16 += 4, y16 += 4, z16 += 4;
+    }
+
+    // Handle multiples of 16 bytes
+    while (bytes >= 16)
+    {
+        // z[i] = x[i] xor y[i]
+        _mm_storeu_si128(z16,
+            _mm_xor_si128(
+                _mm_loadu_si128(x16),
+                _mm_loadu_si128(y16)));
+
+        bytes -= 16, ++x16, ++y16, ++z16;
+    }
+
+    vz = reinterpret_cast<uint8_t *>(z16);
+    vx = reinterpret_cast<const uint8_t *>(x16);
+    vy = reinterpret_cast<const uint8_t *>(y16);
+}
+
+// z[] += srcs[0][] + ... + srcs[count-1][] for multiples of 16 bytes
+static GF256_FORCE_INLINE void gf256_addn_mem_sse2_blocks(
+    uint8_t * GF256_RESTRICT z1, const void * const * GF256_RESTRICT srcs,
+    unsigned count, int& offset, int bytes)
+{
+    // Handle multiples of 64 bytes
+    for (; offset + 64 <= bytes; offset += 64)
+    {
+        GF256_M128 * GF256_RESTRICT z16 = reinterpret_cast<GF256_M128 *>(z1 + offset);
+        GF256_M128 z0 = _mm_loadu_si128(z16);
+        GF256_M128 z1v = _mm_loadu_si128(z16 + 1);
+        GF256_M128 z2 = _mm_loadu_si128(z16 + 2);
+        GF256_M128 z3 = _mm_loadu_si128(z16 + 3);
+
+        for (unsigned i = 0; i < count; ++i)
+        {
+            const GF256_M128 * GF256_RESTRICT x16 = reinterpret_cast<const GF256_M128 *>(
+                static_cast<const uint8_t *>(srcs[i]) + offset);
+            z0 = _mm_xor_si128(z0, _mm_loadu_si128(x16));
+            z1v = _mm_xor_si128(z1v, _mm_loadu_si128(x16 + 1));
+            z2 = _mm_xor_si128(z2, _mm_loadu_si128(x16 + 2));
+            z3 = _mm_xor_si128(z3, _mm_loadu_si128(x16 + 3));
+        }
+
+        _mm_storeu_si128(z16, z0);
+        _mm_storeu_si128(z16 + 1, z1v);
+        _mm_storeu_si128(z16 + 2, z2);
+        _mm_storeu_si128(z16 + 3, z3);
+    }
+
+    // Handle multiples of 16 bytes
+    for (; offset + 16 <= bytes; offset += 16)
+    {
+        GF256_M128 * GF256_RESTRICT z16 = reinterpret_cast<GF256_M128 *>(z1 + offset);
+        GF256_M128 z0 = _mm_loadu_si128(z16);
+
+        for (unsigned i = 0; i < count; ++i)
+        {
+            const GF256_M128 * GF256_RESTRICT x16 = reinterpret_cast<const GF256_M128 *>(
+                static_cast<const uint8_t *>(srcs[i]) + offset);
+            z0 = _mm_xor_si128(z0, _mm_loadu_si128(x16));
+        }
+
+        _mm_storeu_si128(z16, z0);
+    }
+}
+
+// z[] = x[] * y for multiples of 16 bytes
+GF256_TARGET_SSSE3 static GF256_FORCE_INLINE void gf256_mul_mem_ssse3_blocks(
+    uint8_t *& vz, const uint8_t *& vx, uint8_t y, int& bytes)
+{
+    if (bytes < 16)
+        return;
+
+    GF256_M128 * GF256_RESTRICT z16 = reinterpret_cast<GF256_M128 *>(vz);
+    const GF256_M128 * GF256_RESTRICT x16 = reinterpret_cast<const GF256_M128 *>(vx);
+
+    // Partial product tables; see above
+    const GF256_M128 table_lo_y = _mm_loadu_si128(GF256Ctx.MM128.TABLE_LO_Y + y);
+    const GF256_M128 table_hi_y = _mm_loadu_si128(GF256Ctx.MM128.TABLE_HI_Y + y);
+
+    // clr_mask = 0x0f0f0f0f0f0f0f0f0f0f0f0f0f0f0f0f
+    const GF256_M128 clr_mask = _mm_set1_epi8(0x0f);
+
+    // Handle multiples of 16 bytes
+    do
+    {
+        // See above comments for details
+        GF256_M128 x0 = _mm_loadu_si128(x16);
+        GF256_M128 l0 = _mm_and_si128(x0, clr_mask);
+        x0 = _mm_srli_epi64(x0, 4);
+        GF256_M128 h0 = _mm_and_si128(x0, clr_mask);
+        l0 = _mm_shuffle_epi8(table_lo_y, l0);
+        h0 = _mm_shuffle_epi8(table_hi_y, h0);
+        _mm_storeu_si128(z16, _mm_xor_si128(l0, h0));
+
+        bytes -= 16, ++x16, ++z16;
+    } while (bytes >= 16);
+
+    vz = reinterpret_cast<uint8_t *>(z16);
+    vx = reinterpret_cast<const uint8_t *>(x16);
+}
+
+// z[] += x[] * y for multiples of 16 bytes
+GF256_TARGET_SSSE3 static GF256_FORCE_INLINE void gf256_muladd_mem_ssse3_blocks(
+    uint8_t *& vz, uint8_t y, const uint8_t *& vx, int& bytes)
+{
+    if (bytes < 16)
+        return;
+
+    GF256_M128 * GF256_RESTRICT z16 = reinterpret_cast<GF256_M128 *>(vz);
+    const GF256_M128 * GF256_RESTRICT x16 = reinterpret_cast<const GF256_M128 *>(vx);
+
+    // Partial product tables; see above
+    const GF256_M128 table_lo_y = _mm_loadu_si128(GF256Ctx.MM128.TABLE_LO_Y + y);
+    const GF256_M128 table_hi_y = _mm_loadu_si128(GF256Ctx.MM128.TABLE_HI_Y + y);
+
+    // clr_mask = 0x0f0f0f0f0f0f0f0f0f0f0f0f0f0f0f0f
+    const GF256_M128 clr_mask = _mm_set1_epi8(0x0f);
+
+    // This unroll seems to provide about 7% speed boost when AVX2 is disabled
+    while (bytes >= 32)
+    {
+        bytes -= 32;
+
+        GF256_M128 x1 = _mm_loadu_si128(x16 + 1);
+        GF256_M128 l1 = _mm_and_si128(x1, clr_mask);
+        x1 = _mm_srli_epi64(x1, 4);
+        GF256_M128 h1 = _mm_and_si128(x1, clr_mask);
+        l1 = _mm_shuffle_epi8(table_lo_y, l1);
+        h1 = _mm_shuffle_epi8(table_hi_y, h1);
+        const GF256_M128 z1 = _mm_loadu_si128(z16 + 1);
+
+        GF256_M128 x0 = _mm_loadu_si128(x16);
+        GF256_M128 l0 = _mm_and_si128(x0, clr_mask);
+        x0 = _mm_srli_epi64(x0, 4);
+        GF256_M128 h0 = _mm_and_si128(x0, clr_mask);
+        l0 = _mm_shuffle_epi8(table_lo_y, l0);
+        h0 = _mm_shuffle_epi8(table_hi_y, h0);
+        const GF256_M128 z0 = _mm_loadu_si128(z16);
+
+        const GF256_M128 p1 = _mm_xor_si128(l1, h1);
+        _mm_storeu_si128(z16 + 1, _mm_xor_si128(p1, z1));
+
+        const GF256_M128 p0 = _mm_xor_si128(l0, h0);
+        _mm_storeu_si128(z16, _mm_xor_si128(p0, z0));
+
+        x16 += 2, z16 += 2;
+    }
+
+    // Handle multiples of 16 bytes
+    while (bytes >= 16)
+    {
+        // See above comments for details
+        GF256_M128 x0 = _mm_loadu_si128(x16);
+        GF256_M128 l0 = _mm_and_si128(x0, clr_mask);
+        x0 = _mm_srli_epi64(x0, 4);
+        GF256_M128 h0 = _mm_and_si128(x0, clr_mask);
+        l0 = _mm_shuffle_epi8(table_lo_y, l0);
+        h0 = _mm_shuffle_epi8(table_hi_y, h0);
+        const GF256_M128 p0 = _mm_xor_si128(l0, h0);
+        const GF256_M128 z0 = _mm_loadu_si128(z16);
+        _mm_storeu_si128(z16, _mm_xor_si128(p0, z0));
+
+        bytes -= 16, ++x16, ++z16;
+    }
+
+    vz = reinterpret_cast<uint8_t *>(z16);
+    vx = reinterpret_cast<const uint8_t *>(x16);
+}
+
+// z[] += sum of xs[] + y * sum of ws[] for multiples of 16 bytes
+GF256_TARGET_SSSE3 static GF256_FORCE_INLINE void gf256_addn_muladdn_mem_ssse3_blocks(
+    uint8_t * GF256_RESTRICT z1,
+    const void * const * GF256_RESTRICT xs, unsigned xCount, uint8_t y,
+    const void * const * GF256_RESTRICT ws, unsigned wCount, int& offset, int bytes)
+{
+    if (offset + 16 > bytes)
+        return;
+
+    // Partial product tables; see above
+    const GF256_M128 table_lo_y = _mm_loadu_si128(GF256Ctx.MM128.TABLE_LO_Y + y);
+    const GF256_M128 table_hi_y = _mm_loadu_si128(GF256Ctx.MM128.TABLE_HI_Y + y);
+
+    // clr_mask = 0x0f0f0f0f0f0f0f0f0f0f0f0f0f0f0f0f
+    const GF256_M128 clr_mask = _mm_set1_epi8(0x0f);
+
+    // Handle multiples of 16 bytes
+    for (; offset + 16 <= bytes; offset += 16)
+    {
+        // Product stays in a register until it is multiplied by y
+        GF256_M128 p0 = _mm_setzero_si128();
+        for (unsigned i = 0; i < wCount; ++i)
+            p0 = _mm_xor_si128(p0, _mm_loadu_si128(reinterpret_cast<const GF256_M128 *>(
+                static_cast<const uint8_t *>(ws[i]) + offset)));
+
+        GF256_M128 * GF256_RESTRICT z = reinterpret_cast<GF256_M128 *>(z1 + offset);
+        GF256_M128 z0 = _mm_loadu_si128(z);
+        for (unsigned i = 0; i < xCount; ++i)
+            z0 = _mm_xor_si128(z0, _mm_loadu_si128(reinterpret_cast<const GF256_M128 *>(
+                static_cast<const uint8_t *>(xs[i]) + offset)));
+
+        // See above comments for details
+        GF256_M128 l0 = _mm_and_si128(p0, clr_mask);
+        p0 = _mm_srli_epi64(p0, 4);
+        GF256_M128 h0 = _mm_and_si128(p0, clr_mask);
+        l0 = _mm_shuffle_epi8(table_lo_y, l0);
+        h0 = _mm_shuffle_epi8(table_hi_y, h0);
+        _mm_storeu_si128(z, _mm_xor_si128(z0, _mm_xor_si128(l0, h0)));
+    }
+}
+
+GF256_TARGET_SSSE3 static GF256_FORCE_INLINE GF256_M128 gf256_muladd_ssse3_vec(
+    GF256_M128 z0, GF256_M128 x0, GF256_M128 table_lo_y, GF256_M128 table_hi_y, GF256_M128 clr_mask)
+{
+    // See above comments for details
+    GF256_M128 l0 = _mm_and_si128(x0, clr_mask);
+    x0 = _mm_srli_epi64(x0, 4);
+    GF256_M128 h0 = _mm_and_si128(x0, clr_mask);
+    l0 = _mm_shuffle_epi8(table_lo_y, l0);
+    h0 = _mm_shuffle_epi8(table_hi_y, h0);
+    return _mm_xor_si128(z0, _mm_xor_si128(l0, h0));
+}
+
+// z[] += sum of ys[] * xs[] for multiples of 16 bytes
+GF256_TARGET_SSSE3 static GF256_FORCE_INLINE void gf256_muladdn_mem_ssse3_blocks(
+    uint8_t * GF256_RESTRICT z1, const uint8_t * GF256_RESTRICT ys,
+    const void * const * GF256_RESTRICT xs, unsigned count, int& offset, int bytes)
+{
+    // clr_mask = 0x0f0f0f0f0f0f0f0f0f0f0f0f0f0f0f0f
+    const GF256_M128 clr_mask = _mm_set1_epi8(0x0f);
+
+    // Handle multiples of 64 bytes, keeping a tile of the destination in
+    // registers so the partial product tables are loaded once per tile
+    for (; offset + 64 <= bytes; offset += 64)
+    {
+        GF256_M128 * GF256_RESTRICT z = reinterpret_cast<GF256_M128 *>(z1 + offset);
+        GF256_M128 z0 = _mm_loadu_si128(z);
+        GF256_M128 z1_ = _mm_loadu_si128(z + 1);
+        GF256_M128 z2 = _mm_loadu_si128(z + 2);
+        GF256_M128 z3 = _mm_loadu_si128(z + 3);
+
+        for (unsigned i = 0; i < count; ++i)
+        {
+            const GF256_M128 table_lo_y = _mm_loadu_si128(GF256Ctx.MM128.TABLE_LO_Y + ys[i]);
+            const GF256_M128 table_hi_y = _mm_loadu_si128(GF256Ctx.MM128.TABLE_HI_Y + ys[i]);
+            const GF256_M128 * GF256_RESTRICT x = reinterpret_cast<const GF256_M128 *>(
+                static_cast<const uint8_t *>(xs[i]) + offset);
+
+            z0 = gf256_muladd_ssse3_vec(z0, _mm_loadu_si128(x), table_lo_y, table_hi_y, clr_mask);
+            z1_ = gf256_muladd_ssse3_vec(z1_, _mm_loadu_si128(x + 1), table_lo_y, table_hi_y, clr_mask);
+            z2 = gf256_muladd_ssse3_vec(z2, _mm_loadu_si128(x + 2), table_lo_y, table_hi_y, clr_mask);
+            z3 = gf256_muladd_ssse3_vec(z3, _mm_loadu_si128(x + 3), table_lo_y, table_hi_y, clr_mask);
+        }
+
+        _mm_storeu_si128(z, z0);
+        _mm_storeu_si128(z + 1, z1_);
+        _mm_storeu_si128(z + 2, z2);
+        _mm_storeu_si128(z + 3, z3);
+    }
+
+    // Handle multiples of 16 bytes
+    for (; offset + 16 <= bytes; offset += 16)
+    {
+        GF256_M128 * GF256_RESTRICT z = reinterpret_cast<GF256_M128 *>(z1 + offset);
+        GF256_M128 z0 = _mm_loadu_si128(z);
+        for (unsigned i = 0; i < count; ++i)
+        {
+            const GF256_M128 table_lo_y = _mm_loadu_si128(GF256Ctx.MM128.TABLE_LO_Y + ys[i]);
+            const GF256_M128 table_hi_y = _mm_loadu_si128(GF256Ctx.MM128.TABLE_HI_Y + ys[i]);
+            z0 = gf256_muladd_ssse3_vec(z0, _mm_loadu_si128(reinterpret_cast<const GF256_M128 *>(
+                static_cast<const uint8_t *>(xs[i]) + offset)), table_lo_y, table_hi_y, clr_mask);
+        }
+        _mm_storeu_si128(z, z0);
+    }
+}
+
+static void gf256_add_mem_sse2(void * GF256_RESTRICT vx,
+                               const void * GF256_RESTRICT vy, int bytes)
+{
+    uint8_t * x1 = reinterpret_cast<uint8_t *>(vx);
+    const uint8_t * y1 = reinterpret_cast<const uint8_t *>(vy);
+
+    gf256_add_mem_sse2_blocks(x1, y1, bytes);
+    gf256_add_mem_tail(x1, y1, bytes);
+}
+
+static void gf256_add2_mem_sse2(void * GF256_RESTRICT vz, const void * GF256_RESTRICT vx,
+                                const void * GF256_RESTRICT vy, int bytes)
+{
+    uint8_t * z1 = reinterpret_cast<uint8_t *>(vz);
+    const uint8_t * x1 = reinterpret_cast<const uint8_t *>(vx);
+    const uint8_t * y1 = reinterpret_cast<const uint8_t *>(vy);
+
+    gf256_add2_mem_sse2_blocks(z1, x1, y1, bytes);
+    gf256_add2_mem_tail(z1, x1, y1, bytes);
+}
+
+static void gf256_addset_mem_sse2(void * GF256_RESTRICT vz, const void * GF256_RESTRICT vx,
+                                  const void * GF256_RESTRICT vy, int bytes)
+{
+    uint8_t * z1 = reinterpret_cast<uint8_t *>(vz);
+    const uint8_t * x1 = reinterpret_cast<const uint8_t *>(vx);
+    const uint8_t * y1 = reinterpret_cast<const uint8_t *>(vy);
+
+    gf256_addset_mem_sse2_blocks(z1, x1, y1, bytes);
+    gf256_addset_mem_tail(z1, x1, y1, bytes);
+}
+
+static void gf256_addn_mem_sse2(void * GF256_RESTRICT vz, const void * const * GF256_RESTRICT srcs,
+                               unsigned count, int bytes)
+{
+    uint8_t * z1 = reinterpret_cast<uint8_t *>(vz);
+    int offset = 0;
+
+    gf256_addn_mem_sse2_blocks(z1, srcs, count, offset, bytes);
+    gf256_addn_mem_tail(z1, srcs, count, offset, bytes);
+}
+
+GF256_TARGET_SSSE3 static void gf256_addn_muladdn_mem_ssse3(void * GF256_RESTRICT vz,
+                                                            const void * const * GF256_RESTRICT xs, unsigned xCount, uint8_t y,
+                                                            const void * const * GF256_RESTRICT ws, unsigned wCount, int bytes)
+{
+    uint8_t * z1 = reinterpret_cast<uint8_t *>(vz);
+    int offset = 0;
+
+    gf256_addn_muladdn_mem_ssse3_blocks(z1, xs, xCount, y, ws, wCount, offset, bytes);
+    gf256_addn_muladdn_mem_tail(z1, xs, xCount, y, ws, wCount, offset, bytes);
+}
+
+GF256_TARGET_SSSE3 static void gf256_muladdn_mem_ssse3(void * GF256_RESTRICT vz, const uint8_t * GF256_RESTRICT ys,
+                                                       const void * const * GF256_RESTRICT xs, unsigned count, int bytes)
+{
+    uint8_t * z1 = reinterpret_cast<uint8_t *>(vz);
+    int offset = 0;
+
+    gf256_muladdn_mem_ssse3_blocks(z1, ys, xs, count, offset, bytes);
+    gf256_muladdn_mem_tail(z1, ys, xs, count, offset, bytes);
+}
+
+GF256_TARGET_SSSE3 static void gf256_mul_mem_ssse3(void * GF256_RESTRICT vz,
+                                                   const void * GF256_RESTRICT vx, uint8_t y, int bytes)
+{
+    uint8_t * z1 = reinterpret_cast<uint8_t *>(vz);
+    const uint8_t * x1 = reinterpret_cast<const uint8_t *>(vx);
+
+    gf256_mul_mem_ssse3_blocks(z1, x1, y, bytes);
+    gf256_mul_mem_tail(z1, x1, y, bytes);
+}
+
+GF256_TARGET_SSSE3 static void gf256_muladd_mem_ssse3(void * GF256_RESTRICT vz, uint8_t y,
+                                                      const void * GF256_RESTRICT vx, int bytes)
+{
+    uint8_t * z1 = reinterpret_cast<uint8_t *>(vz);
+    const uint8_t * x1 = reinterpret_cast<const uint8_t *>(vx);
+
+    gf256_muladd_mem_ssse3_blocks(z1, y, x1, bytes);
+    gf256_muladd_mem_tail(z1, y, x1, bytes);
+}
+
+
+//------------------------------------------------------------------------------
+// AVX2 Blocks and Kernels
+
+// x[] += y[] for multiples of 32 bytes
+GF256_TARGET_AVX2 static GF256_FORCE_INLINE void gf256_add_mem_avx2_blocks(
+    uint8_t *& vx, const uint8_t *& vy, int& bytes)
+{
+    GF256_M256 * GF256_RESTRICT x32 = reinterpret_cast<GF256_M256 *>(vx);
+    const GF256_M256 * GF256_RESTRICT y32 = reinterpret_cast<const GF256_M256 *>(vy);
+
+    while (bytes >= 128)
+    {
+        GF256_M256 x0 = _mm256_loadu_si256(x32);
+        GF256_M256 y0 = _mm256_loadu_si256(y32);
+        x0 = _mm256_xor_si256(x0, y0);
+        GF256_M256 x1 = _mm256_loadu_si256(x32 + 1);
+        GF256_M256 y1 = _mm256_loadu_si256(y32 + 1);
+        x1 = _mm256_xor_si256(x1, y1);
+        GF256_M256 x2 = _mm256_loadu_si256(x32 + 2);
+        GF256_M256 y2 = _mm256_loadu_si256(y32 + 2);
+        x2 = _mm256_xor_si256(x2, y2);
+        GF256_M256 x3 = _mm256_loadu_si256(x32 + 3);
+        GF256_M256 y3 = _mm256_loadu_si256(y32 + 3);
+        x3 = _mm256_xor_si256(x3, y3);
+
+        _mm256_storeu_si256(x32, x0);
+        _mm256_storeu_si256(x32 + 1, x1);
+        _mm256_storeu_si256(x32 + 2, x2);
+        _mm256_storeu_si256(x32 + 3, x3);
+
+        bytes -= 128, x32 += 4, y32 += 4;
+    }
+
+    // Handle multiples of 32 bytes
+    while (bytes >= 32)
+    {
+        // x[i] = x[i] xor y[i]
+        _mm256_storeu_si256(x32,
+            _mm256_xor_si256(
+                _mm256_loadu_si256(x32),
+                _mm256_loadu_si256(y32)));
+
+        bytes -= 32, ++x32, ++y32;
+    }
+
+    vx = reinterpret_cast<uint8_t *>(x32);
+    vy = reinterpret_cast<const uint8_t *>(y32);
+}
+
+// z[] += x[] + y[] for multiples of 32 bytes
+GF256_TARGET_AVX2 static GF256_FORCE_INLINE void gf256_add2_mem_avx2_blocks(
+    uint8_t *& vz, const uint8_t *& vx, const uint8_t *& vy, int& bytes)
+{
+    GF256_M256 * GF256_RESTRICT z32 = reinterpret_cast<GF256_M256 *>(vz);
+    const GF256_M256 * GF256_RESTRICT x32 = reinterpret_cast<const GF256_M256 *>(vx);
+    const GF256_M256 * GF256_RESTRICT y32 = reinterpret_cast<const GF256_M256 *>(vy);
+
+    const unsigned count = bytes / 32;
+    for (unsigned i = 0; i < count; ++i)
+    {
+        _mm256_storeu_si256(z32 + i,
+            _mm256_xor_si256(
+                _mm256_loadu_si256(z32 + i),
+                _mm256_xor_si256(
+                    _mm256_loadu_si256(x32 + i),
+                    _mm256_loadu_si256(y32 + i))));
+    }
+
+    bytes -= count * 32;
+    vz = reinterpret_cast<uint8_t *>(z32 + count);
+    vx = reinterpret_cast<const uint8_t *>(x32 + count);
+    vy = reinterpret_cast<const uint8_t *>(y32 + count);
+}
+
+// z[] = x[] + y[] for multiples of 32 bytes
+GF256_TARGET_AVX2 static GF256_FORCE_INLINE void gf256_addset_mem_avx2_blocks(
+    uint8_t *& vz, const uint8_t *& vx, const uint8_t *& vy, int& bytes)
+{
+    GF256_M256 * GF256_RESTRICT z32 = reinterpret_cast<GF256_M256 *>(vz);
+    const GF256_M256 * GF256_RESTRICT x32 = reinterpret_cast<const GF256_M256 *>(vx);
+    const GF256_M256 * GF256_RESTRICT y32 = reinterpret_cast<const GF256_M256 *>(vy);
+
+    const unsigned count = bytes / 32;
+    for (unsigned i = 0; i < count; ++i)
+    {
+        _mm256_storeu_si256(z32 + i,
+            _mm256_xor_si256(
+                _mm256_loadu_si256(x32 + i),
+                _mm256_loadu_si256(y32 + i)));
+    }
+
+    bytes -= count * 32;
+    vz = reinterpret_cast<uint8_t *>(z32 + count);
+    vx = reinterpret_cast<const uint8_t *>(x32 + count);
+    vy = reinterpret_cast<const uint8_t *>(y32 + count);
+}
+
+// z[] += srcs[0][] + ... + srcs[count-1][] for multiples of 32 bytes
+GF256_TARGET_AVX2 static GF256_FORCE_INLINE void gf256_addn_mem_avx2_blocks(
+    uint8_t * GF256_RESTRICT z1, const void * const * GF256_RESTRICT srcs,
+    unsigned count, int& offset, int bytes)
+{
+    // Handle multiples of 64 bytes
+    for (; offset + 64 <= bytes; offset += 64)
+    {
+        GF256_M256 * GF256_RESTRICT z32 = reinterpret_cast<GF256_M256 *>(z1 + offset);
+        GF256_M256 z0 = _mm256_loadu_si256(z32);
+        GF256_M256 z1v = _mm256_loadu_si256(z32 + 1);
+
+        for (unsigned i = 0; i < count; ++i)
+        {
+            const GF256_M256 * GF256_RESTRICT x32 = reinterpret_cast<const GF256_M256 *>(
+                static_cast<const uint8_t *>(srcs[i]) + offset);
+            z0 = _mm256_xor_si256(z0, _mm256_loadu_si256(x32));
+            z1v = _mm256_xor_si256(z1v, _mm256_loadu_si256(x32 + 1));
+        }
+
+        _mm256_storeu_si256(z32, z0);
+        _mm256_storeu_si256(z32 + 1, z1v);
+    }
+
+    // Handle multiples of 32 bytes
+    if (offset + 32 <= bytes)
+    {
+        GF256_M256 * GF256_RESTRICT z32 = reinterpret_cast<GF256_M256 *>(z1 + offset);
+        GF256_M256 z0 = _mm256_loadu_si256(z32);
+
+        for (unsigned i = 0; i < count; ++i)
+        {
+            const GF256_M256 * GF256_RESTRICT x32 = reinterpret_cast<const GF256_M256 *>(
+                static_cast<const uint8_t *>(srcs[i]) + offset);
+            z0 = _mm256_xor_si256(z0, _mm256_loadu_si256(x32));
+        }
+
+        _mm256_storeu_si256(z32, z0);
+        offset += 32;
+    }
+}
+
+// z[] = x[] * y for multiples of 32 bytes
+GF256_TARGET_AVX2 static GF256_FORCE_INLINE void gf256_mul_mem_avx2_blocks(
+    uint8_t *& vz, const uint8_t *& vx, uint8_t y, int& bytes)
+{
+    if (bytes < 32)
+        return;
+
+    // Partial product tables; see above
+    const GF256_M256 table_lo_y = _mm256_loadu_si256(GF256Ctx.MM256.TABLE_LO_Y + y);
+    const GF256_M256 table_hi_y = _mm256_loadu_si256(GF256Ctx.MM256.TABLE_HI_Y + y);
+
+    // clr_mask = 0x0f0f0f0f0f0f0f0f0f0f0f0f0f0f0f0f
+    const GF256_M256 clr_mask = _mm256_set1_epi8(0x0f);
+
+    GF256_M256 * GF256_RESTRICT z32 = reinterpret_cast<GF256_M256 *>(vz);
+    const GF256_M256 * GF256_RESTRICT x32 = reinterpret_cast<const GF256_M256 *>(vx);
+
+    // Handle multiples of 32 bytes
+    do
+    {
+        // See above comments for details
+        GF256_M256 x0 = _mm256_loadu_si256(x32);
+        GF256_M256 l0 = _mm256_and_si256(x0, clr_mask);
+        x0 = _mm256_srli_epi64(x0, 4);
+        GF256_M256 h0 = _mm256_and_si256(x0, clr_mask);
+        l0 = _mm256_shuffle_epi8(table_lo_y, l0);
+        h0 = _mm256_shuffle_epi8(table_hi_y, h0);
+        _mm256_storeu_si256(z32, _mm256_xor_si256(l0, h0));
+
+        bytes -= 32, ++x32, ++z32;
+    } while (bytes >= 32);
+
+    vz = reinterpret_cast<uint8_t *>(z32);
+    vx = reinterpret_cast<const uint8_t *>(x32);
+}
+
+// z[] += x[] * y for multiples of 32 bytes
+GF256_TARGET_AVX2 static GF256_FORCE_INLINE void gf256_muladd_mem_avx2_blocks(
+    uint8_t *& vz, uint8_t y, const uint8_t *& vx, int& bytes)
+{
+    if (bytes < 32)
+        return;
+
+    // Partial product tables; see above
+    const GF256_M256 table_lo_y = _mm256_loadu_si256(GF256Ctx.MM256.TABLE_LO_Y + y);
+    const GF256_M256 table_hi_y = _mm256_loadu_si256(GF256Ctx.MM256.TABLE_HI_Y + y);
+
+    // clr_mask = 0x0f0f0f0f0f0f0f0f0f0f0f0f0f0f0f0f
+    const GF256_M256 clr_mask = _mm256_set1_epi8(0x0f);
+
+    GF256_M256 * GF256_RESTRICT z32 = reinterpret_cast<GF256_M256 *>(vz);
+    const GF256_M256 * GF256_RESTRICT x32 = reinterpret_cast<const GF256_M256 *>(vx);
+
+    // On my Reed Solomon codec, the encoder unit test runs in 640 usec without and 550 usec with the optimization (86% of the original time)
+    const unsigned count = bytes / 64;
+    for (unsigned i = 0; i < count; ++i)
+    {
+        // See above comments for details
+        GF256_M256 x0 = _mm256_loadu_si256(x32 + i * 2);
+        GF256_M256 l0 = _mm256_and_si256(x0, clr_mask);
+        x0 = _mm256_srli_epi64(x0, 4);
+        const GF256_M256 z0 = _mm256_loadu_si256(z32 + i * 2);
+        GF256_M256 h0 = _mm256_and_si256(x0, clr_mask);
+        l0 = _mm256_shuffle_epi8(table_lo_y, l0);
+        h0 = _mm256_shuffle_epi8(table_hi_y, h0);
+        const GF256_M256 p0 = _mm256_xor_si256(l0, h0);
+        _mm256_storeu_si256(z32 + i * 2, _mm256_xor_si256(p0, z0));
+
+        GF256_M256 x1 = _mm256_loadu_si256(x32 + i * 2 + 1);
+        GF256_M256 l1 = _mm256_and_si256(x1, clr_mask);
+        x1 = _mm256_srli_epi64(x1, 4);
+        const GF256_M256 z1 = _mm256_loadu_si256(z32 + i * 2 + 1);
+        GF256_M256 h1 = _mm256_and_si256(x1, clr_mask);
+        l1 = _mm256_shuffle_epi8(table_lo_y, l1);
+        h1 = _mm256_shuffle_epi8(table_hi_y, h1);
+        const GF256_M256 p1 = _mm256_xor_si256(l1, h1);
+        _mm256_storeu_si256(z32 + i * 2 + 1, _mm256_xor_si256(p1, z1));
+    }
+    bytes -= count * 64;
+    z32 += count * 2;
+    x32 += count * 2;
+
+    if (bytes >= 32)
+    {
+        GF256_M256 x0 = _mm256_loadu_si256(x32);
+        GF256_M256 l0 = _mm256_and_si256(x0, clr_mask);
+        x0 = _mm256_srli_epi64(x0, 4);
+        GF256_M256 h0 = _mm256_and_si256(x0, clr_mask);
+        l0 = _mm256_shuffle_epi8(table_lo_y, l0);
+        h0 = _mm256_shuffle_epi8(table_hi_y, h0);
+        const GF256_M256 p0 = _mm256_xor_si256(l0, h0);
+        const GF256_M256 z0 = _mm256_loadu_si256(z32);
+        _mm256_storeu_si256(z32, _mm256_xor_si256(p0, z0));
+
+        bytes -= 32;
+        z32++;
+        x32++;
+    }
+
+    vz = reinterpret_cast<uint8_t *>(z32);
+    vx = reinterpret_cast<const uint8_t *>(x32);
+}
+
+// z[] += sum of xs[] + y * sum of ws[] for multiples of 32 bytes
+GF256_TARGET_AVX2 static GF256_FORCE_INLINE void gf256_addn_muladdn_mem_avx2_blocks(
+    uint8_t * GF256_RESTRICT z1,
+    const void * const * GF256_RESTRICT xs, unsigned xCount, uint8_t y,
+    const void * const * GF256_RESTRICT ws, unsigned wCount, int& offset, int bytes)
+{
+    if (offset + 32 > bytes)
+        return;
+
+    // Partial product tables; see above
+    const GF256_M256 table_lo_y = _mm256_loadu_si256(GF256Ctx.MM256.TABLE_LO_Y + y);
+    const GF256_M256 table_hi_y = _mm256_loadu_si256(GF256Ctx.MM256.TABLE_HI_Y + y);
+
+    // clr_mask = 0x0f0f0f0f0f0f0f0f0f0f0f0f0f0f0f0f
+    const GF256_M256 clr_mask = _mm256_set1_epi8(0x0f);
+
+    // Handle multiples of 32 bytes
+    for (; offset + 32 <= bytes; offset += 32)
+    {
+        // Product stays in a register until it is multiplied by y
+        GF256_M256 p0 = _mm256_setzero_si256();
+        for (unsigned i = 0; i < wCount; ++i)
+            p0 = _mm256_xor_si256(p0, _mm256_loadu_si256(reinterpret_cast<const GF256_M256 *>(
+                static_cast<const uint8_t *>(ws[i]) + offset)));
+
+        GF256_M256 * GF256_RESTRICT z = reinterpret_cast<GF256_M256 *>(z1 + offset);
+        GF256_M256 z0 = _mm256_loadu_si256(z);
+        for (unsigned i = 0; i < xCount; ++i)
+            z0 = _mm256_xor_si256(z0, _mm256_loadu_si256(reinterpret_cast<const GF256_M256 *>(
+                static_cast<const uint8_t *>(xs[i]) + offset)));
+
+        // See above comments for details
+        GF256_M256 l0 = _mm256_and_si256(p0, clr_mask);
+        p0 = _mm256_srli_epi64(p0, 4);
+        GF256_M256 h0 = _mm256_and_si256(p0, clr_mask);
+        l0 = _mm256_shuffle_epi8(table_lo_y, l0);
+        h0 = _mm256_shuffle_epi8(table_hi_y, h0);
+        _mm256_storeu_si256(z, _mm256_xor_si256(z0, _mm256_xor_si256(l0, h0)));
+    }
+}
+
+GF256_TARGET_AVX2 static GF256_FORCE_INLINE GF256_M256 gf256_muladd_avx2_vec(
+    GF256_M256 z0, GF256_M256 x0, GF256_M256 table_lo_y, GF256_M256 table_hi_y, GF256_M256 clr_mask)
+{
+    // See above comments for details
+    GF256_M256 l0 = _mm256_and_si256(x0, clr_mask);
+    x0 = _mm256_srli_epi64(x0, 4);
+    GF256_M256 h0 = _mm256_and_si256(x0, clr_mask);
+    l0 = _mm256_shuffle_epi8(table_lo_y, l0);
+    h0 = _mm256_shuffle_epi8(table_hi_y, h0);
+    return _mm256_xor_si256(z0, _mm256_xor_si256(l0, h0));
+}
+
+// z[] += sum of ys[] * xs[] for multiples of 32 bytes
+GF256_TARGET_AVX2 static GF256_FORCE_INLINE void gf256_muladdn_mem_avx2_blocks(
+    uint8_t * GF256_RESTRICT z1, const uint8_t * GF256_RESTRICT ys,
+    const void * const * GF256_RESTRICT xs, unsigned count, int& offset, int bytes)
+{
+    // clr_mask = 0x0f0f0f0f0f0f0f0f0f0f0f0f0f0f0f0f
+    const GF256_M256 clr_mask = _mm256_set1_epi8(0x0f);
+
+    // Handle multiples of 128 bytes, keeping a tile of the destination in
+    // registers so the partial product tables are loaded once per tile
+    for (; offset + 128 <= bytes; offset += 128)
+    {
+        GF256_M256 * GF256_RESTRICT z = reinterpret_cast<GF256_M256 *>(z1 + offset);
+        GF256_M256 z0 = _mm256_loadu_si256(z);
+        GF256_M256 z1_ = _mm256_loadu_si256(z + 1);
+        GF256_M256 z2 = _mm256_loadu_si256(z + 2);
+        GF256_M256 z3 = _mm256_loadu_si256(z + 3);
+
+        for (unsigned i = 0; i < count; ++i)
+        {
+            const GF256_M256 table_lo_y = _mm256_loadu_si256(GF256Ctx.MM256.TABLE_LO_Y + ys[i]);
+            const GF256_M256 table_hi_y = _mm256_loadu_si256(GF256Ctx.MM256.TABLE_HI_Y + ys[i]);
+            const GF256_M256 * GF256_RESTRICT x = reinterpret_cast<const GF256_M256 *>(
+                static_cast<const uint8_t *>(xs[i]) + offset);
+
+            z0 = gf256_muladd_avx2_vec(z0, _mm256_loadu_si256(x), table_lo_y, table_hi_y, clr_mask);
+            z1_ = gf256_muladd_avx2_vec(z1_, _mm256_loadu_si256(x + 1), table_lo_y, table_hi_y, clr_mask);
+            z2 = gf256_muladd_avx2_vec(z2, _mm256_loadu_si256(x + 2), table_lo_y, table_hi_y, clr_mask);
+            z3 = gf256_muladd_avx2_vec(z3, _mm256_loadu_si256(x + 3), table_lo_y, table_hi_y, clr_mask);
+        }
+
+        _mm256_storeu_si256(z, z0);
+        _mm256_storeu_si256(z + 1, z1_);
+        _mm256_storeu_si256(z + 2, z2);
+        _mm256_storeu_si256(z + 3, z3);
+    }
+
+    // Handle multiples of 32 bytes
+    for (; offset + 32 <= bytes; offset += 32)
+    {
+        GF256_M256 * GF256_RESTRICT z = reinterpret_cast<GF256_M256 *>(z1 + offset);
+        GF256_M256 z0 = _mm256_loadu_si256(z);
+        for (unsigned i = 0; i < count; ++i)
+        {
+            const GF256_M256 table_lo_y = _mm256_loadu_si256(GF256Ctx.MM256.TABLE_LO_Y + ys[i]);
+            const GF256_M256 table_hi_y = _mm256_loadu_si256(GF256Ctx.MM256.TABLE_HI_Y + ys[i]);
+            z0 = gf256_muladd_avx2_vec(z0, _mm256_loadu_si256(reinterpret_cast<const GF256_M256 *>(
+                static_cast<const uint8_t *>(xs[i]) + offset)), table_lo_y, table_hi_y, clr_mask);
+        }
+        _mm256_storeu_si256(z, z0);
+    }
+}
+
+GF256_TARGET_AVX2 static void gf256_add_mem_avx2(void * GF256_RESTRICT vx,
+                                                 const void * GF256_RESTRICT vy, int bytes)
+{
+    uint8_t * x1 = reinterpret_cast<uint8_t *>(vx);
+    const uint8_t * y1 = reinterpret_cast<const uint8_t *>(vy);
+
+    gf256_add_mem_avx2_blocks(x1, y1, bytes);
+    gf256_add_mem_sse2_blocks(x1, y1, bytes);
+    gf256_add_mem_tail(x1, y1, bytes);
+}
+
+GF256_TARGET_AVX2 static void gf256_add2_mem_avx2(void * GF256_RESTRICT vz, const void * GF256_RESTRICT vx,
+                                                  const void * GF256_RESTRICT vy, int bytes)
+{
+    uint8_t * z1 = reinterpret_cast<uint8_t *>(vz);
+    const uint8_t * x1 = reinterpret_cast<const uint8_t *>(vx);
+    const uint8_t * y1 = reinterpret_cast<const uint8_t *>(vy);
+
+    gf256_add2_mem_avx2_blocks(z1, x1, y1, bytes);
+    gf256_add2_mem_sse2_blocks(z1, x1, y1, bytes);
+    gf256_add2_mem_tail(z1, x1, y1, bytes);
+}
+
+GF256_TARGET_AVX2 static void gf256_addset_mem_avx2(void * GF256_RESTRICT vz, const void * GF256_RESTRICT vx,
+                                                    const void * GF256_RESTRICT vy, int bytes)
+{
+    uint8_t * z1 = reinterpret_cast<uint8_t *>(vz);
+    const uint8_t * x1 = reinterpret_cast<const uint8_t *>(vx);
+    const uint8_t * y1 = reinterpret_cast<const uint8_t *>(vy);
+
+    gf256_addset_mem_avx2_blocks(z1, x1, y1, bytes);
+    gf256_addset_mem_sse2_blocks(z1, x1, y1, bytes);
+    gf256_addset_mem_tail(z1, x1, y1, bytes);
+}
+
+GF256_TARGET_AVX2 static void gf256_addn_mem_avx2(void * GF256_RESTRICT vz, const void * const * GF256_RESTRICT srcs,
+                                                 unsigned count, int bytes)
+{
+    uint8_t * z1 = reinterpret_cast<uint8_t *>(vz);
+    int offset = 0;
+
+    gf256_addn_mem_avx2_blocks(z1, srcs, count, offset, bytes);
+    gf256_addn_mem_sse2_blocks(z1, srcs, count, offset, bytes);
+    gf256_addn_mem_tail(z1, srcs, count, offset, bytes);
+}
+
+GF256_TARGET_AVX2 static void gf256_addn_muladdn_mem_avx2(void * GF256_RESTRICT vz,
+                                                          const void * const * GF256_RESTRICT xs, unsigned xCount, uint8_t y,
+                                                          const void * const * GF256_RESTRICT ws, unsigned wCount, int bytes)
+{
+    uint8_t * z1 = reinterpret_cast<uint8_t *>(vz);
+    int offset = 0;
+
+    gf256_addn_muladdn_mem_avx2_blocks(z1, xs, xCount, y, ws, wCount, offset, bytes);
+    gf256_addn_muladdn_mem_ssse3_blocks(z1, xs, xCount, y, ws, wCount, offset, bytes);
+    gf256_addn_muladdn_mem_tail(z1, xs, xCount, y, ws, wCount, offset, bytes);
+}
+
+GF256_TARGET_AVX2 static void gf256_muladdn_mem_avx2(void * GF256_RESTRICT vz, const uint8_t * GF256_RESTRICT ys,
+                                                     const void * const * GF256_RESTRICT xs, unsigned count, int bytes)
+{
+    uint8_t * z1 = reinterpret_cast<uint8_t *>(vz);
+    int offset = 0;
+
+    gf256_muladdn_mem_avx2_blocks(z1, ys, xs, count, offset, bytes);
+    gf256_muladdn_mem_ssse3_blocks(z1, ys, xs, count, offset, bytes);
+    gf256_muladdn_mem_tail(z1, ys, xs, count, offset, bytes);
+}
+
+GF256_TARGET_AVX2 static void gf256_mul_mem_avx2(void * GF256_RESTRICT vz,
+                                                 const void * GF256_RESTRICT vx, uint8_t y, int bytes)
+{
+    uint8_t * z1 = reinterpret_cast<uint8_t *>(vz);
+    const uint8_t * x1 = reinterpret_cast<const uint8_t *>(vx);
+
+    gf256_mul_mem_avx2_blocks(z1, x1, y, bytes);
+    gf256_mul_mem_ssse3_blocks(z1, x1, y, bytes);
+    gf256_mul_mem_tail(z1, x1, y, bytes);
+}
+
+GF256_TARGET_AVX2 static void gf256_muladd_mem_avx2(void * GF256_RESTRICT vz, uint8_t y,
+                                                    const void * GF256_RESTRICT vx, int bytes)
+{
+    uint8_t * z1 = reinterpret_cast<uint8_t *>(vz);
+    const uint8_t * x1 = reinterpret_cast<const uint8_t *>(vx);
+
+    gf256_muladd_mem_avx2_blocks(z1, y, x1, bytes);
+    gf256_muladd_mem_ssse3_blocks(z1, y, x1, bytes);
+    gf256_muladd_mem_tail(z1, y, x1, bytes);
+}
+
+
+#if defined(GF256_TRY_AVX512)
+
+//------------------------------------------------------------------------------
+// AVX-512 Blocks and Kernels
+
+// GCC bug 105593: _mm512_undefined_epi32() in the intrinsics is reported as
+// maybe-uninitialized when they are inlined
+#if defined(__GNUC__) && !defined(__clang__)
+    #pragma GCC diagnostic push
+    #pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#endif
+
+// x[] += y[] for multiples of 64 bytes
+GF256_TARGET_AVX512 static GF256_FORCE_INLINE void gf256_add_mem_avx512_blocks(
+    uint8_t *& vx, const uint8_t *& vy, int& bytes)
+{
+    GF256_M512 * GF256_RESTRICT x64 = reinterpret_cast<GF256_M512 *>(vx);
+    const GF256_M512 * GF256_RESTRICT y64 = reinterpret_cast<const GF256_M512 *>(vy);
+
+    while (bytes >= 256)
+    {
+        GF256_M512 x0 = _mm512_loadu_si512(x64);
+        GF256_M512 y0 = _mm512_loadu_si512(y64);
+        x0 = _mm512_xor_si512(x0, y0);
+        GF256_M512 x1 = _mm512_loadu_si512(x64 + 1);
+        GF256_M512 y1 = _mm512_loadu_si512(y64 + 1);
+        x1 = _mm512_xor_si512(x1, y1);
+        GF256_M512 x2 = _mm512_loadu_si512(x64 + 2);
+        GF256_M512 y2 = _mm512_loadu_si512(y64 + 2);
+        x2 = _mm512_xor_si512(x2, y2);
+        GF256_M512 x3 = _mm512_loadu_si512(x64 + 3);
+        GF256_M512 y3 = _mm512_loadu_si512(y64 + 3);
+        x3 = _mm512_xor_si512(x3, y3);
+
+        _mm512_storeu_si512(x64, x0);
+        _mm512_storeu_si512(x64 + 1, x1);
+        _mm512_storeu_si512(x64 + 2, x2);
+        _mm512_storeu_si512(x64 + 3, x3);
+
+        bytes -= 256, x64 += 4, y64 += 4;
+    }
+
+    // Handle multiples of 64 bytes
+    while (bytes >= 64)
+    {
+        // x[i] = x[i] xor y[i]
+        _mm512_storeu_si512(x64,
+            _mm512_xor_si512(
+                _mm512_loadu_si512(x64),
+                _mm512_loadu_si512(y64)));
+
+        bytes -= 64, ++x64, ++y64;
+    }
+
+    vx = reinterpret_cast<uint8_t *>(x64);
+    vy = reinterpret_cast<const uint8_t *>(y64);
+}
+
+// z[] += x[] + y[] for multiples of 64 bytes
+GF256_TARGET_AVX512 static GF256_FORCE_INLINE void gf256_add2_mem_avx512_blocks(
+    uint8_t *& vz, const uint8_t *& vx, const uint8_t *& vy, int& bytes)
+{
+    GF256_M512 * GF256_RESTRICT z64 = reinterpret_cast<GF256_M512 *>(vz);
+    const GF256_M512 * GF256_RESTRICT x64 = reinterpret_cast<const GF256_M512 *>(vx);
+    const GF256_M512 * GF256_RESTRICT y64 = reinterpret_cast<const GF256_M512 *>(vy);
+
+    const unsigned count = bytes / 64;
+    for (unsigned i = 0; i < count; ++i)
+    {
+        // z[i] = z[i] xor x[i] xor y[i] in one instruction
+        _mm512_storeu_si512(z64 + i,
+            _mm512_ternarylogic_epi64(
+                _mm512_loadu_si512(z64 + i),
+                _mm512_loadu_si512(x64 + i),
+                _mm512_loadu_si512(y64 + i),
+                0x96));
+    }
+
+    bytes -= count * 64;
+    vz = reinterpret_cast<uint8_t *>(z64 + count);
+    vx = reinterpret_cast<const uint8_t *>(x64 + count);
+    vy = reinterpret_cast<const uint8_t *>(y64 + count);
+}
+
+// z[] += srcs[0][] + ... + srcs[count-1][] for multiples of 64 bytes
+GF256_TARGET_AVX512 static GF256_FORCE_INLINE void gf256_addn_mem_avx512_blocks(
+    uint8_t * GF256_RESTRICT z1, const void * const * GF256_RESTRICT srcs,
+    unsigned count, int& offset, int bytes)
+{
+    // Handle multiples of 128 bytes
+    for (; offset + 128 <= bytes; offset += 128)
+    {
+        GF256_M512 * GF256_RESTRICT z64 = reinterpret_cast<GF256_M512 *>(z1 + offset);
+        GF256_M512 z0 = _mm512_loadu_si512(z64);
+        GF256_M512 z1v = _mm512_loadu_si512(z64 + 1);
+
+        // Add two sources at a time in one instruction
+        unsigned i = 0;
+        for (; i + 2 <= count; i += 2)
+        {
+            const GF256_M512 * GF256_RESTRICT x64 = reinterpret_cast<const GF256_M512 *>(
+                static_cast<const uint8_t *>(srcs[i]) + offset);
+            const GF256_M512 * GF256_RESTRICT y64 = reinterpret_cast<const GF256_M512 *>(
+                static_cast<const uint8_t *>(srcs[i + 1]) + offset);
+            z0 = _mm512_ternarylogic_epi64(z0, _mm512_loadu_si512(x64), _mm512_loadu_si512(y64), 0x96);
+            z1v = _mm512_ternarylogic_epi64(z1v, _mm512_loadu_si512(x64 + 1), _mm512_loadu_si512(y64 + 1), 0x96);
+        }
+        if (i < count)
+        {
+            const GF256_M512 * GF256_RESTRICT x64 = reinterpret_cast<const GF256_M512 *>(
+                static_cast<const uint8_t *>(srcs[i]) + offset);
+            z0 = _mm512_xor_si512(z0, _mm512_loadu_si512(x64));
+            z1v = _mm512_xor_si512(z1v, _mm512_loadu_si512(x64 + 1));
+        }
+
+        _mm512_storeu_si512(z64, z0);
+        _mm512_storeu_si512(z64 + 1, z1v);
+    }
+
+    // Handle multiples of 64 bytes
+    if (offset + 64 <= bytes)
+    {
+        GF256_M512 * GF256_RESTRICT z64 = reinterpret_cast<GF256_M512 *>(z1 + offset);
+        GF256_M512 z0 = _mm512_loadu_si512(z64);
+
+        for (unsigned i = 0; i < count; ++i)
+        {
+            const GF256_M512 * GF256_RESTRICT x64 = reinterpret_cast<const GF256_M512 *>(
+                static_cast<const uint8_t *>(srcs[i]) + offset);
+            z0 = _mm512_xor_si512(z0, _mm512_loadu_si512(x64));
+        }
+
+        _mm512_storeu_si512(z64, z0);
+        offset += 64;
+    }
+}
+
+// z[] = x[] * y for multiples of 64 bytes
+GF256_TARGET_AVX512 static GF256_FORCE_INLINE void gf256_mul_mem_avx512_blocks(
+    uint8_t *& vz, const uint8_t *& vx, uint8_t y, int& bytes)
+{
+    if (bytes < 64)
+        return;
+
+    GF256_M512 * GF256_RESTRICT z64 = reinterpret_cast<GF256_M512 *>(vz);
+    const GF256_M512 * GF256_RESTRICT x64 = reinterpret_cast<const GF256_M512 *>(vx);
+
+    // Partial product tables; see above
+    const GF256_M512 table_lo_y = _mm512_broadcast_i32x4(_mm_loadu_si128(GF256Ctx.MM128.TABLE_LO_Y + y));
+    const GF256_M512 table_hi_y = _mm512_broadcast_i32x4(_mm_loadu_si128(GF256Ctx.MM128.TABLE_HI_Y + y));
+
+    // clr_mask = 0x0f0f0f0f0f0f0f0f0f0f0f0f0f0f0f0f
+    const GF256_M512 clr_mask = _mm512_set1_epi8(0x0f);
+
+    // Handle multiples of 64 bytes
+    do
+    {
+        // See above comments for details
+        GF256_M512 x0 = _mm512_loadu_si512(x64);
+        GF256_M512 l0 = _mm512_and_si512(x0, clr_mask);
+        x0 = _mm512_srli_epi64(x0, 4);
+        GF256_M512 h0 = _mm512_and_si512(x0, clr_mask);
+        l0 = _mm512_shuffle_epi8(table_lo_y, l0);
+        h0 = _mm512_shuffle_epi8(table_hi_y, h0);
+        _mm512_storeu_si512(z64, _mm512_xor_si512(l0, h0));
+
+        bytes -= 64, ++x64, ++z64;
+    } while (bytes >= 64);
+
+    vz = reinterpret_cast<uint8_t *>(z64);
+    vx = reinterpret_cast<const uint8_t *>(x64);
+}
+
+// z[] += x[] * y for multiples of 64 bytes
+GF256_TARGET_AVX512 static GF256_FORCE_INLINE void gf256_muladd_mem_avx512_blocks(
+    uint8_t *& vz, uint8_t y, const uint8_t *& vx, int& bytes)
+{
+    if (bytes < 64)
+        return;
+
+    GF256_M512 * GF256_RESTRICT z64 = reinterpret_cast<GF256_M512 *>(vz);
+    const GF256_M512 * GF256_RESTRICT x64 = reinterpret_cast<const GF256_M512 *>(vx);
+
+    // Partial product tables; see above
+    const GF256_M512 table_lo_y = _mm512_broadcast_i32x4(_mm_loadu_si128(GF256Ctx.MM128.TABLE_LO_Y + y));
+    const GF256_M512 table_hi_y = _mm512_broadcast_i32x4(_mm_loadu_si128(GF256Ctx.MM128.TABLE_HI_Y + y));
+
+    // clr_mask = 0x0f0f0f0f0f0f0f0f0f0f0f0f0f0f0f0f
+    const GF256_M512 clr_mask = _mm512_set1_epi8(0x0f);
+
+    // Handle multiples of 64 bytes
+    do
+    {
+        // See above comments for details
+        GF256_M512 x0 = _mm512_loadu_si512(x64);
+        GF256_M512 l0 = _mm512_and_si512(x0, clr_mask);
+        x0 = _mm512_srli_epi64(x0, 4);
+        const GF256_M512 z0 = _mm512_loadu_si512(z64);
+        GF256_M512 h0 = _mm512_and_si512(x0, clr_mask);
+        l0 = _mm512_shuffle_epi8(table_lo_y, l0);
+        h0 = _mm512_shuffle_epi8(table_hi_y, h0);
+
+        // z[i] = z[i] xor lo xor hi in one instruction
+        _mm512_storeu_si512(z64, _mm512_ternarylogic_epi64(z0, l0, h0, 0x96));
+
+        bytes -= 64, ++x64, ++z64;
+    } while (bytes >= 64);
+
+    vz = reinterpret_cast<uint8_t *>(z64);
+    vx = reinterpret_cast<const uint8_t *>(x64);
+}
+
+// z[] += sum of xs[] + y * sum of ws[] for multiples of 64 bytes
+GF256_TARGET_AVX512 static GF256_FORCE_INLINE void gf256_addn_muladdn_mem_avx512_blocks(
+    uint8_t * GF256_RESTRICT z1,
+    const void * const * GF256_RESTRICT xs, unsigned xCount, uint8_t y,
+    const void * const * GF256_RESTRICT ws, unsigned wCount, int& offset, int bytes)
+{
+    if (offset + 64 > bytes)
+        return;
+
+    // Partial product tables; see above
+    const GF256_M512 table_lo_y = _mm512_broadcast_i32x4(_mm_loadu_si128(GF256Ctx.MM128.TABLE_LO_Y + y));
+    const GF256_M512 table_hi_y = _mm512_broadcast_i32x4(_mm_loadu_si128(GF256Ctx.MM128.TABLE_HI_Y + y));
+
+    // clr_mask = 0x0f0f0f0f0f0f0f0f0f0f0f0f0f0f0f0f
+    const GF256_M512 clr_mask = _mm512_set1_epi8(0x0f);
+
+    // Handle multiples of 64 bytes
+    for (; offset + 64 <= bytes; offset += 64)
+    {
+        // Product stays in a register until it is multiplied by y
+        GF256_M512 p0 = _mm512_setzero_si512();
+        for (unsigned i = 0; i < wCount; ++i)
+            p0 = _mm512_xor_si512(p0, _mm512_loadu_si512(reinterpret_cast<const GF256_M512 *>(
+                static_cast<const uint8_t *>(ws[i]) + offset)));
+
+        GF256_M512 * GF256_RESTRICT z = reinterpret_cast<GF256_M512 *>(z1 + offset);
+        GF256_M512 z0 = _mm512_loadu_si512(z);
+        for (unsigned i = 0; i < xCount; ++i)
+            z0 = _mm512_xor_si512(z0, _mm512_loadu_si512(reinterpret_cast<const GF256_M512 *>(
+                static_cast<const uint8_t *>(xs[i]) + offset)));
+
+        // See above comments for details
+        GF256_M512 l0 = _mm512_and_si512(p0, clr_mask);
+        p0 = _mm512_srli_epi64(p0, 4);
+        GF256_M512 h0 = _mm512_and_si512(p0, clr_mask);
+        l0 = _mm512_shuffle_epi8(table_lo_y, l0);
+        h0 = _mm512_shuffle_epi8(table_hi_y, h0);
+        _mm512_storeu_si512(z, _mm512_ternarylogic_epi64(z0, l0, h0, 0x96));
+    }
+}
+
+GF256_TARGET_AVX512 static GF256_FORCE_INLINE GF256_M512 gf256_muladd_avx512_vec(
+    GF256_M512 z0, GF256_M512 x0, GF256_M512 table_lo_y, GF256_M512 table_hi_y, GF256_M512 clr_mask)
+{
+    // See above comments for details
+    GF256_M512 l0 = _mm512_and_si512(x0, clr_mask);
+    x0 = _mm512_srli_epi64(x0, 4);
+    GF256_M512 h0 = _mm512_and_si512(x0, clr_mask);
+    l0 = _mm512_shuffle_epi8(table_lo_y, l0);
+    h0 = _mm512_shuffle_epi8(table_hi_y, h0);
+    return _mm512_ternarylogic_epi64(z0, l0, h0, 0x96);
+}
+
+// z[] += sum of ys[] * xs[] for multiples of 64 bytes
+GF256_TARGET_AVX512 static GF256_FORCE_INLINE void gf256_muladdn_mem_avx512_blocks(
+    uint8_t * GF256_RESTRICT z1, const uint8_t * GF256_RESTRICT ys,
+    const void * const * GF256_RESTRICT xs, unsigned count, int& offset, int bytes)
+{
+    // clr_mask = 0x0f0f0f0f0f0f0f0f0f0f0f0f0f0f0f0f
+    const GF256_M512 clr_mask = _mm512_set1_epi8(0x0f);
+
+    // Handle multiples of 256 bytes, keeping a tile of the destination in
+    // registers so the partial product tables are loaded once per tile
+    for (; offset + 256 <= bytes; offset += 256)
+    {
+        GF256_M512 * GF256_RESTRICT z = reinterpret_cast<GF256_M512 *>(z1 + offset);
+        GF256_M512 z0 = _mm512_loadu_si512(z);
+        GF256_M512 z1_ = _mm512_loadu_si512(z + 1);
+        GF256_M512 z2 = _mm512_loadu_si512(z + 2);
+        GF256_M512 z3 = _mm512_loadu_si512(z + 3);
+
+        for (unsigned i = 0; i < count; ++i)
+        {
+            const GF256_M512 table_lo_y = _mm512_broadcast_i32x4(_mm_loadu_si128(GF256Ctx.MM128.TABLE_LO_Y + ys[i]));
+            const GF256_M512 table_hi_y = _mm512_broadcast_i32x4(_mm_loadu_si128(GF256Ctx.MM128.TABLE_HI_Y + ys[i]));
+            const GF256_M512 * GF256_RESTRICT x = reinterpret_cast<const GF256_M512 *>(
+                static_cast<const uint8_t *>(xs[i]) + offset);
+
+            z0 = gf256_muladd_avx512_vec(z0, _mm512_loadu_si512(x), table_lo_y, table_hi_y, clr_mask);
+            z1_ = gf256_muladd_avx512_vec(z1_, _mm512_loadu_si512(x + 1), table_lo_y, table_hi_y, clr_mask);
+            z2 = gf256_muladd_avx512_vec(z2, _mm512_loadu_si512(x + 2), table_lo_y, table_hi_y, clr_mask);
+            z3 = gf256_muladd_avx512_vec(z3, _mm512_loadu_si512(x + 3), table_lo_y, table_hi_y, clr_mask);
+        }
+
+        _mm512_storeu_si512(z, z0);
+        _mm512_storeu_si512(z + 1, z1_);
+        _mm512_storeu_si512(z + 2, z2);
+        _mm512_storeu_si512(z + 3, z3);
+    }
+
+    // Handle multiples of 64 bytes
+    for (; offset + 64 <= bytes; offset += 64)
+    {
+        GF256_M512 * GF256_RESTRICT z = reinterpret_cast<GF256_M512 *>(z1 + offset);
+        GF256_M512 z0 = _mm512_loadu_si512(z);
+        for (unsigned i = 0; i < count; ++i)
+        {
+            const GF256_M512 table_lo_y = _mm512_broadcast_i32x4(_mm_loadu_si128(GF256Ctx.MM128.TABLE_LO_Y + ys[i]));
+            const GF256_M512 table_hi_y = _mm512_broadcast_i32x4(_mm_loadu_si128(GF256Ctx.MM128.TABLE_HI_Y + ys[i]));
+            z0 = gf256_muladd_avx512_vec(z0, _mm512_loadu_si512(reinterpret_cast<const GF256_M512 *>(
+                static_cast<const uint8_t *>(xs[i]) + offset)), table_lo_y, table_hi_y, clr_mask);
+        }
+        _mm512_storeu_si512(z, z0);
+    }
+}
+
+GF256_TARGET_AVX512 static void gf256_add_mem_avx512(void * GF256_RESTRICT vx,
+                                                     const void * GF256_RESTRICT vy, int bytes)
+{
+    uint8_t * x1 = reinterpret_cast<uint8_t *>(vx);
+    const uint8_t * y1 = reinterpret_cast<const uint8_t *>(vy);
+
+    gf256_add_mem_avx512_blocks(x1, y1, bytes);
+    gf256_add_mem_avx2_blocks(x1, y1, bytes);
+    gf256_add_mem_sse2_blocks(x1, y1, bytes);
+    gf256_add_mem_tail(x1, y1, bytes);
+}
+
+GF256_TARGET_AVX512 static void gf256_add2_mem_avx512(void * GF256_RESTRICT vz, const void * GF256_RESTRICT vx,
+                                                      const void * GF256_RESTRICT vy, int bytes)
+{
+    uint8_t * z1 = reinterpret_cast<uint8_t *>(vz);
+    const uint8_t * x1 = reinterpret_cast<const uint8_t *>(vx);
+    const uint8_t * y1 = reinterpret_cast<const uint8_t *>(vy);
+
+    gf256_add2_mem_avx512_blocks(z1, x1, y1, bytes);
+    gf256_add2_mem_avx2_blocks(z1, x1, y1, bytes);
+    gf256_add2_mem_sse2_blocks(z1, x1, y1, bytes);
+    gf256_add2_mem_tail(z1, x1, y1, bytes);
+}
+
+GF256_TARGET_AVX512 static void gf256_addn_mem_avx512(void * GF256_RESTRICT vz, const void * const * GF256_RESTRICT srcs,
+                                                     unsigned count, int bytes)
+{
+    uint8_t * z1 = reinterpret_cast<uint8_t *>(vz);
+    int offset = 0;
+
+    gf256_addn_mem_avx512_blocks(z1, srcs, count, offset, bytes);
+    gf256_addn_mem_avx2_blocks(z1, srcs, count, offset, bytes);
+    gf256_addn_mem_sse2_blocks(z1, srcs, count, offset, bytes);
+    gf256_addn_mem_tail(z1, srcs, count, offset, bytes);
+}
+
+GF256_TARGET_AVX512 static void gf256_addn_muladdn_mem_avx512(void * GF256_RESTRICT vz,
+                                                              const void * const * GF256_RESTRICT xs, unsigned xCount, uint8_t y,
+                                                              const void * const * GF256_RESTRICT ws, unsigned wCount, int bytes)
+{
+    uint8_t * z1 = reinterpret_cast<uint8_t *>(vz);
+    int offset = 0;
+
+    gf256_addn_muladdn_mem_avx512_blocks(z1, xs, xCount, y, ws, wCount, offset, bytes);
+    gf256_addn_muladdn_mem_avx2_blocks(z1, xs, xCount, y, ws, wCount, offset, bytes);
+    gf256_addn_muladdn_mem_ssse3_blocks(z1, xs, xCount, y, ws, wCount, offset, bytes);
+    gf256_addn_muladdn_mem_tail(z1, xs, xCount, y, ws, wCount, offset, bytes);
+}
+
+GF256_TARGET_AVX512 static void gf256_muladdn_mem_avx512(void * GF256_RESTRICT vz, const uint8_t * GF256_RESTRICT ys,
+                                                         const void * const * GF256_RESTRICT xs, unsigned count, int bytes)
+{
+    uint8_t * z1 = reinterpret_cast<uint8_t *>(vz);
+    int offset = 0;
+
+    gf256_muladdn_mem_avx512_blocks(z1, ys, xs, count, offset, bytes);
+    gf256_muladdn_mem_avx2_blocks(z1, ys, xs, count, offset, bytes);
+    gf256_muladdn_mem_ssse3_blocks(z1, ys, xs, count, offset, bytes);
+    gf256_muladdn_mem_tail(z1, ys, xs, count, offset, bytes);
+}
+
+GF256_TARGET_AVX512 static void gf256_mul_mem_avx512(void * GF256_RESTRICT vz,
+                                                     const void * GF256_RESTRICT vx, uint8_t y, int bytes)
+{
+    uint8_t * z1 = reinterpret_cast<uint8_t *>(vz);
+    const uint8_t * x1 = reinterpret_cast<const uint8_t *>(vx);
+
+    gf256_mul_mem_avx512_blocks(z1, x1, y, bytes);
+    gf256_mul_mem_avx2_blocks(z1, x1, y, bytes);
+    gf256_mul_mem_ssse3_blocks(z1, x1, y, bytes);
+    gf256_mul_mem_tail(z1, x1, y, bytes);
+}
+
+GF256_TARGET_AVX512 static void gf256_muladd_mem_avx512(void * GF256_RESTRICT vz, uint8_t y,
+                                                        const void * GF256_RESTRICT vx, int bytes)
+{
+    uint8_t * z1 = reinterpret_cast<uint8_t *>(vz);
+    const uint8_t * x1 = reinterpret_cast<const uint8_t *>(vx);
+
+    gf256_muladd_mem_avx512_blocks(z1, y, x1, bytes);
+    gf256_muladd_mem_avx2_blocks(z1, y, x1, bytes);
+    gf256_muladd_mem_ssse3_blocks(z1, y, x1, bytes);
+    gf256_muladd_mem_tail(z1, y, x1, bytes);
+}
+
+#if defined(__GNUC__) && !defined(__clang__)
+    #pragma GCC diagnostic pop
+#endif
+
+#endif // GF256_TRY_AVX512
+
+
+#if defined(GF256_TRY_GFNI)
+
+//------------------------------------------------------------------------------
+// GFNI Blocks and Kernels
+//
+// Multiply 64 bytes at a time by the 8x8 bit matrix for y; see above
+
+// z[] = x[] * y for multiples of 64 bytes
+GF256_TARGET_GFNI static GF256_FORCE_INLINE void gf256_mul_mem_gfni_blocks(
+    uint8_t *& vz, const uint8_t *& vx, uint8_t y, int& bytes)
+{
+    if (bytes < 64)
+        return;
+
+    GF256_M512 * GF256_RESTRICT z64 = reinterpret_cast<GF256_M512 *>(vz);
+    const GF256_M512 * GF256_RESTRICT x64 = reinterpret_cast<const GF256_M512 *>(vx);
+
+    const GF256_M512 matrix_y = _mm512_set1_epi64((long long)GF256Ctx.GFNI_AFFINE_Y[y]);
+
+    // Handle multiples of 64 bytes
+    do
+    {
+        const GF256_M512 x0 = _mm512_loadu_si512(x64);
+        _mm512_storeu_si512(z64, _mm512_gf2p8affine_epi64_epi8(x0, matrix_y, 0));
+
+        bytes -= 64, ++x64, ++z64;
+    } while (bytes >= 64);
+
+    vz = reinterpret_cast<uint8_t *>(z64);
+    vx = reinterpret_cast<const uint8_t *>(x64);
+}
+
+// z[] += x[] * y for multiples of 64 bytes
+GF256_TARGET_GFNI static GF256_FORCE_INLINE void gf256_muladd_mem_gfni_blocks(
+    uint8_t *& vz, uint8_t y, const uint8_t *& vx, int& bytes)
+{
+    if (bytes < 64)
+        return;
+
+    GF256_M512 * GF256_RESTRICT z64 = reinterpret_cast<GF256_M512 *>(vz);
+    const GF256_M512 * GF256_RESTRICT x64 = reinterpret_cast<const GF256_M512 *>(vx);
+
+    const GF256_M512 matrix_y = _mm512_set1_epi64((long long)GF256Ctx.GFNI_AFFINE_Y[y]);
+
+    // Handle multiples of 128 bytes
+    while (bytes >= 128)
+    {
+        const GF256_M512 x0 = _mm512_loadu_si512(x64);
+        const GF256_M512 x1 = _mm512_loadu_si512(x64 + 1);
+        const GF256_M512 z0 = _mm512_loadu_si512(z64);
+        const GF256_M512 z1 = _mm512_loadu_si512(z64 + 1);
+        const GF256_M512 p0 = _mm512_gf2p8affine_epi64_epi8(x0, matrix_y, 0);
+        const GF256_M512 p1 = _mm512_gf2p8affine_epi64_epi8(x1, matrix_y, 0);
+        _mm512_storeu_si512(z64, _mm512_xor_si512(p0, z0));
+        _mm512_storeu_si512(z64 + 1, _mm512_xor_si512(p1, z1));
+
+        bytes -= 128, x64 += 2, z64 += 2;
+    }
+
+    // Handle multiples of 64 bytes
+    while (bytes >= 64)
+    {
+        const GF256_M512 x0 = _mm512_loadu_si512(x64);
+        const GF256_M512 p0 = _mm512_gf2p8affine_epi64_epi8(x0, matrix_y, 0);
+        const GF256_M512 z0 = _mm512_loadu_si512(z64);
+        _mm512_storeu_si512(z64, _mm512_xor_si512(p0, z0));
+
+        bytes -= 64, ++x64, ++z64;
+    }
+
+    vz = reinterpret_cast<uint8_t *>(z64);
+    vx = reinterpret_cast<const uint8_t *>(x64);
+}
+
+// z[] += sum of xs[] + y * sum of ws[] for multiples of 64 bytes
+GF256_TARGET_GFNI static GF256_FORCE_INLINE void gf256_addn_muladdn_mem_gfni_blocks(
+    uint8_t * GF256_RESTRICT z1,
+    const void * const * GF256_RESTRICT xs, unsigned xCount, uint8_t y,
+    const void * const * GF256_RESTRICT ws, unsigned wCount, int& offset, int bytes)
+{
+    if (offset + 64 > bytes)
+        return;
+
+    const GF256_M512 matrix_y = _mm512_set1_epi64((long long)GF256Ctx.GFNI_AFFINE_Y[y]);
+
+    // Handle multiples of 64 bytes
+    for (; offset + 64 <= bytes; offset += 64)
+    {
+        // Product stays in a register until it is multiplied by y
+        GF256_M512 p0 = _mm512_setzero_si512();
+        for (unsigned i = 0; i < wCount; ++i)
+            p0 = _mm512_xor_si512(p0, _mm512_loadu_si512(reinterpret_cast<const GF256_M512 *>(
+                static_cast<const uint8_t *>(ws[i]) + offset)));
+
+        GF256_M512 * GF256_RESTRICT z = reinterpret_cast<GF256_M512 *>(z1 + offset);
+        GF256_M512 z0 = _mm512_loadu_si512(z);
+        for (unsigned i = 0; i < xCount; ++i)
+            z0 = _mm512_xor_si512(z0, _mm512_loadu_si512(reinterpret_cast<const GF256_M512 *>(
+                static_cast<const uint8_t *>(xs[i]) + offset)));
+
+        const GF256_M512 p1 = _mm512_gf2p8affine_epi64_epi8(p0, matrix_y, 0);
+        _mm512_storeu_si512(z, _mm512_xor_si512(z0, p1));
+    }
+}
+
+// z[] += sum of ys[] * xs[] for multiples of 64 bytes
+GF256_TARGET_GFNI static GF256_FORCE_INLINE void gf256_muladdn_mem_gfni_blocks(
+    uint8_t * GF256_RESTRICT z1, const uint8_t * GF256_RESTRICT ys,
+    const void * const * GF256_RESTRICT xs, unsigned count, int& offset, int bytes)
+{
+    // Handle multiples of 256 bytes, keeping a tile of the destination in
+    // registers so each affine matrix is loaded once per tile
+    for (; offset + 256 <= bytes; offset += 256)
+    {
+        GF256_M512 * GF256_RESTRICT z = reinterpret_cast<GF256_M512 *>(z1 + offset);
+        GF256_M512 z0 = _mm512_loadu_si512(z);
+        GF256_M512 z1_ = _mm512_loadu_si512(z + 1);
+        GF256_M512 z2 = _mm512_loadu_si512(z + 2);
+        GF256_M512 z3 = _mm512_loadu_si512(z + 3);
+
+        for (unsigned i = 0; i < count; ++i)
+        {
+            const GF256_M512 matrix_y = _mm512_set1_epi64((long long)GF256Ctx.GFNI_AFFINE_Y[ys[i]]);
+            const GF256_M512 * GF256_RESTRICT x = reinterpret_cast<const GF256_M512 *>(
+                static_cast<const uint8_t *>(xs[i]) + offset);
+
+            z0 = _mm512_xor_si512(z0, _mm512_gf2p8affine_epi64_epi8(_mm512_loadu_si512(x), matrix_y, 0));
+            z1_ = _mm512_xor_si512(z1_, _mm512_gf2p8affine_epi64_epi8(_mm512_loadu_si512(x + 1), matrix_y, 0));
+            z2 = _mm512_xor_si512(z2, _mm512_gf2p8affine_epi64_epi8(_mm512_loadu_si512(x + 2), matrix_y, 0));
+            z3 = _mm512_xor_si512(z3, _mm512_gf2p8affine_epi64_epi8(_mm512_loadu_si512(x + 3), matrix_y, 0));
+        }
+
+        _mm512_storeu_si512(z, z0);
+        _mm512_storeu_si512(z + 1, z1_);
+        _mm512_storeu_si512(z + 2, z2);
+        _mm512_storeu_si512(z + 3, z3);
+    }
+
+    // Handle multiples of 64 bytes
+    for (; offset + 64 <= bytes; offset += 64)
+    {
+        GF256_M512 * GF256_RESTRICT z = reinterpret_cast<GF256_M512 *>(z1 + offset);
+        GF256_M512 z0 = _mm512_loadu_si512(z);
+        for (unsigned i = 0; i < count; ++i)
+        {
+            const GF256_M512 matrix_y = _mm512_set1_epi64((long long)GF256Ctx.GFNI_AFFINE_Y[ys[i]]);
+            const GF256_M512 x0 = _mm512_loadu_si512(reinterpret_cast<const GF256_M512 *>(
+                static_cast<const uint8_t *>(xs[i]) + offset));
+            z0 = _mm512_xor_si512(z0, _mm512_gf2p8affine_epi64_epi8(x0, matrix_y, 0));
+        }
+        _mm512_storeu_si512(z, z0);
+    }
+}
+
+GF256_TARGET_GFNI static void gf256_mul_mem_gfni(void * GF256_RESTRICT vz,
+                                                 const void * GF256_RESTRICT vx, uint8_t y, int bytes)
+{
+    uint8_t * z1 = reinterpret_cast<uint8_t *>(vz);
+    const uint8_t * x1 = reinterpret_cast<const uint8_t *>(vx);
+
+    gf256_mul_mem_gfni_blocks(z1, x1, y, bytes);
+    gf256_mul_mem_avx2_blocks(z1, x1, y, bytes);
+    gf256_mul_mem_ssse3_blocks(z1, x1, y, bytes);
+    gf256_mul_mem_tail(z1, x1, y, bytes);
+}
+
+GF256_TARGET_GFNI static void gf256_muladd_mem_gfni(void * GF256_RESTRICT vz, uint8_t y,
+                                                    const void * GF256_RESTRICT vx, int bytes)
+{
+    uint8_t * z1 = reinterpret_cast<uint8_t *>(vz);
+    const uint8_t * x1 = reinterpret_cast<const uint8_t *>(vx);
+
+    gf256_muladd_mem_gfni_blocks(z1, y, x1, bytes);
+    gf256_muladd_mem_avx2_blocks(z1, y, x1, bytes);
+    gf256_muladd_mem_ssse3_blocks(z1, y, x1, bytes);
+    gf256_muladd_mem_tail(z1, y, x1, bytes);
+}
+
+GF256_TARGET_GFNI static void gf256_addn_muladdn_mem_gfni(void * GF256_RESTRICT vz,
+                                                          const void * const * GF256_RESTRICT xs, unsigned xCount, uint8_t y,
+                                                          const void * const * GF256_RESTRICT ws, unsigned wCount, int bytes)
+{
+    uint8_t * z1 = reinterpret_cast<uint8_t *>(vz);
+    int offset = 0;
+
+    gf256_addn_muladdn_mem_gfni_blocks(z1, xs, xCount, y, ws, wCount, offset, bytes);
+    gf256_addn_muladdn_mem_avx2_blocks(z1, xs, xCount, y, ws, wCount, offset, bytes);
+    gf256_addn_muladdn_mem_ssse3_blocks(z1, xs, xCount, y, ws, wCount, offset, bytes);
+    gf256_addn_muladdn_mem_tail(z1, xs, xCount, y, ws, wCount, offset, bytes);
+}
+
+GF256_TARGET_GFNI static void gf256_muladdn_mem_gfni(void * GF256_RESTRICT vz, const uint8_t * GF256_RESTRICT ys,
+                                                     const void * const * GF256_RESTRICT xs, unsigned count, int bytes)
+{
+    uint8_t * z1 = reinterpret_cast<uint8_t *>(vz);
+    int offset = 0;
+
+    gf256_muladdn_mem_gfni_blocks(z1, ys, xs, count, offset, bytes);
+    gf256_muladdn_mem_avx2_blocks(z1, ys, xs, count, offset, bytes);
+    gf256_muladdn_mem_ssse3_blocks(z1, ys, xs, count, offset, bytes);
+    gf256_muladdn_mem_tail(z1, ys, xs, count, offset, bytes);
+}
+
+#endif // GF256_TRY_GFNI
+
+#endif // GF256_TARGET_MOBILE
+
+
+//------------------------------------------------------------------------------
+// Kernel Dispatch
+
+typedef void (*gf256_add_mem_fn)(void * GF256_RESTRICT vx,
+                                 const void * GF256_RESTRICT vy, int bytes);
+typedef void (*gf256_add2_mem_fn)(void * GF256_RESTRICT vz, const void * GF256_RESTRICT vx,
+                                  const void * GF256_RESTRICT vy, int bytes);
+typedef void (*gf256_addn_mem_fn)(void * GF256_RESTRICT vz, const void * const * GF256_RESTRICT srcs,
+                                  unsigned count, int bytes);
+typedef void (*gf256_addn_muladdn_mem_fn)(void * GF256_RESTRICT vz,
+    const void * const * GF256_RESTRICT xs, unsigned xCount, uint8_t y,
+    const void * const * GF256_RESTRICT ws, unsigned wCount, int bytes);
+typedef void (*gf256_muladdn_mem_fn)(void * GF256_RESTRICT vz, const uint8_t * GF256_RESTRICT ys,
+                                    const void * const * GF256_RESTRICT xs, unsigned count, int bytes);
+typedef void (*gf256_mul_mem_fn)(void * GF256_RESTRICT vz,
+                                 const void * GF256_RESTRICT vx, uint8_t y, int bytes);
+typedef void (*gf256_muladd_mem_fn)(void * GF256_RESTRICT vz, uint8_t y,
+                                    const void * GF256_RESTRICT vx, int bytes);
+
+// Kernels selected for the host by gf256_kernels_init()
+static gf256_add_mem_fn KernelAddMem = gf256_add_mem_portable;
+static gf256_add2_mem_fn KernelAdd2Mem = gf256_add2_mem_portable;
+static gf256_add2_mem_fn KernelAddSetMem = gf256_addset_mem_portable;
+static gf256_addn_mem_fn KernelAddNMem = gf256_addn_mem_portable;
+static gf256_mul_mem_fn KernelMulMem = gf256_mul_mem_portable;
+static gf256_muladd_mem_fn KernelMulAddMem = gf256_muladd_mem_portable;
+static gf256_addn_muladdn_mem_fn KernelAddNMulAddNMem = gf256_addn_muladdn_mem_portable;
+static gf256_muladdn_mem_fn KernelMulAddNMem = gf256_muladdn_mem_portable;
+
+static void gf256_kernels_init()
+{
+#if defined(GF256_TRY_NEON)
+    if (CpuHasNeon)
+    {
+        KernelAddMem = gf256_add_mem_neon;
+        KernelAdd2Mem = gf256_add2_mem_neon;
+        KernelAddSetMem = gf256_addset_mem_neon;
+        KernelAddNMem = gf256_addn_mem_neon;
+        KernelMulMem = gf256_mul_mem_neon;
+        KernelMulAddMem = gf256_muladd_mem_neon;
+        KernelAddNMulAddNMem = gf256_addn_muladdn_mem_neon;
+        KernelMulAddNMem = gf256_muladdn_mem_neon;
+    }
+#endif // GF256_TRY_NEON
+
+#if !defined(GF256_TARGET_MOBILE)
+    KernelAddMem = gf256_add_mem_sse2;
+    KernelAdd2Mem = gf256_add2_mem_sse2;
+    KernelAddSetMem = gf256_addset_mem_sse2;
+    KernelAddNMem = gf256_addn_mem_sse2;
+
+    if (CpuHasSSSE3)
+    {
+        KernelMulMem = gf256_mul_mem_ssse3;
+        KernelMulAddMem = gf256_muladd_mem_ssse3;
+        KernelAddNMulAddNMem = gf256_addn_muladdn_mem_ssse3;
+        KernelMulAddNMem = gf256_muladdn_mem_ssse3;
+    }
+
+    if (CpuHasAVX2)
+    {
+        KernelAddMem = gf256_add_mem_avx2;
+        KernelAdd2Mem = gf256_add2_mem_avx2;
+        KernelAddSetMem = gf256_addset_mem_avx2;
+        KernelAddNMem = gf256_addn_mem_avx2;
+        KernelMulMem = gf256_mul_mem_avx2;
+        KernelMulAddMem = gf256_muladd_mem_avx2;
+        KernelAddNMulAddNMem = gf256_addn_muladdn_mem_avx2;
+        KernelMulAddNMem = gf256_muladdn_mem_avx2;
+    }
+
+# if defined(GF256_TRY_AVX512)
+    if (CpuHasAVX512)
+    {
+        KernelAddMem = gf256_add_mem_avx512;
+        KernelAdd2Mem = gf256_add2_mem_avx512;
+        KernelAddNMem = gf256_addn_mem_avx512;
+        KernelMulMem = gf256_mul_mem_avx512;
+        KernelMulAddMem = gf256_muladd_mem_avx512;
+        KernelAddNMulAddNMem = gf256_addn_muladdn_mem_avx512;
+        KernelMulAddNMem = gf256_muladdn_mem_avx512;
+    }
+# endif // GF256_TRY_AVX512
+
+# if defined(GF256_TRY_GFNI)
+    if (CpuHasGFNI)
+    {
+        KernelMulMem = gf256_mul_mem_gfni;
+        KernelMulAddMem = gf256_muladd_mem_gfni;
+        KernelAddNMulAddNMem = gf256_addn_muladdn_mem_gfni;
+        KernelMulAddNMem = gf256_muladdn_mem_gfni;
+    }
+# endif // GF256_TRY_GFNI
+#endif // GF256_TARGET_MOBILE
+}
+
+extern "C" void gf256_add_mem(void * GF256_RESTRICT vx,
+                              const void * GF256_RESTRICT vy, int bytes)
+{
+    KernelAddMem(vx, vy, bytes);
+}
+
+extern "C" void gf256_add2_mem(void * GF256_RESTRICT vz, const void * GF256_RESTRICT vx,
+                               const void * GF256_RESTRICT vy, int bytes)
+{
+    KernelAdd2Mem(vz, vx, vy, bytes);
+}
+
+extern "C" void gf256_addset_mem(void * GF256_RESTRICT vz, const void * GF256_RESTRICT vx,
+                                 const void * GF256_RESTRICT vy, int bytes)
+{
+    KernelAddSetMem(vz, vx, vy, bytes);
+}
+
+extern "C" void gf256_addn_mem(void * GF256_RESTRICT vz, const void * const * GF256_RESTRICT srcs,
+                               unsigned count, int bytes)
+{
+    // Use a single if-statement to handle special cases
+    if (count <= 1)
+    {
+        if (count == 1)
+            KernelAddMem(vz, srcs[0], bytes);
+        return;
+    }
+
+    KernelAddNMem(vz, srcs, count, bytes);
+}
+
+extern "C" void gf256_mul_mem(void * GF256_RESTRICT vz, const void * GF256_RESTRICT vx, uint8_t y, int bytes)
+{
+    // Use a single if-statement to handle special cases
+    if (y <= 1)
+    {
+        if (y == 0)
+            memset(vz, 0, bytes);
+        else if (vz != vx)
+            memcpy(vz, vx, bytes);
+        return;
+    }
+
+    KernelMulMem(vz, vx, y, bytes);
+}
+
+extern "C" void gf256_muladd_mem(void * GF256_RESTRICT vz, uint8_t y,
+                                 const void * GF256_RESTRICT vx, int bytes)
+{
+    // Use a single if-statement to handle special cases
+    if (y <= 1)
+    {
+        if (y == 1)
+            KernelAddMem(vz, vx, bytes);
+        return;
+    }
+
+    KernelMulAddMem(vz, y, vx, bytes);
+}
+
+extern "C" void gf256_addn_muladdn_mem(void * GF256_RESTRICT vz,
+    const void * const * GF256_RESTRICT xs, unsigned xCount, uint8_t y,
+    const void * const * GF256_RESTRICT ws, unsigned wCount, int bytes)
+{
+    // Use a single if-statement to handle special cases
+    if (y <= 1 || wCount <= 0)
+    {
+        gf256_addn_mem(vz, xs, xCount, bytes);
+        if (y == 1)
+            gf256_addn_mem(vz, ws, wCount, bytes);
+        return;
+    }
+
+    KernelAddNMulAddNMem(vz, xs, xCount, y, ws, wCount, bytes);
+}
+
+extern "C" void gf256_muladdn_mem(void * GF256_RESTRICT vz, const uint8_t * GF256_RESTRICT ys,
+                                  const void * const * GF256_RESTRICT xs, unsigned count, int bytes)
+{
+    // Use a single if-statement to handle special cases
+    if (count <= 1)
+    {
+        if (count == 1)
+            gf256_muladd_mem(vz, ys[0], xs[0], bytes);
+        return;
+    }
+
+    KernelMulAddNMem(vz, ys, xs, count, bytes);
+}
+
 extern "C" void gf256_memswap(void * GF256_RESTRICT vx, void * GF256_RESTRICT vy, int bytes)
 {
 #if defined(GF256_TARGET_MOBILE)
@@ -42,6 +42,14 @@
     SIMD instructions.  This is somewhat slower than XOR,
     but fast enough to not become a major bottleneck when
     used sparingly.
+
+    On processors with GFNI, multiplication by a constant is
+    a single affine transform instruction on 64 bytes.
+
+    The bulk memory operations dispatch through function
+    pointers to the kernels selected for the host processor
+    by gf256_init(), so one binary runs at full speed on
+    SSSE3, AVX2, AVX-512 and GFNI capable machines.
 */
 
 #include <stdint.h> // uint32_t etc
@@ -57,13 +65,32 @@
     #define GF256_TARGET_MOBILE
 #endif // ANDROID
 
-#if defined(__AVX2__) || (defined (_MSC_VER) && _MSC_VER >= 1900)
+/*
+    All of the x86 kernels are compiled regardless of the compiler flags, and
+    the fastest one supported by the host is selected by gf256_init().
+    On GCC and Clang each kernel is built with a target attribute, so this
+    only requires a compiler new enough to know about the instructions.
+*/
+#if !defined(GF256_TARGET_MOBILE)
     #define GF256_TRY_AVX2 /* 256-bit */
     #include <immintrin.h>
+
+# if (defined(__clang__) && __clang_major__ >= 7) || \
+     (!defined(__clang__) && defined(__GNUC__) && __GNUC__ >= 8) || \
+     (defined(_MSC_VER) && _MSC_VER >= 1920)
+    #define GF256_TRY_AVX512 /* 512-bit */
+    #define GF256_TRY_GFNI /* vgf2p8affineqb */
+# endif
+#endif // GF256_TARGET_MOBILE
+
+// Alignment suits the widest kernel that was compiled
+#if defined(GF256_TRY_AVX512)
+    #define GF256_ALIGN_BYTES 64
+#elif defined(GF256_TRY_AVX2)
     #define GF256_ALIGN_BYTES 32
-#else // __AVX2__
+#else // GF256_TRY_AVX2
     #define GF256_ALIGN_BYTES 16
-#endif // __AVX2__
+#endif // GF256_TRY_AVX2
 
 #if !defined(GF256_TARGET_MOBILE)
     // Note: MSVC currently only supports SSSE3 but not AVX2
@@ -99,6 +126,11 @@
     #define GF256_M256 __m256i
 #endif
 
+#ifdef GF256_TRY_AVX512
+    // Compiler-specific 512-bit SIMD register keyword
+    #define GF256_M512 __m512i
+#endif
+
 // Compiler-specific C++11 restrict keyword
 #define GF256_RESTRICT __restrict
 
@@ -154,6 +186,10 @@ struct gf256_ctx
         GF256_ALIGNED GF256_M256 TABLE_HI_Y[256];
     } MM256;
 #endif // GF256_TRY_AVX2
+#ifdef GF256_TRY_GFNI
+    /// 8x8 bit matrices for multiplying by y with vgf2p8affineqb
+    GF256_ALIGNED uint64_t GFNI_AFFINE_Y[256];
+#endif // GF256_TRY_GFNI
 
     /// Mul/Div/Inv/Sqr tables
     uint8_t GF256_MUL_TABLE[256 * 256];
@@ -252,6 +288,17 @@ extern void gf256_add2_mem(void * GF256_RESTRICT vz, const void * GF256_RESTRICT
 extern void gf256_addset_mem(void * GF256_RESTRICT vz, const void * GF256_RESTRICT vx,
                              const void * GF256_RESTRICT vy, int bytes);
 
+/// Performs "z[] += srcs[0][] + srcs[1][] + ... + srcs[count-1][]"
+/// This reads and writes the destination once for all of the sources
+extern void gf256_addn_mem(void * GF256_RESTRICT vz, const void * const * GF256_RESTRICT srcs,
+                           unsigned count, int bytes);
+
+/// Performs "z[] += (xs[0][] + ... + xs[xCount-1][]) + y * (ws[0][] + ... + ws[wCount-1][])"
+/// The sum of ws[] stays in registers, so no product buffer is written
+extern void gf256_addn_muladdn_mem(void * GF256_RESTRICT vz,
+    const void * const * GF256_RESTRICT xs, unsigned xCount, uint8_t y,
+    const void * const * GF256_RESTRICT ws, unsigned wCount, int bytes);
+
 /// Performs "z[] = x[] * y" bulk memory operation
 extern void gf256_mul_mem(void * GF256_RESTRICT vz,
                           const void * GF256_RESTRICT vx, uint8_t y, int bytes);
@@ -260,6 +307,11 @@ extern void gf256_mul_mem(void * GF256_RESTRICT vz,
 extern void gf256_muladd_mem(void * GF256_RESTRICT vz, uint8_t y,
                              const void * GF256_RESTRICT vx, int bytes);
 
+/// Performs "z[] += ys[0] * xs[0][] + ys[1] * xs[1][] + ... + ys[count-1] * xs[count-1][]"
+/// This reads and writes the destination once for all of the sources
+extern void gf256_muladdn_mem(void * GF256_RESTRICT vz, const uint8_t * GF256_RESTRICT ys,
+                              const void * const * GF256_RESTRICT xs, unsigned count, int bytes);
+
 /// Performs "x[] /= y" bulk memory operation
 static GF256_FORCE_INLINE void gf256_div_mem(void * GF256_RESTRICT vz,
                                              const void * GF256_RESTRICT vx, uint8_t y, int bytes)
@@ -33,6 +33,14 @@
 #include <memory>
 #include <iostream>
 #include <string>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <chrono>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
 using namespace std;
 
 //#define TEST_DATA_ALL_SAME
@@ -64,6 +72,11 @@ using namespace std;
     #undef DID_DEFINE_WINSOCKAPI
 #endif
 
+#ifndef _WIN32
+    #include <unistd.h> // usleep
+    #include <sys/time.h> // gettimeofday
+#endif
+
 
 //------------------------------------------------------------------------------
 // Threads
@@ -103,6 +116,13 @@ static uint64_t GetTimeUsec()
 #endif // _WIN32
 }
 
+// Monotonic time with sub-microsecond resolution for timing short phases
+static uint64_t GetTimeNsec()
+{
+    return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
 
 //------------------------------------------------------------------------------
 // Self-Checking Packet
@@ -227,7 +247,7 @@ public:
     The deck will contain elements with values between 0 and count - 1.
 */
 
-static void ShuffleDeck16(fecal::PCGRandom &prng, uint16_t * GF256_RESTRICT deck, uint32_t count)
+static void ShuffleDeck32(fecal::PCGRandom &prng, uint32_t * GF256_RESTRICT deck, uint32_t count)
 {
     deck[0] = 0;
 
@@ -279,7 +299,7 @@ static void ShuffleDeck16(fecal::PCGRandom &prng, uint16_t * GF256_RESTRICT deck
             }
         }
     }
-    else
+    else if (count <= 65536)
     {
         // For each deck entry,
         for (uint32_t ii = 1;;)
@@ -309,6 +329,16 @@ static void ShuffleDeck16(fecal::PCGRandom &prng, uint16_t * GF256_RESTRICT deck
             }
         }
     }
+    else
+    {
+        // For each deck entry,
+        for (uint32_t ii = 1; ii < count; ++ii)
+        {
+            const uint32_t jj = prng.Next() % (ii + 1);
+            deck[ii] = deck[jj];
+            deck[jj] = ii;
+        }
+    }
 }
 
 
@@ -378,9 +408,8 @@ static void BasicTest(unsigned input_count, unsigned symbol_bytes, unsigned seed
             }
 
 #ifndef TEST_LOSE_FIRST_K_PACKETS
-            FECAL_DEBUG_ASSERT(input_count <= 65536);
-            std::vector<uint16_t> deck(input_count);
-            ShuffleDeck16(prng, &deck[0], input_count);
+            std::vector<uint32_t> deck(input_count);
+            ShuffleDeck32(prng, &deck[0], input_count);
 #endif
 
             for (unsigned i = 0; i < input_count; ++i)
@@ -533,6 +562,633 @@ static void BasicTest(unsigned input_count, unsigned symbol_bytes, unsigned seed
 }
 
 
+//------------------------------------------------------------------------------
+// BenchmarkThreadPool
+
+/*
+    Thread pool that implements FecalExecutor for the sweep benchmark.
+    The calling thread runs tasks alongside the workers.
+*/
+class BenchmarkThreadPool
+{
+public:
+    explicit BenchmarkThreadPool(unsigned threadCount)
+    {
+        Executor.ParallelFor = &BenchmarkThreadPool::ParallelFor;
+        Executor.Context = this;
+        Executor.WorkerCount = threadCount;
+
+        for (unsigned i = 1; i < threadCount; ++i)
+            Workers.emplace_back(&BenchmarkThreadPool::WorkerLoop, this);
+    }
+    ~BenchmarkThreadPool()
+    {
+        {
+            std::lock_guard<std::mutex> locker(Lock);
+            Terminated = true;
+        }
+        WakeCondition.notify_all();
+        for (std::thread& worker : Workers)
+            worker.join();
+    }
+
+    // Executor to pass in the codec options
+    FecalExecutor Executor;
+
+protected:
+    std::vector<std::thread> Workers;
+    std::mutex Lock;
+    std::condition_variable WakeCondition;
+    std::condition_variable DoneCondition;
+    bool Terminated = false;
+
+    // Current job, only modified while no worker is running tasks
+    uint64_t JobNumber = 0;
+    unsigned TaskCount = 0;
+    FecalTaskFunction TaskFunction = nullptr;
+    void* TaskContext = nullptr;
+    std::atomic<unsigned> NextTask;
+
+    // Number of tasks not yet completed, and workers inside RunTasks()
+    unsigned TasksRemaining = 0;
+    unsigned ActiveWorkers = 0;
+
+    static void ParallelFor(void* executor_context, unsigned task_count,
+                            FecalTaskFunction task_function, void* task_context)
+    {
+        BenchmarkThreadPool* pool = reinterpret_cast<BenchmarkThreadPool*>(executor_context);
+
+        {
+            std::lock_guard<std::mutex> locker(pool->Lock);
+            pool->TaskCount = task_count;
+            pool->TaskFunction = task_function;
+            pool->TaskContext = task_context;
+            pool->NextTask = 0;
+            pool->TasksRemaining = task_count;
+            ++pool->JobNumber;
+        }
+        pool->WakeCondition.notify_all();
+
+        pool->RunTasks();
+
+        // Wait for the tasks to complete and for the workers to stop claiming
+        // tasks, so the next job can reset NextTask safely
+        std::unique_lock<std::mutex> locker(pool->Lock);
+        pool->DoneCondition.wait(locker, [pool]() {
+            return pool->TasksRemaining == 0 && pool->ActiveWorkers == 0;
+        });
+    }
+
+    void RunTasks()
+    {
+        unsigned completed = 0;
+        for (;;)
+        {
+            const unsigned taskIndex = NextTask++;
+            if (taskIndex >= TaskCount)
+                break;
+            TaskFunction(TaskContext, taskIndex);
+            ++completed;
+        }
+
+        std::lock_guard<std::mutex> locker(Lock);
+        TasksRemaining -= completed;
+        if (TasksRemaining == 0)
+            DoneCondition.notify_all();
+    }
+
+    void WorkerLoop()
+    {
+        uint64_t lastJob = 0;
+        std::unique_lock<std::mutex> locker(Lock);
+        for (;;)
+        {
+            WakeCondition.wait(locker, [this, lastJob]() {
+                return Terminated || JobNumber != lastJob;
+            });
+            if (Terminated)
+                return;
+            lastJob = JobNumber;
+
+            ++ActiveWorkers;
+            locker.unlock();
+            RunTasks();
+            locker.lock();
+            --ActiveWorkers;
+            if (ActiveWorkers == 0 && TasksRemaining == 0)
+                DoneCondition.notify_all();
+        }
+    }
+};
+
+
+//------------------------------------------------------------------------------
+// Sweep Phases
+
+/*
+    Phases timed by the sweep benchmark.
+
+    The decoder stages are read from fecal_decoder_get_stats(), so the
+    benchmark must be linked with a library built with FECAL_ENABLE_STATS.
+    The elimination and solution stages run on the executor, so their times
+    are summed over all of the tasks (CPU time rather than wall time when
+    there is more than one thread).
+*/
+enum SweepPhase
+{
+    Phase_EncoderInitialize,     // fecal_encoder_create_ex()
+    Phase_Encode,                // fecal_encode(), per recovery symbol
+    Phase_DecoderInitialize,     // fecal_decoder_create_ex()
+    Phase_GenerateMatrix,        // FecalDecoderStats::GenerateMatrixNsec
+    Phase_GaussianElimination,   // FecalDecoderStats::GaussianEliminationNsec
+    Phase_ScheduleElimination,   // FecalDecoderStats::ScheduleNsec
+    Phase_EliminateOriginalData, // FecalDecoderStats::EliminateNsec
+    Phase_BackSubstitution,      // FecalDecoderStats::SolveNsec
+    Phase_Decode,                // Whole decode, wall time
+
+    Phase_Count
+};
+
+static const char* const kSweepPhaseNames[Phase_Count] = {
+    "EncoderInitialize",
+    "Encode",
+    "DecoderInitialize",
+    "GenerateMatrix",
+    "GaussianElimination",
+    "ScheduleElimination",
+    "EliminateOriginalData",
+    "BackSubstitution",
+    "Decode"
+};
+
+//------------------------------------------------------------------------------
+// Parameter Sweep
+
+enum SweepLossPattern
+{
+    Loss_Random, // Lost originals are chosen uniformly at random
+    Loss_Burst   // Lost originals are one run of consecutive indices
+};
+
+enum SweepFormat
+{
+    Format_JSON,
+    Format_CSV
+};
+
+// One thread, and all of the hardware threads if there are more
+static std::vector<unsigned> DefaultSweepThreadCounts()
+{
+    std::vector<unsigned> threadCounts(1, 1);
+    const unsigned hardwareThreads = std::thread::hardware_concurrency();
+    if (hardwareThreads > 1)
+        threadCounts.push_back(hardwareThreads);
+    return threadCounts;
+}
+
+struct SweepParameters
+{
+    std::vector<unsigned> InputCounts = { 16, 128, 1024 };
+    std::vector<unsigned> SymbolBytes = { 1300, 16384 };
+    std::vector<unsigned> LossCounts = { 1, 4, 16, 64 };
+    std::vector<SweepLossPattern> LossPatterns = { Loss_Random, Loss_Burst };
+    std::vector<unsigned> ThreadCounts = DefaultSweepThreadCounts();
+    unsigned Trials = 20;
+    SweepFormat Format = Format_JSON;
+};
+
+// Latency samples for one phase, in nanoseconds
+struct PhaseSamples
+{
+    std::vector<uint64_t> Nsec;
+
+    // Nearest-rank percentile in microseconds
+    double PercentileUsec(double percent)
+    {
+        if (Nsec.empty())
+            return 0.;
+        std::sort(Nsec.begin(), Nsec.end());
+        size_t rank = (size_t)((percent / 100.) * Nsec.size() + 0.999999);
+        if (rank < 1)
+            rank = 1;
+        if (rank > Nsec.size())
+            rank = Nsec.size();
+        return Nsec[rank - 1] / 1000.;
+    }
+    double MeanUsec() const
+    {
+        if (Nsec.empty())
+            return 0.;
+        double sum = 0.;
+        for (uint64_t t : Nsec)
+            sum += (double)t;
+        return sum / Nsec.size() / 1000.;
+    }
+};
+
+// Results for one point of the sweep
+struct SweepResult
+{
+    unsigned InputCount = 0;
+    unsigned SymbolBytes = 0;
+    unsigned LossCount = 0;
+    SweepLossPattern LossPattern = Loss_Random;
+    unsigned ThreadCount = 0;
+    unsigned Trials = 0;
+
+    // Trials that needed more recovery symbols than losses
+    unsigned ExtraTrials = 0;
+
+    // Total recovery symbols beyond the loss count over all trials
+    unsigned ExtraSymbols = 0;
+
+    PhaseSamples Phases[Phase_Count];
+};
+
+// Returns false if a codec call or the recovered data check failed
+static bool RunSweepPoint(
+    SweepResult& result,
+    const std::vector<void*>& inputData,
+    BenchmarkThreadPool& pool)
+{
+    const unsigned input_count = result.InputCount;
+    const unsigned symbol_bytes = result.SymbolBytes;
+    const unsigned loss_count = result.LossCount;
+    const uint64_t total_bytes = (uint64_t)input_count * symbol_bytes;
+
+    FecalEncoderOptions encoderOptions;
+    memset(&encoderOptions, 0, sizeof(encoderOptions));
+    encoderOptions.Executor = pool.Executor;
+
+    FecalDecoderOptions decoderOptions;
+    memset(&decoderOptions, 0, sizeof(decoderOptions));
+    decoderOptions.Executor = pool.Executor;
+
+    // The decoder modifies recovery data in place, so it gets a fresh copy
+    const unsigned maxRecovery = loss_count + 32;
+    std::vector<uint8_t> recoveryData((size_t)maxRecovery * symbol_bytes);
+
+    std::vector<uint32_t> deck(input_count);
+    std::vector<char> lost(input_count);
+
+    for (unsigned trial = 0; trial < result.Trials; ++trial)
+    {
+        fecal::PCGRandom prng;
+        prng.Seed(input_count * 31 + loss_count, symbol_bytes * 1000 + trial);
+
+        // Choose the lost originals
+        std::fill(lost.begin(), lost.end(), 0);
+        if (result.LossPattern == Loss_Random)
+        {
+            ShuffleDeck32(prng, &deck[0], input_count);
+            for (unsigned i = 0; i < loss_count; ++i)
+                lost[deck[i]] = 1;
+        }
+        else
+        {
+            const unsigned start = prng.Next() % input_count;
+            for (unsigned i = 0; i < loss_count; ++i)
+                lost[(start + i) % input_count] = 1;
+        }
+
+        uint64_t t0 = GetTimeNsec();
+        FecalEncoder encoder = fecal_encoder_create_ex(input_count, &inputData[0], total_bytes, &encoderOptions);
+        uint64_t t1 = GetTimeNsec();
+        if (!encoder)
+        {
+            cerr << "Error: Unable to create encoder" << endl;
+            return false;
+        }
+        result.Phases[Phase_EncoderInitialize].Nsec.push_back(t1 - t0);
+
+        t0 = GetTimeNsec();
+        FecalDecoder decoder = fecal_decoder_create_ex(input_count, total_bytes, &decoderOptions);
+        t1 = GetTimeNsec();
+        if (!decoder)
+        {
+            cerr << "Error: Unable to create decoder" << endl;
+            fecal_free(encoder);
+            return false;
+        }
+        result.Phases[Phase_DecoderInitialize].Nsec.push_back(t1 - t0);
+
+        for (unsigned i = 0; i < input_count; ++i)
+        {
+            if (lost[i])
+                continue;
+
+            FecalSymbol original;
+            original.Data = inputData[i];
+            original.Bytes = symbol_bytes;
+            original.Index = i;
+
+            if (fecal_decoder_add_original(decoder, &original) != Fecal_Success)
+            {
+                cerr << "Error: Unable to add original data to decoder" << endl;
+                fecal_free(decoder);
+                fecal_free(encoder);
+                return false;
+            }
+        }
+
+        uint64_t decodeNsec = 0;
+        bool success = false;
+
+        for (unsigned recoveryIndex = 0; recoveryIndex < maxRecovery; ++recoveryIndex)
+        {
+            FecalSymbol recovery;
+            recovery.Index = recoveryIndex;
+            recovery.Data = &recoveryData[(size_t)recoveryIndex * symbol_bytes];
+            recovery.Bytes = symbol_bytes;
+
+            t0 = GetTimeNsec();
+            int encodeResult = fecal_encode(encoder, &recovery);
+            t1 = GetTimeNsec();
+            if (encodeResult != Fecal_Success)
+            {
+                cerr << "Error: Unable to generate encoded data. error=" << encodeResult << endl;
+                fecal_free(decoder);
+                fecal_free(encoder);
+                return false;
+            }
+            result.Phases[Phase_Encode].Nsec.push_back(t1 - t0);
+
+            if (fecal_decoder_add_recovery(decoder, &recovery) != Fecal_Success)
+            {
+                cerr << "Error: Unable to add recovery data to decoder" << endl;
+                fecal_free(decoder);
+                fecal_free(encoder);
+                return false;
+            }
+
+            RecoveredSymbols recovered;
+            t0 = GetTimeNsec();
+            int decodeResult = fecal_decode(decoder, &recovered);
+            t1 = GetTimeNsec();
+            decodeNsec += t1 - t0;
+
+            if (decodeResult == Fecal_NeedMoreData)
+                continue;
+            if (decodeResult != Fecal_Success)
+            {
+                cerr << "Error: Decode returned " << decodeResult << endl;
+                fecal_free(decoder);
+                fecal_free(encoder);
+                return false;
+            }
+
+            for (unsigned i = 0; i < recovered.Count; ++i)
+            {
+                const FecalSymbol& symbol = recovered.Symbols[i];
+                if (symbol.Bytes != symbol_bytes ||
+                    memcmp(symbol.Data, inputData[symbol.Index], symbol_bytes) != 0)
+                {
+                    cerr << "Error: Recovered data mismatch for original " << symbol.Index << endl;
+                    fecal_free(decoder);
+                    fecal_free(encoder);
+                    return false;
+                }
+            }
+
+            if (recoveryIndex + 1 > loss_count)
+            {
+                ++result.ExtraTrials;
+                result.ExtraSymbols += recoveryIndex + 1 - loss_count;
+            }
+            success = true;
+            break;
+        }
+
+        FecalDecoderStats stats;
+        const int statsResult = fecal_decoder_get_stats(decoder, &stats);
+
+        fecal_free(decoder);
+        fecal_free(encoder);
+
+        if (!success)
+        {
+            cerr << "Error: Decode did not succeed with " << maxRecovery << " recovery symbols" << endl;
+            return false;
+        }
+        if (statsResult != Fecal_Success)
+        {
+            cerr << "Error: The sweep needs a library built with FECAL_ENABLE_STATS" << endl;
+            return false;
+        }
+
+        result.Phases[Phase_GenerateMatrix].Nsec.push_back(stats.GenerateMatrixNsec);
+        result.Phases[Phase_GaussianElimination].Nsec.push_back(stats.GaussianEliminationNsec);
+        result.Phases[Phase_ScheduleElimination].Nsec.push_back(stats.ScheduleNsec);
+        result.Phases[Phase_EliminateOriginalData].Nsec.push_back(stats.EliminateNsec);
+        result.Phases[Phase_BackSubstitution].Nsec.push_back(stats.SolveNsec);
+        result.Phases[Phase_Decode].Nsec.push_back(decodeNsec);
+    }
+
+    return true;
+}
+
+static const char* LossPatternName(SweepLossPattern pattern)
+{
+    return pattern == Loss_Random ? "random" : "burst";
+}
+
+static void PrintSweepResults(std::vector<SweepResult>& results, SweepFormat format)
+{
+    if (format == Format_CSV)
+    {
+        printf("input_count,symbol_bytes,loss_count,loss_pattern,threads,trials,extra_trials,extra_symbols,phase,samples,p50_us,p99_us,mean_us\n");
+        for (SweepResult& result : results)
+        {
+            for (unsigned phase = 0; phase < Phase_Count; ++phase)
+            {
+                PhaseSamples& samples = result.Phases[phase];
+                printf("%u,%u,%u,%s,%u,%u,%u,%u,%s,%u,%.3f,%.3f,%.3f\n",
+                    result.InputCount, result.SymbolBytes, result.LossCount,
+                    LossPatternName(result.LossPattern), result.ThreadCount,
+                    result.Trials, result.ExtraTrials, result.ExtraSymbols,
+                    kSweepPhaseNames[phase], (unsigned)samples.Nsec.size(),
+                    samples.PercentileUsec(50.), samples.PercentileUsec(99.),
+                    samples.MeanUsec());
+            }
+        }
+        return;
+    }
+
+    printf("{\n  \"results\": [");
+    for (size_t i = 0; i < results.size(); ++i)
+    {
+        SweepResult& result = results[i];
+        printf("%s\n    {\n", i > 0 ? "," : "");
+        printf("      \"input_count\": %u,\n", result.InputCount);
+        printf("      \"symbol_bytes\": %u,\n", result.SymbolBytes);
+        printf("      \"loss_count\": %u,\n", result.LossCount);
+        printf("      \"loss_pattern\": \"%s\",\n", LossPatternName(result.LossPattern));
+        printf("      \"threads\": %u,\n", result.ThreadCount);
+        printf("      \"trials\": %u,\n", result.Trials);
+        printf("      \"extra_trials\": %u,\n", result.ExtraTrials);
+        printf("      \"extra_symbols\": %u,\n", result.ExtraSymbols);
+        printf("      \"phases\": {");
+        for (unsigned phase = 0; phase < Phase_Count; ++phase)
+        {
+            PhaseSamples& samples = result.Phases[phase];
+            printf("%s\n        \"%s\": { \"samples\": %u, \"p50_us\": %.3f, \"p99_us\": %.3f, \"mean_us\": %.3f }",
+                phase > 0 ? "," : "", kSweepPhaseNames[phase], (unsigned)samples.Nsec.size(),
+                samples.PercentileUsec(50.), samples.PercentileUsec(99.), samples.MeanUsec());
+        }
+        printf("\n      }\n    }");
+    }
+    printf("\n  ]\n}\n");
+}
+
+static int RunSweep(const SweepParameters& params)
+{
+    std::vector<SweepResult> results;
+
+    for (unsigned input_count : params.InputCounts)
+    {
+        for (unsigned symbol_bytes : params.SymbolBytes)
+        {
+            // Generate original data once for all points with these sizes
+            fecal::PCGRandom prng;
+            prng.Seed(input_count, symbol_bytes);
+
+            std::vector<uint8_t> originalData((size_t)input_count * symbol_bytes);
+            std::vector<void*> inputData(input_count);
+            for (unsigned i = 0; i < input_count; ++i)
+            {
+                inputData[i] = &originalData[(size_t)i * symbol_bytes];
+                WriteRandomSelfCheckingPacket(prng, inputData[i], symbol_bytes);
+            }
+
+            for (unsigned threads : params.ThreadCounts)
+            {
+                BenchmarkThreadPool pool(threads);
+
+                for (unsigned loss_count : params.LossCounts)
+                {
+                    if (loss_count > input_count)
+                        continue;
+
+                    for (SweepLossPattern pattern : params.LossPatterns)
+                    {
+                        SweepResult result;
+                        result.InputCount = input_count;
+                        result.SymbolBytes = symbol_bytes;
+                        result.LossCount = loss_count;
+                        result.LossPattern = pattern;
+                        result.ThreadCount = threads;
+                        result.Trials = params.Trials;
+
+                        cerr << "Sweep: input_count=" << input_count << " symbol_bytes=" << symbol_bytes
+                            << " losses=" << loss_count << " (" << LossPatternName(pattern)
+                            << ") threads=" << threads << endl;
+
+                        if (!RunSweepPoint(result, inputData, pool))
+                            return -1;
+
+                        results.push_back(std::move(result));
+                    }
+                }
+            }
+        }
+    }
+
+    PrintSweepResults(results, params.Format);
+    return 0;
+}
+
+// Parse a comma-separated list of positive integers
+static bool ParseUnsignedList(const char* text, std::vector<unsigned>& values)
+{
+    values.clear();
+    while (*text)
+    {
+        char* end = nullptr;
+        const unsigned long value = strtoul(text, &end, 10);
+        if (end == text || value == 0 || value > 0xffffffffUL)
+            return false;
+        values.push_back((unsigned)value);
+        text = end;
+        if (*text == ',')
+            ++text;
+        else if (*text)
+            return false;
+    }
+    return !values.empty();
+}
+
+static bool ParseSweepArguments(int argc, char** argv, SweepParameters& params)
+{
+    for (int i = 2; i < argc; ++i)
+    {
+        const std::string option = argv[i];
+        if (i + 1 >= argc)
+            return false;
+        const char* value = argv[++i];
+
+        if (option == "--format")
+        {
+            if (0 == strcmp(value, "json"))
+                params.Format = Format_JSON;
+            else if (0 == strcmp(value, "csv"))
+                params.Format = Format_CSV;
+            else
+                return false;
+        }
+        else if (option == "--trials")
+        {
+            std::vector<unsigned> trials;
+            if (!ParseUnsignedList(value, trials) || trials.size() != 1)
+                return false;
+            params.Trials = trials[0];
+        }
+        else if (option == "--inputs")
+        {
+            if (!ParseUnsignedList(value, params.InputCounts))
+                return false;
+        }
+        else if (option == "--bytes")
+        {
+            if (!ParseUnsignedList(value, params.SymbolBytes))
+                return false;
+        }
+        else if (option == "--losses")
+        {
+            if (!ParseUnsignedList(value, params.LossCounts))
+                return false;
+        }
+        else if (option == "--threads")
+        {
+            if (!ParseUnsignedList(value, params.ThreadCounts))
+                return false;
+        }
+        else if (option == "--patterns")
+        {
+            params.LossPatterns.clear();
+            const std::string patterns = value;
+            size_t start = 0;
+            while (start <= patterns.size())
+            {
+                size_t end = patterns.find(',', start);
+                if (end == std::string::npos)
+                    end = patterns.size();
+                const std::string name = patterns.substr(start, end - start);
+                if (name == "random")
+                    params.LossPatterns.push_back(Loss_Random);
+                else if (name == "burst")
+                    params.LossPatterns.push_back(Loss_Burst);
+                else
+                    return false;
+                start = end + 1;
+            }
+        }
+        else
+            return false;
+    }
+    return true;
+}
+
+
 //------------------------------------------------------------------------------
 // Entrypoint
 
@@ -540,6 +1196,25 @@ int main(int argc, char **argv)
 {
     SetCurrentThreadPriority();
 
+    // Parameter sweep with machine-readable output:
+    // benchmark --sweep [--format json|csv] [--trials N] [--inputs a,b,..]
+    //     [--bytes a,b,..] [--losses a,b,..] [--patterns random,burst] [--threads a,b,..]
+    if (argc >= 2 && 0 == strcmp(argv[1], "--sweep"))
+    {
+        SweepParameters params;
+        if (!ParseSweepArguments(argc, argv, params))
+        {
+            cerr << "Usage: " << argv[0] << " --sweep [--format json|csv] [--trials N] [--inputs a,b,..] [--bytes a,b,..] [--losses a,b,..] [--patterns random,burst] [--threads a,b,..]" << endl;
+            return -1;
+        }
+        if (0 != fecal_init())
+        {
+            cerr << "Failed to initialize" << endl;
+            return -1;
+        }
+        return RunSweep(params);
+    }
+
     FunctionTimer t_fecal_init("fecal_init");
 
     t_fecal_init.BeginCall();